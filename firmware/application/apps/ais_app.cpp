@@ -191,8 +191,9 @@ void AISLogger::on_packet(const ais::Packet& packet) {
     log_file.write_entry(packet.received_at(), entry);
 }
 
-void AISRecentEntry::update(const ais::Packet& packet) {
+void AISRecentEntry::update(const ais::Packet& packet, const ais::Channel channel) {
     received_count++;
+    last_channel = channel;
 
     switch (packet.message_id()) {
         case 1:
@@ -356,7 +357,7 @@ void AISRecentEntryDetailView::paint(Painter& painter) {
     field_rect = draw_field(painter, field_rect, s, "SoG ", ais::format::speed_over_ground(entry_.last_position.speed_over_ground));
     field_rect = draw_field(painter, field_rect, s, "CoG ", ais::format::course_over_ground(entry_.last_position.course_over_ground));
     field_rect = draw_field(painter, field_rect, s, "Head", ais::format::true_heading(entry_.last_position.true_heading));
-    field_rect = draw_field(painter, field_rect, s, "Rx #", to_string_dec_uint(entry_.received_count));
+    field_rect = draw_field(painter, field_rect, s, "Rx #", to_string_dec_uint(entry_.received_count) + ((entry_.last_channel == ais::Channel::A) ? " (last on A)" : " (last on B)"));
 }
 
 void AISRecentEntryDetailView::set_entry(const AISRecentEntry& entry) {
@@ -370,7 +371,6 @@ AISAppView::AISAppView(NavigationView& nav)
 
     add_children({
         &label_channel,
-        &options_channel,
         &field_rf_amp,
         &field_lna,
         &field_vga,
@@ -382,16 +382,9 @@ AISAppView::AISAppView(NavigationView& nav)
 
     recent_entry_detail_view.hidden(true);
 
-    if (!settings_.loaded())
-        receiver_model.set_target_frequency(initial_target_frequency);
-
+    receiver_model.set_target_frequency(target_frequency);
     receiver_model.enable();
 
-    options_channel.on_change = [this](size_t, OptionsField::value_t v) {
-        receiver_model.set_target_frequency(v);
-    };
-    options_channel.set_by_value(receiver_model.target_frequency());
-
     recent_entries_view.on_select = [this](const AISRecentEntry& entry) {
         on_show_detail(entry);
     };
@@ -411,7 +404,7 @@ AISAppView::~AISAppView() {
 }
 
 void AISAppView::focus() {
-    options_channel.focus();
+    field_rf_amp.focus();
 }
 
 void AISAppView::set_parent_rect(const Rect new_parent_rect) {
@@ -421,13 +414,13 @@ void AISAppView::set_parent_rect(const Rect new_parent_rect) {
     recent_entry_detail_view.set_parent_rect(content_rect);
 }
 
-void AISAppView::on_packet(const ais::Packet& packet) {
+void AISAppView::on_packet(const ais::Packet& packet, const ais::Channel channel) {
     if (logger) {
         logger->on_packet(packet);
     }
 
     auto& entry = ::on_packet(recent, packet.source_id());
-    entry.update(packet);
+    entry.update(packet, channel);
     recent_entries_view.set_dirty();
 
     // TODO: Crude hack, should be a more formal listener arrangement...
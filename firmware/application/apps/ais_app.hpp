@@ -66,6 +66,7 @@ struct AISRecentEntry {
     static constexpr Key invalid_key = 0xffffffff;
 
     ais::MMSI mmsi;
+    ais::Channel last_channel;
     std::string name;
     std::string call_sign;
     std::string destination;
@@ -80,6 +81,7 @@ struct AISRecentEntry {
     AISRecentEntry(
         const ais::MMSI& mmsi)
         : mmsi{mmsi},
+          last_channel{ais::Channel::A},
           name{},
           call_sign{},
           destination{},
@@ -92,10 +94,10 @@ struct AISRecentEntry {
         return mmsi;
     }
 
-    void update(const ais::Packet& packet);
+    void update(const ais::Packet& packet, const ais::Channel channel);
 };
 
-using AISRecentEntries = RecentEntries<AISRecentEntry>;
+using AISRecentEntries = RecentEntries<AISRecentEntry, 64>;
 
 class AISLogger {
    public:
@@ -162,7 +164,8 @@ class AISAppView : public View {
     std::string title() const override { return "AIS RX"; };
 
    private:
-    static constexpr uint32_t initial_target_frequency = 162025000;
+    /* Halfway between channels A (87B) and B (88B), both are decoded. */
+    static constexpr uint32_t target_frequency = 162000000;
 
     RxRadioState radio_state_{
         1750000 /* bandwidth */,
@@ -186,16 +189,8 @@ class AISAppView : public View {
     static constexpr auto header_height = 1 * 16;
 
     Text label_channel{
-        {0 * 8, 0 * 16, 2 * 8, 1 * 16},
-        "Ch"};
-
-    OptionsField options_channel{
-        {3 * 8, 0 * 16},
-        3,
-        {
-            {"87B", 161975000},
-            {"88B", 162025000},
-        }};
+        {0 * 8, 0 * 16, 6 * 8, 1 * 16},
+        "Ch A+B"};
 
     RFAmpField field_rf_amp{
         {13 * 8, 0 * 16}};
@@ -220,11 +215,11 @@ class AISAppView : public View {
             const auto message = static_cast<const AISPacketMessage*>(p);
             const ais::Packet packet{message->packet};
             if (packet.is_valid()) {
-                this->on_packet(packet);
+                this->on_packet(packet, message->channel);
             }
         }};
 
-    void on_packet(const ais::Packet& packet);
+    void on_packet(const ais::Packet& packet, const ais::Channel channel);
     void on_show_list();
     void on_show_detail(const AISRecentEntry& entry);
 };
@@ -43,6 +43,7 @@ CaptureAppView::CaptureAppView(NavigationView& nav)
         &field_lna,
         &field_vga,
         &option_bandwidth,
+        &option_format,
         &record_view,
         &waterfall,
     });
@@ -105,6 +106,10 @@ CaptureAppView::CaptureAppView(NavigationView& nav)
 
     option_bandwidth.set_selected_index(7);  // Preselected default option 500kHz.
 
+    option_format.on_change = [this](size_t, OptionsField::value_t v) {
+        record_view.set_file_type(static_cast<RecordView::FileType>(v));
+    };
+
     receiver_model.set_modulation(ReceiverModel::Mode::Capture);
     receiver_model.enable();
 
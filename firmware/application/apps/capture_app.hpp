@@ -60,6 +60,7 @@ class CaptureAppView : public View {
 
     Labels labels{
         {{0 * 8, 1 * 16}, "Rate:", Color::light_grey()},
+        {{11 * 8, 1 * 16}, "Fmt:", Color::light_grey()},
     };
 
     RSSI rssi{
@@ -89,6 +90,16 @@ class CaptureAppView : public View {
         5,
         {}};
 
+    OptionsField option_format{
+        {15 * 8, 1 * 16},
+        4,
+        {
+            {"C16", RecordView::FileType::RawS16},
+            {"C16Z", RecordView::FileType::CompressedS16},
+            {"C12", RecordView::FileType::PackedS12},
+            {"C8", RecordView::FileType::RawS8},
+        }};
+
     RecordView record_view{
         {0 * 8, 2 * 16, 30 * 8, 1 * 16},
         u"BBD_????.*",
@@ -63,6 +63,10 @@ struct ERTKey {
     }
 };
 
+inline uint32_t recent_entry_hash(const ERTKey& key) {
+    return recent_entry_hash(key.id) ^ recent_entry_hash(key.commodity_type);
+}
+
 struct ERTRecentEntry {
     using Key = ERTKey;
 
@@ -101,7 +105,7 @@ class ERTLogger {
     LogFile log_file{};
 };
 
-using ERTRecentEntries = RecentEntries<ERTRecentEntry>;
+using ERTRecentEntries = RecentEntries<ERTRecentEntry, 64>;
 
 namespace ui {
 
@@ -38,10 +38,6 @@ namespace fs = std::filesystem;
 
 namespace ui {
 
-void GpsSimAppView::set_ready() {
-    ready_signal = true;
-}
-
 void GpsSimAppView::on_file_changed(const fs::path& new_file_path) {
     file_path = fs::path(u"/") + new_file_path;
     File::Size file_size{};
@@ -122,7 +118,6 @@ void GpsSimAppView::start() {
         replay_thread = std::make_unique<ReplayThread>(
             std::move(reader),
             read_size, buffer_count,
-            &ready_signal,
             [](uint32_t return_code) {
                 ReplayThreadDoneMessage message{return_code};
                 EventDispatcher::send_message(message);
@@ -144,7 +139,6 @@ void GpsSimAppView::stop(const bool do_loop) {
         button_play.set_bitmap(&bitmap_play);
     }
 
-    ready_signal = false;
 }
 
 void GpsSimAppView::handle_replay_thread_done(const uint32_t return_code) {
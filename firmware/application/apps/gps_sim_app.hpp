@@ -78,13 +78,11 @@ class GpsSimAppView : public View {
     void start();
     void stop(const bool do_loop);
     bool is_active() const;
-    void set_ready();
     void handle_replay_thread_done(const uint32_t return_code);
     void file_error();
 
     std::filesystem::path file_path{};
     std::unique_ptr<ReplayThread> replay_thread{};
-    bool ready_signal{false};
 
     Button button_open{
         {0 * 8, 0 * 16, 10 * 8, 2 * 16},
@@ -133,15 +131,6 @@ class GpsSimAppView : public View {
             this->handle_replay_thread_done(message.return_code);
         }};
 
-    MessageHandlerRegistration message_handler_fifo_signal{
-        Message::ID::RequestSignal,
-        [this](const Message* const p) {
-            const auto message = static_cast<const RequestSignalMessage*>(p);
-            if (message->signal == RequestSignalMessage::Signal::FillRequest) {
-                this->set_ready();
-            }
-        }};
-
     MessageHandlerRegistration message_handler_tx_progress{
         Message::ID::TXProgress,
         [this](const Message* const p) {
@@ -25,6 +25,7 @@
 #include "string_format.hpp"
 
 #include "ui_fileman.hpp"
+#include "io_capture.hpp"
 #include "io_file.hpp"
 #include "baseband_api.hpp"
 #include "metadata_file.hpp"
@@ -37,23 +38,18 @@ namespace fs = std::filesystem;
 
 namespace ui {
 
-void ReplayAppView::set_ready() {
-    ready_signal = true;
-}
-
 void ReplayAppView::on_file_changed(const fs::path& new_file_path) {
     file_path = fs::path(u"/") + new_file_path;
     File::Size file_size{};
 
-    {  // Get the size of the data file.
-        File data_file;
-        auto error = data_file.open(file_path);
-        if (error) {
+    {  // Get the size of the data, progress and duration go by C16 samples.
+        const auto size_result = capture_data_size(file_path, get_capture_format(file_path));
+        if (size_result.is_error()) {
             file_error();
             return;
         }
 
-        file_size = data_file.size();
+        file_size = size_result.value();
     }
 
     // Get original record frequency if available.
@@ -81,8 +77,12 @@ void ReplayAppView::on_file_changed(const fs::path& new_file_path) {
     button_play.focus();
 }
 
-void ReplayAppView::on_tx_progress(const uint32_t progress) {
+void ReplayAppView::on_tx_progress(const uint32_t progress, const uint32_t underruns) {
     progressbar.set_value(progress);
+
+    // The SD card fell behind, the gaps went out as silence.
+    if (underruns)
+        text_duration.set("U" + to_string_dec_uint(underruns));
 }
 
 void ReplayAppView::focus() {
@@ -110,30 +110,27 @@ void ReplayAppView::start() {
 
     std::unique_ptr<stream::Reader> reader;
 
-    auto p = std::make_unique<FileReader>();
-    auto open_error = p->open(file_path);
+    auto open_error = open_capture_reader(file_path, get_capture_format(file_path), reader);
     if (open_error.is_valid()) {
         file_error();
         return;  // Fixes TX bug if there's a file error
-    } else {
-        reader = std::move(p);
     }
 
+    const auto baseband_rate = baseband::set_replay_sample_rate(sample_rate);
+
     if (reader) {
         button_play.set_bitmap(&bitmap_stop);
-        baseband::set_sample_rate(sample_rate * 8);
 
         replay_thread = std::make_unique<ReplayThread>(
             std::move(reader),
             read_size, buffer_count,
-            &ready_signal,
             [](uint32_t return_code) {
                 ReplayThreadDoneMessage message{return_code};
                 EventDispatcher::send_message(message);
             });
     }
 
-    transmitter_model.set_sampling_rate(sample_rate * 8);
+    transmitter_model.set_sampling_rate(baseband_rate);
     transmitter_model.set_baseband_bandwidth(baseband_bandwidth);
     transmitter_model.enable();
 
@@ -153,8 +150,6 @@ void ReplayAppView::stop(const bool do_loop) {
         transmitter_model.disable();
         button_play.set_bitmap(&bitmap_play);
     }
-
-    ready_signal = false;
 }
 
 void ReplayAppView::handle_replay_thread_done(const uint32_t return_code) {
@@ -191,7 +186,7 @@ ReplayAppView::ReplayAppView(
     };
 
     button_open.on_select = [this, &nav](Button&) {
-        auto open_view = nav.push<FileLoadView>(".C16");
+        auto open_view = nav.push<FileLoadView>(".C16*|.C8|.C12");
         open_view->on_changed = [this](fs::path new_file_path) {
             on_file_changed(new_file_path);
         };
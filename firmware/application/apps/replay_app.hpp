@@ -68,19 +68,17 @@ class ReplayAppView : public View {
     const size_t buffer_count{3};
 
     void on_file_changed(const std::filesystem::path& new_file_path);
-    void on_tx_progress(const uint32_t progress);
+    void on_tx_progress(const uint32_t progress, const uint32_t underruns);
 
     void toggle();
     void start();
     void stop(const bool do_loop);
     bool is_active() const;
-    void set_ready();
     void handle_replay_thread_done(const uint32_t return_code);
     void file_error();
 
     std::filesystem::path file_path{};
     std::unique_ptr<ReplayThread> replay_thread{};
-    bool ready_signal{false};
 
     Button button_open{
         {0 * 8, 0 * 16, 10 * 8, 2 * 16},
@@ -130,20 +128,11 @@ class ReplayAppView : public View {
             this->handle_replay_thread_done(message.return_code);
         }};
 
-    MessageHandlerRegistration message_handler_fifo_signal{
-        Message::ID::RequestSignal,
-        [this](const Message* const p) {
-            const auto message = static_cast<const RequestSignalMessage*>(p);
-            if (message->signal == RequestSignalMessage::Signal::FillRequest) {
-                this->set_ready();
-            }
-        }};
-
     MessageHandlerRegistration message_handler_tx_progress{
         Message::ID::TXProgress,
         [this](const Message* const p) {
             const auto message = *reinterpret_cast<const TXProgressMessage*>(p);
-            this->on_tx_progress(message.progress);
+            this->on_tx_progress(message.progress, message.underruns);
         }};
 };
 
@@ -43,7 +43,6 @@ void SoundBoardView::stop() {
     tx_view.set_transmitting(false);
 
     // button_play.set_bitmap(&bitmap_play);
-    ready_signal = false;
 }
 
 void SoundBoardView::handle_replay_thread_done(const uint32_t return_code) {
@@ -64,10 +63,6 @@ void SoundBoardView::handle_replay_thread_done(const uint32_t return_code) {
     }
 }
 
-void SoundBoardView::set_ready() {
-    ready_signal = true;
-}
-
 void SoundBoardView::focus() {
     menu_view.focus();
 }
@@ -99,7 +94,6 @@ void SoundBoardView::start_tx(const uint32_t id) {
     replay_thread = std::make_unique<ReplayThread>(
         std::move(reader),
         read_size, buffer_count,
-        &ready_signal,
         [](uint32_t return_code) {
             ReplayThreadDoneMessage message{return_code};
             EventDispatcher::send_message(message);
@@ -75,7 +75,6 @@ class SoundBoardView : public View {
     const size_t read_size{2048};  // Less ?
     const size_t buffer_count{3};
     std::unique_ptr<ReplayThread> replay_thread{};
-    bool ready_signal{false};
     lfsr_word_t lfsr_v = 1;
 
     // void show_infos();
@@ -83,7 +82,6 @@ class SoundBoardView : public View {
     // void on_ctcss_changed(uint32_t v);
     void stop();
     bool is_active() const;
-    void set_ready();
     void handle_replay_thread_done(const uint32_t return_code);
     void file_error();
     void on_tx_progress(const uint32_t progress);
@@ -152,15 +150,6 @@ class SoundBoardView : public View {
             this->handle_replay_thread_done(message.return_code);
         }};
 
-    MessageHandlerRegistration message_handler_fifo_signal{
-        Message::ID::RequestSignal,
-        [this](const Message* const p) {
-            const auto message = static_cast<const RequestSignalMessage*>(p);
-            if (message->signal == RequestSignalMessage::Signal::FillRequest) {
-                this->set_ready();
-            }
-        }};
-
     MessageHandlerRegistration message_handler_tx_progress{
         Message::ID::TXProgress,
         [this](const Message* const p) {
@@ -37,9 +37,13 @@
 
 #include "tpms_packet.hpp"
 
-namespace std {
+namespace tpms {
 
-} /* namespace std */
+inline uint32_t recent_entry_hash(const TransponderID id) {
+    return ::recent_entry_hash(id.value());
+}
+
+} /* namespace tpms */
 
 struct TPMSRecentEntry {
     using Key = std::pair<tpms::Reading::Type, tpms::TransponderID>;
@@ -68,7 +72,7 @@ struct TPMSRecentEntry {
     void update(const tpms::Reading& reading);
 };
 
-using TPMSRecentEntries = RecentEntries<TPMSRecentEntry>;
+using TPMSRecentEntries = RecentEntries<TPMSRecentEntry, 64>;
 
 class TPMSLogger {
    public:
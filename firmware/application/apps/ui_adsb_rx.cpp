@@ -75,6 +75,14 @@ void RecentEntriesTable<AircraftRecentEntries>::draw(
         painter.draw_bitmap(target_rect.location() + Point(8 * 8, 0), bitmap_target, target_color, style.background);
 }
 
+// Four octal digits, as packed by decode_frame_squawk()
+static std::string squawk_string(const uint16_t squawk) {
+    return to_string_dec_uint((squawk >> 9) & 7) +
+           to_string_dec_uint((squawk >> 6) & 7) +
+           to_string_dec_uint((squawk >> 3) & 7) +
+           to_string_dec_uint(squawk & 7);
+}
+
 void ADSBLogger::log_str(std::string& logline) {
     log_file.write_entry(logline);
 }
@@ -204,6 +212,11 @@ void ADSBRxDetailsView::update(const AircraftRecentEntry& entry) {
         text_last_seen.set(to_string_dec_uint(age / 60) + " minutes ago");
 
     text_infos.set(entry_copy.info_string);
+    if (entry_copy.squawk != AircraftRecentEntry::squawk_none) {
+        text_squawk.set(squawk_string(entry_copy.squawk));
+    } else {
+        text_squawk.set("-");
+    }
     if (entry_copy.velo.heading < 360 && entry_copy.velo.speed >= 0) {  // I don't like this but...
         text_info2.set("Hdg:" + to_string_dec_uint(entry_copy.velo.heading) + " Spd:" + to_string_dec_int(entry_copy.velo.speed));
     } else {
@@ -232,6 +245,7 @@ ADSBRxDetailsView::ADSBRxDetailsView(
                   &text_icao_address,
                   &text_callsign,
                   &text_last_seen,
+                  &text_squawk,
                   &text_airline,
                   &text_country,
                   &text_infos,
@@ -305,12 +319,10 @@ AircraftRecentEntry ADSBRxView::find_or_create_entry(uint32_t ICAO_address) {
 }
 
 void ADSBRxView::replace_entry(AircraftRecentEntry& entry) {
-    uint32_t ICAO_address = entry.ICAO_address;
-
-    std::replace_if(
-        recent.begin(), recent.end(),
-        [ICAO_address](const AircraftRecentEntry& compEntry) { return ICAO_address == compEntry.ICAO_address; },
-        entry);
+    auto it = find(recent, entry.ICAO_address);
+    if (it != std::end(recent)) {
+        *it = entry;
+    }
 }
 
 void ADSBRxView::remove_old_entries() {
@@ -333,18 +345,26 @@ void ADSBRxView::sort_entries_by_state() {
 
 void ADSBRxView::on_frame(const ADSBFrameMessage* message) {
     logger = std::make_unique<ADSBLogger>();
-    rtc::RTC datetime;
     std::string callsign;
     std::string str_info;
     std::string logentry;
 
     auto frame = message->frame;
-    uint32_t ICAO_address = frame.get_ICAO_address();
+    const uint8_t df = frame.get_DF();
+    uint32_t ICAO_address = checked_ICAO_address(frame);
+
+    if (ICAO_address) {
+        icao_addresses.insert(ICAO_address, seconds_running);
+    } else if (has_address_parity(df)) {
+        // Only trusted if the address is one we have recently heard
+        ICAO_address = frame.syndrome();
+        if (!icao_addresses.contains(ICAO_address, seconds_running))
+            ICAO_address = 0;
+    }
 
-    if (frame.check_CRC() && ICAO_address) {
-        rtcGetTime(&RTCD1, &datetime);
+    if (ICAO_address) {
         auto entry = find_or_create_entry(ICAO_address);
-        frame.set_rx_timestamp(datetime.minute() * 60 + datetime.second());
+        frame.set_rx_timestamp(seconds_running);
         entry.reset_age();
         if (entry.hits == 0) {
             entry.amp = message->amp;  // Store amplitude on first hit
@@ -354,14 +374,13 @@ void ADSBRxView::on_frame(const ADSBFrameMessage* message) {
 
         entry.inc_hit();
         if (logger) {
-            logentry += to_string_hex_array(frame.get_raw_data(), 14) + " ";
+            logentry += to_string_hex_array(frame.get_raw_data(), frame.length_bits() / 8) + " ";
             logentry += "ICAO:" + entry.icaoStr + " ";
         }
 
         if (frame.get_DF() == DF_ADSB) {
             uint8_t msg_type = frame.get_msg_type();
             uint8_t msg_sub = frame.get_msg_sub();
-            uint8_t* raw_data = frame.get_raw_data();
 
             // 4: // surveillance, altitude reply
             if ((msg_type >= AIRCRAFT_ID_L) && (msg_type <= AIRCRAFT_ID_H)) {
@@ -377,7 +396,7 @@ void ADSBRxView::on_frame(const ADSBFrameMessage* message) {
             // 20: // Comm-B, altitude reply
             else if (((msg_type >= AIRBORNE_POS_BARO_L) && (msg_type <= AIRBORNE_POS_BARO_H)) ||
                      ((msg_type >= AIRBORNE_POS_GPS_L) && (msg_type <= AIRBORNE_POS_GPS_H))) {
-                entry.set_frame_pos(frame, raw_data[6] & 4);
+                entry.set_frame_pos(frame, seconds_running);
 
                 if (entry.pos.valid) {
                     str_info = "Alt:" + to_string_dec_int(entry.pos.altitude) +
@@ -406,8 +425,21 @@ void ADSBRxView::on_frame(const ADSBFrameMessage* message) {
                                 " Spd: " + to_string_dec_int(entry.velo.speed);
                 }
             }
-            replace_entry(entry);
-        }  // frame.get_DF() == DF_ADSB
+        } else if ((df == DF_SHORT_AIR_AIR) || (df == DF_SURV_ALT) || (df == DF_LONG_AIR_AIR) || (df == DF_COMMB_ALT)) {
+            int32_t altitude;
+            if (decode_frame_altitude(frame, altitude)) {
+                entry.pos.altitude = altitude;
+                if (logger) {
+                    logentry += "Alt:" + to_string_dec_int(altitude) + " ";
+                }
+            }
+        } else if ((df == DF_SURV_ID) || (df == DF_EHS_SQUAWK)) {
+            entry.squawk = decode_frame_squawk(frame);
+            if (logger) {
+                logentry += "Sqk:" + squawk_string(entry.squawk) + " ";
+            }
+        }
+        replace_entry(entry);
 
         if (logger) {
             logger->append(LOG_ROOT_DIR "/ADSB.TXT");
@@ -419,6 +451,8 @@ void ADSBRxView::on_frame(const ADSBFrameMessage* message) {
 }
 
 void ADSBRxView::on_tick_second() {
+    seconds_running++;
+
     if (recent.size() <= 16) {  // Not many entries update everything (16 is one screen full)
         updateDetailsAndMap(1);
         updateRecentEntries();
@@ -66,12 +66,11 @@ namespace ui {
 #define VEL_AIR_SUBSONIC 3
 #define VEL_AIR_SUPERSONIC 4
 
-#define O_E_FRAME_TIMEOUT 20  // timeout between odd and even frames
-
 struct AircraftRecentEntry {
     using Key = uint32_t;
 
     static constexpr Key invalid_key = 0xffffffff;
+    static constexpr uint16_t squawk_none = 0xffff;
 
     uint32_t ICAO_address{};
     uint16_t hits{0};
@@ -79,10 +78,12 @@ struct AircraftRecentEntry {
     uint16_t age_state{1};
     uint32_t age{0};
     uint32_t amp{0};
+    uint16_t squawk{squawk_none};
     adsb_pos pos{false, 0, 0, 0};
     adsb_vel velo{false, 0, 999, 0};
     ADSBFrame frame_pos_even{};
     ADSBFrame frame_pos_odd{};
+    CPRTracker cpr{};
 
     std::string icaoStr{"      "};
     std::string callsign{"        "};
@@ -106,15 +107,21 @@ struct AircraftRecentEntry {
         hits++;
     }
 
-    void set_frame_pos(ADSBFrame& frame, uint32_t parity) {
-        if (!parity)
+    void set_frame_pos(ADSBFrame& frame, uint32_t now) {
+        const CPRPosition position = decode_frame_cpr(frame);
+        if (!position.odd)
             frame_pos_even = frame;
         else
             frame_pos_odd = frame;
 
-        if (!frame_pos_even.empty() && !frame_pos_odd.empty()) {
-            if (abs(frame_pos_even.get_rx_timestamp() - frame_pos_odd.get_rx_timestamp()) < O_E_FRAME_TIMEOUT)
-                pos = decode_frame_pos(frame_pos_even, frame_pos_odd);
+        int32_t altitude;
+        if (decode_frame_altitude(frame, altitude))
+            pos.altitude = altitude;
+
+        if (cpr.update(position, now)) {
+            pos.latitude = cpr.latitude();
+            pos.longitude = cpr.longitude();
+            pos.valid = true;
         }
     }
 
@@ -144,7 +151,7 @@ struct AircraftRecentEntry {
     }
 };
 
-using AircraftRecentEntries = RecentEntries<AircraftRecentEntry>;
+using AircraftRecentEntries = RecentEntries<AircraftRecentEntry, 64>;
 
 class ADSBLogger {
    public:
@@ -273,6 +280,7 @@ class ADSBRxDetailsView : public View {
         {{13 * 8, 1 * 16}, "Callsign:", Color::light_grey()},
         {{0 * 8, 2 * 16}, "Last seen:", Color::light_grey()},
         {{0 * 8, 3 * 16}, "Airline:", Color::light_grey()},
+        {{19 * 8, 3 * 16}, "Squawk:", Color::light_grey()},
         {{0 * 8, 5 * 16}, "Country:", Color::light_grey()},
         {{0 * 8, 13 * 16}, "Even position frame:", Color::light_grey()},
         {{0 * 8, 15 * 16}, "Odd position frame:", Color::light_grey()}};
@@ -289,6 +297,10 @@ class ADSBRxDetailsView : public View {
         {11 * 8, 2 * 16, 19 * 8, 16},
         "-"};
 
+    Text text_squawk{
+        {26 * 8, 3 * 16, 4 * 8, 16},
+        "-"};
+
     Text text_airline{
         {0 * 8, 4 * 16, 30 * 8, 16},
         "-"};
@@ -365,7 +377,9 @@ class ADSBRxView : public View {
                                         {"Hit", 3},
                                         {"Age", 4}}};
     AircraftRecentEntries recent{};
-    RecentEntriesView<RecentEntries<AircraftRecentEntry>> recent_entries_view{columns, recent};
+    ICAOAddressSet icao_addresses{};
+    uint32_t seconds_running{0};
+    RecentEntriesView<AircraftRecentEntries> recent_entries_view{columns, recent};
 
     SignalToken signal_token_tick_second{};
     ADSBRxDetailsView* details_view{nullptr};
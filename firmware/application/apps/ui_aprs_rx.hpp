@@ -144,7 +144,7 @@ class APRSDetailsView : public View {
         "Map"};
 };
 
-using APRSRecentEntries = RecentEntries<APRSRecentEntry>;
+using APRSRecentEntries = RecentEntries<APRSRecentEntry, 64>;
 
 class APRSTableView : public View {
    public:
@@ -165,7 +165,7 @@ class APRSTableView : public View {
                                         {"Hits", 4},
                                         {"Time", 8}}};
     APRSRecentEntries recent{};
-    RecentEntriesView<RecentEntries<APRSRecentEntry>> recent_entries_view{columns, recent};
+    RecentEntriesView<APRSRecentEntries> recent_entries_view{columns, recent};
     APRSDetailsView details_view{nav_};
     uint32_t detailed_entry_key{0};
     bool send_updates{false};
@@ -0,0 +1,92 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "ui_channelizer.hpp"
+#include "baseband_api.hpp"
+
+#include "portapack.hpp"
+using namespace portapack;
+
+#include "string_format.hpp"
+
+#include <algorithm>
+
+namespace ui {
+
+ChannelizerView::ChannelizerView(NavigationView& nav)
+    : nav_{nav} {
+    baseband::run_image(portapack::spi_flash::image_tag_channelizer);
+
+    add_children({&labels,
+                  &field_frequency,
+                  &field_rf_amp,
+                  &field_lna,
+                  &field_vga,
+                  &rssi});
+    for (size_t n = 0; n < channel_count; n++) {
+        add_child(&text_channels[n]);
+        add_child(&bar_channels[n]);
+    }
+
+    max_db.fill(-120);
+
+    field_frequency.set_step(channel_spacing);
+    field_frequency.updated = [this](rf::Frequency) {
+        update_channels();
+    };
+
+    receiver_model.enable();
+    update_channels();
+}
+
+ChannelizerView::~ChannelizerView() {
+    receiver_model.disable();
+    baseband::shutdown();
+}
+
+void ChannelizerView::focus() {
+    field_frequency.focus();
+}
+
+void ChannelizerView::on_statistics(const MultiChannelStatisticsMessage& message) {
+    std::copy(message.max_db.begin(), message.max_db.end(), max_db.begin());
+    update_channels();
+}
+
+/* Channel k is centred k * channel_spacing above the tuned frequency, the
+ * upper half of them wrap round to below it. Rows run from the lowest. */
+void ChannelizerView::update_channels() {
+    const auto center = receiver_model.target_frequency();
+    for (size_t row = 0; row < channel_count; row++) {
+        const size_t channel = (row + channel_count / 2) % channel_count;
+        const int32_t offset = (static_cast<int32_t>(row) - static_cast<int32_t>(channel_count / 2)) * static_cast<int32_t>(channel_spacing);
+        const auto db = max_db[channel];
+
+        text_channels[row].set(
+            to_string_dec_uint(channel, 2) + "  " +
+            to_string_short_freq(center + offset) + " " +
+            to_string_dec_int(db, 4) + "dB");
+        bar_channels[row].set_value(std::clamp<int32_t>(db + 100, 0, 100));
+    }
+}
+
+} /* namespace ui */
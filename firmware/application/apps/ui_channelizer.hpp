@@ -0,0 +1,119 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __UI_CHANNELIZER_H__
+#define __UI_CHANNELIZER_H__
+
+#include "ui_navigation.hpp"
+#include "ui_receiver.hpp"
+#include "ui_freq_field.hpp"
+#include "ui_rssi.hpp"
+
+#include "event_m0.hpp"
+#include "message.hpp"
+#include "radio_state.hpp"
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace ui {
+
+/* Runs the channelizer image and shows the peak level of each of its
+ * channels, lowest frequency first. */
+class ChannelizerView : public View {
+   public:
+    ChannelizerView(NavigationView& nav);
+    ~ChannelizerView();
+
+    void focus() override;
+
+    std::string title() const override { return "Channelizer"; };
+
+   private:
+    static constexpr size_t channel_count = MultiChannelStatisticsMessage::channel_count;
+    static constexpr uint32_t sampling_rate = 3072000;
+    static constexpr uint32_t channel_spacing = sampling_rate / channel_count;
+
+    NavigationView& nav_;
+    RxRadioState radio_state_{
+        1750000 /* bandwidth */,
+        sampling_rate /* sampling rate */
+    };
+
+    Labels labels{
+        {{0 * 8, 2 * 16}, "Ch  Frequency   Peak", Color::light_grey()}};
+
+    RxFrequencyField field_frequency{
+        {0 * 8, 0 * 16},
+        nav_};
+    RFAmpField field_rf_amp{
+        {13 * 8, 0 * 16}};
+
+    LNAGainField field_lna{
+        {15 * 8, 0 * 16}};
+
+    VGAGainField field_vga{
+        {18 * 8, 0 * 16}};
+
+    RSSI rssi{
+        {21 * 8, 0, 6 * 8, 4},
+    };
+
+    std::array<Text, channel_count> text_channels{{
+        {{0 * 8, 3 * 16, 20 * 8, 16}},
+        {{0 * 8, 4 * 16, 20 * 8, 16}},
+        {{0 * 8, 5 * 16, 20 * 8, 16}},
+        {{0 * 8, 6 * 16, 20 * 8, 16}},
+        {{0 * 8, 7 * 16, 20 * 8, 16}},
+        {{0 * 8, 8 * 16, 20 * 8, 16}},
+        {{0 * 8, 9 * 16, 20 * 8, 16}},
+        {{0 * 8, 10 * 16, 20 * 8, 16}},
+    }};
+
+    std::array<ProgressBar, channel_count> bar_channels{{
+        {{21 * 8, 3 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 4 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 5 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 6 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 7 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 8 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 9 * 16 + 2, 9 * 8, 12}},
+        {{21 * 8, 10 * 16 + 2, 9 * 8, 12}},
+    }};
+
+    std::array<int32_t, channel_count> max_db{};
+
+    MessageHandlerRegistration message_handler_statistics{
+        Message::ID::MultiChannelStatistics,
+        [this](const Message* const p) {
+            const auto message = static_cast<const MultiChannelStatisticsMessage*>(p);
+            this->on_statistics(*message);
+        }};
+
+    void on_statistics(const MultiChannelStatisticsMessage& message);
+    void update_channels();
+};
+
+} /* namespace ui */
+
+#endif /*__UI_CHANNELIZER_H__*/
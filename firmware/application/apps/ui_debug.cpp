@@ -26,10 +26,12 @@
 #include "radio.hpp"
 #include "string_format.hpp"
 #include "crc.hpp"
+#include "buffer_exchange.hpp"
 
 #include "audio.hpp"
 
 #include "ui_sd_card_debug.hpp"
+#include "ui_channelizer.hpp"
 
 #include "portapack.hpp"
 #include "portapack_persistent_memory.hpp"
@@ -66,6 +68,139 @@ void DebugMemoryView::focus() {
     button_done.focus();
 }
 
+/* DebugQueuesView *******************************************************/
+
+DebugQueuesView::DebugQueuesView(NavigationView& nav) {
+    add_children({&labels,
+                  &text_size,
+                  &text_used,
+                  &text_high_water,
+                  &text_messages,
+                  &text_wakeups,
+                  &text_drops,
+                  &text_wait_median,
+                  &text_wait_p99,
+                  &text_wait_max,
+                  &text_ids[0],
+                  &text_ids[1],
+                  &text_ids[2],
+                  &button_clear,
+                  &button_done});
+
+    button_clear.on_select = [this](Button&) {
+        shared_memory.application_queue.clear_statistics();
+        shared_memory.app_local_queue.clear_statistics();
+        update();
+    };
+    button_done.on_select = [&nav](Button&) { nav.pop(); };
+
+    update();
+}
+
+void DebugQueuesView::focus() {
+    button_done.focus();
+}
+
+/* Upper bound of the latency bucket that brings the messages counted up
+ * to the given share of all those handled. */
+static uint32_t latency_percentile(const MessageQueue::Statistics& stats, const uint32_t permille) {
+    const uint32_t target = (static_cast<uint64_t>(stats.handled) * permille + 999) / 1000;
+    uint32_t count = 0;
+    for (size_t n = 0; n < stats.latency.size(); n++) {
+        count += stats.latency[n];
+        if (count && (count >= target)) {
+            return std::min<uint32_t>((1UL << n) - 1, stats.latency_max);
+        }
+    }
+    return stats.latency_max;
+}
+
+/* Counts are since power on or Clear, they survive baseband image changes. */
+void DebugQueuesView::update() {
+    const auto& application = shared_memory.application_queue;
+    const auto& local = shared_memory.app_local_queue;
+    const auto application_stats = application.statistics();
+    const auto local_stats = local.statistics();
+
+    const auto row = [](const uint32_t a, const uint32_t b) {
+        return to_string_dec_uint(a, 8) + " " + to_string_dec_uint(b, 8);
+    };
+
+    text_size.set(row(application.capacity(), local.capacity()));
+    text_used.set(row(application.len(), local.len()));
+    text_high_water.set(row(application_stats.high_water, local_stats.high_water));
+    text_messages.set(row(application_stats.messages, local_stats.messages));
+    text_wakeups.set(row(application_stats.wakeups, local_stats.wakeups));
+    text_drops.set(row(application_stats.drops, local_stats.drops));
+
+    const uint32_t ticks_per_us = MessageQueue::timestamp_frequency() / 1000000;
+    const auto wait_row = [&row, ticks_per_us](const uint32_t a, const uint32_t b) {
+        return row(a / ticks_per_us, b / ticks_per_us);
+    };
+    text_wait_median.set(wait_row(latency_percentile(application_stats, 500), latency_percentile(local_stats, 500)));
+    text_wait_p99.set(wait_row(latency_percentile(application_stats, 990), latency_percentile(local_stats, 990)));
+    text_wait_max.set(wait_row(application_stats.latency_max, local_stats.latency_max));
+
+    // Keep the top few in order as the IDs go by
+    const auto before = [](const MessageQueue::IDStatistics& a, const MessageQueue::IDStatistics& b) {
+        return (a.drops != b.drops) ? (a.drops > b.drops) : (a.messages > b.messages);
+    };
+    std::array<std::pair<Message::ID, MessageQueue::IDStatistics>, id_rows> ids{};
+    for (size_t n = 0; n < toUType(Message::ID::MAX); n++) {
+        const auto id = static_cast<Message::ID>(n);
+        const auto stats = application.statistics(id);
+        for (size_t i = 0; i < ids.size(); i++) {
+            if (before(stats, ids[i].second)) {
+                std::copy_backward(&ids[i], &ids[ids.size() - 1], ids.end());
+                ids[i] = {id, stats};
+                break;
+            }
+        }
+    }
+    for (size_t n = 0; n < text_ids.size(); n++) {
+        const auto& s = ids[n].second;
+        if (s.messages || s.drops) {
+            text_ids[n].set(to_string_dec_uint(toUType(ids[n].first), 8) + " " +
+                            to_string_dec_uint(s.messages, 7) + " " +
+                            to_string_dec_uint(s.drops, 5) + " " +
+                            to_string_dec_uint(s.latency_max / ticks_per_us, 6));
+        } else {
+            text_ids[n].set("");
+        }
+    }
+}
+
+/* DebugStreamsView ******************************************************/
+
+DebugStreamsView::DebugStreamsView(NavigationView& nav) {
+    add_children({&labels,
+                  &text_buffers,
+                  &text_full_high_water,
+                  &text_full_drops,
+                  &text_empty_high_water,
+                  &text_empty_drops,
+                  &button_done});
+
+    button_done.on_select = [&nav](Button&) { nav.pop(); };
+
+    const auto& capture = BufferExchange::capture_statistics;
+    const auto& replay = BufferExchange::replay_statistics;
+
+    const auto row = [](const uint32_t a, const uint32_t b) {
+        return to_string_dec_uint(a, 8) + " " + to_string_dec_uint(b, 8);
+    };
+
+    text_buffers.set(row(capture.buffer_count, replay.buffer_count));
+    text_full_high_water.set(row(capture.full_high_water, replay.full_high_water));
+    text_full_drops.set(row(capture.full_drops, replay.full_drops));
+    text_empty_high_water.set(row(capture.empty_high_water, replay.empty_high_water));
+    text_empty_drops.set(row(capture.empty_drops, replay.empty_drops));
+}
+
+void DebugStreamsView::focus() {
+    button_done.focus();
+}
+
 /* TemperatureWidget *****************************************************/
 
 void TemperatureWidget::paint(Painter& painter) {
@@ -395,6 +530,9 @@ DebugMenuView::DebugMenuView(NavigationView& nav) {
     }
     add_items({
         {"Memory", ui::Color::dark_cyan(), &bitmap_icon_memory, [&nav]() { nav.push<DebugMemoryView>(); }},
+        {"Msg Queues", ui::Color::dark_cyan(), &bitmap_icon_memory, [&nav]() { nav.push<DebugQueuesView>(); }},
+        {"Stream FIFOs", ui::Color::dark_cyan(), &bitmap_icon_memory, [&nav]() { nav.push<DebugStreamsView>(); }},
+        {"Channelizer", ui::Color::dark_cyan(), &bitmap_icon_looking, [&nav]() { nav.push<ChannelizerView>(); }},
         //{ "Radio State",	ui::Color::white(),	nullptr,	[&nav](){ nav.push<NotImplementedView>(); } },
         {"SD Card", ui::Color::dark_cyan(), &bitmap_icon_sdcard, [&nav]() { nav.push<SDCardDebugView>(); }},
         {"Peripherals", ui::Color::dark_cyan(), &bitmap_icon_peripherals, [&nav]() { nav.push<DebugPeripheralsMenuView>(); }},
@@ -32,6 +32,7 @@
 #include "portapack.hpp"
 #include "memory_map.hpp"
 #include "irq_controls.hpp"
+#include "event_m0.hpp"
 
 #include <functional>
 #include <utility>
@@ -84,6 +85,102 @@ class DebugMemoryView : public View {
         "Done"};
 };
 
+class DebugQueuesView : public View {
+   public:
+    DebugQueuesView(NavigationView& nav);
+
+    void focus() override;
+
+    std::string title() const override { return "Msg Queues"; };
+
+   private:
+    static constexpr size_t update_interval = 30;  // Frames
+    static constexpr size_t id_rows = 3;
+
+    size_t frame_count{0};
+
+    Labels labels{
+        {{10 * 8, 1 * 16}, "   M4>M0    Local", Color::light_grey()},
+        {{0 * 8, 3 * 16}, "Size", Color::light_grey()},
+        {{0 * 8, 4 * 16}, "In use", Color::light_grey()},
+        {{0 * 8, 5 * 16}, "High water", Color::light_grey()},
+        {{0 * 8, 6 * 16}, "Messages", Color::light_grey()},
+        {{0 * 8, 7 * 16}, "Wakeups", Color::light_grey()},
+        {{0 * 8, 8 * 16}, "Drops", Color::light_grey()},
+        {{0 * 8, 9 * 16}, "Wait p50us", Color::light_grey()},
+        {{0 * 8, 10 * 16}, "Wait p99us", Color::light_grey()},
+        {{0 * 8, 11 * 16}, "Wait maxus", Color::light_grey()},
+        {{0 * 8, 12 * 16}, "M4>M0 ID    Msgs Drops Max us", Color::light_grey()},
+    };
+
+    Text text_size{{10 * 8, 3 * 16, 18 * 8, 16}};
+    Text text_used{{10 * 8, 4 * 16, 18 * 8, 16}};
+    Text text_high_water{{10 * 8, 5 * 16, 18 * 8, 16}};
+    Text text_messages{{10 * 8, 6 * 16, 18 * 8, 16}};
+    Text text_wakeups{{10 * 8, 7 * 16, 18 * 8, 16}};
+    Text text_drops{{10 * 8, 8 * 16, 18 * 8, 16}};
+    Text text_wait_median{{10 * 8, 9 * 16, 18 * 8, 16}};
+    Text text_wait_p99{{10 * 8, 10 * 16, 18 * 8, 16}};
+    Text text_wait_max{{10 * 8, 11 * 16, 18 * 8, 16}};
+
+    // Busiest message IDs, those that were dropped first
+    std::array<Text, id_rows> text_ids{{
+        {{0 * 8, 13 * 16, 30 * 8, 16}},
+        {{0 * 8, 14 * 16, 30 * 8, 16}},
+        {{0 * 8, 15 * 16, 30 * 8, 16}},
+    }};
+
+    Button button_clear{
+        {16, 264, 96, 24},
+        "Clear"};
+
+    Button button_done{
+        {128, 264, 96, 24},
+        "Done"};
+
+    void update();
+
+    MessageHandlerRegistration message_handler_frame_sync{
+        Message::ID::DisplayFrameSync,
+        [this](const Message* const) {
+            if (++this->frame_count >= update_interval) {
+                this->frame_count = 0;
+                this->update();
+            }
+        }};
+};
+
+class DebugStreamsView : public View {
+   public:
+    DebugStreamsView(NavigationView& nav);
+
+    void focus() override;
+
+    std::string title() const override { return "Stream FIFOs"; };
+
+   private:
+    Labels labels{
+        {{10 * 8, 1 * 16}, " Capture   Replay", Color::light_grey()},
+        {{0 * 8, 3 * 16}, "Buffers", Color::light_grey()},
+        {{0 * 8, 4 * 16}, "Full peak", Color::light_grey()},
+        {{0 * 8, 5 * 16}, "Full drops", Color::light_grey()},
+        {{0 * 8, 6 * 16}, "Empty peak", Color::light_grey()},
+        {{0 * 8, 7 * 16}, "Empty drop", Color::light_grey()},
+        {{0 * 8, 9 * 16}, "As the last stream of each", Color::light_grey()},
+        {{0 * 8, 10 * 16}, "kind ended.", Color::light_grey()},
+    };
+
+    Text text_buffers{{10 * 8, 3 * 16, 18 * 8, 16}};
+    Text text_full_high_water{{10 * 8, 4 * 16, 18 * 8, 16}};
+    Text text_full_drops{{10 * 8, 5 * 16, 18 * 8, 16}};
+    Text text_empty_high_water{{10 * 8, 6 * 16, 18 * 8, 16}};
+    Text text_empty_drops{{10 * 8, 7 * 16, 18 * 8, 16}};
+
+    Button button_done{
+        {72, 264, 96, 24},
+        "Done"};
+};
+
 class TemperatureWidget : public Widget {
    public:
     explicit TemperatureWidget(
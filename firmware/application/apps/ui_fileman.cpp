@@ -40,6 +40,9 @@ namespace ui {
 static const fs::path txt_ext{u".TXT"};
 static const fs::path ppl_ext{u".PPL"};
 static const fs::path c16_ext{u".C16"};
+static const fs::path c16z_ext{u".C16Z"};
+static const fs::path c8_ext{u".C8"};
+static const fs::path c12_ext{u".C12"};
 static const fs::path png_ext{u".PNG"};
 }  // namespace ui
 
@@ -50,6 +53,34 @@ bool is_hidden_file(const fs::path& path) {
     return !path.empty() && path.native()[0] == u'.';
 }
 
+// A filter ending in '*' matches every extension it starts, ".C16*" takes .C16 and .C16Z.
+bool extension_matches_one(const fs::path& ext, const std::u16string& pattern) {
+    if (!pattern.empty() && (pattern.back() == u'*')) {
+        const auto prefix = pattern.substr(0, pattern.size() - 1);
+        return path_iequal(fs::path{ext.native().substr(0, prefix.size())}, fs::path{prefix});
+    }
+    return path_iequal(ext, fs::path{pattern});
+}
+
+// Filters may list alternatives separated by '|', as in ".C16*|.C8".
+bool extension_matches(const fs::path& ext, const fs::path& filter) {
+    const auto& patterns = filter.native();
+    size_t start = 0;
+    while (true) {
+        const auto end = patterns.find(u'|', start);
+        if (extension_matches_one(ext, patterns.substr(start, end - start)))
+            return true;
+        if (end == std::u16string::npos)
+            return false;
+        start = end + 1;
+    }
+}
+
+bool is_capture_extension(const fs::path& ext) {
+    return path_iequal(ext, c16_ext) || path_iequal(ext, c16z_ext) ||
+           path_iequal(ext, c8_ext) || path_iequal(ext, c12_ext);
+}
+
 // Gets a truncated name from a path for display.
 std::string truncate(const fs::path& path, size_t max_length) {
     return ::truncate(path.string(), max_length);
@@ -77,9 +108,19 @@ fs::path get_partner_file(fs::path path) {
         return {};
     auto ext = path.extension();
 
-    if (path_iequal(ext, txt_ext))
-        ext = c16_ext;
-    else if (path_iequal(ext, c16_ext))
+    if (path_iequal(ext, txt_ext)) {
+        // Metadata belongs to whichever capture format is there.
+        for (const auto& capture_ext : {c16_ext, c16z_ext, c8_ext, c12_ext}) {
+            auto capture = path;
+            capture.replace_extension(capture_ext);
+            if (fs::file_exists(capture)) {
+                ext = capture_ext;
+                break;
+            }
+        }
+        if (path_iequal(ext, txt_ext))
+            return {};
+    } else if (is_capture_extension(ext))
         ext = txt_ext;
     else
         return {};
@@ -149,7 +190,7 @@ void FileManBaseView::load_directory_contents(const fs::path& dir_path) {
             continue;
 
         if (fs::is_regular_file(entry.status())) {
-            if (!filtering || path_iequal(entry.path().extension(), extension_filter))
+            if (!filtering || extension_matches(entry.path().extension(), extension_filter))
                 insert_sorted(entry_list, {entry.path(), (uint32_t)entry.size(), false});
         } else if (fs::is_directory(entry.status())) {
             insert_sorted(entry_list, {entry.path(), 0, true});
@@ -496,7 +537,7 @@ bool FileManagerView::handle_file_open() {
     if (path_iequal(txt_ext, ext)) {
         nav_.push<TextEditorView>(path);
         return true;
-    } else if (path_iequal(c16_ext, ext) || path_iequal(ppl_ext, ext)) {
+    } else if (is_capture_extension(ext) || path_iequal(ppl_ext, ext)) {
         // TODO: Enough memory to push?
         nav_.push<PlaylistView>(path);
         return true;
@@ -26,6 +26,7 @@
 
 #include "convert.hpp"
 #include "file_reader.hpp"
+#include "io_capture.hpp"
 #include "io_file.hpp"
 #include "string_format.hpp"
 #include "ui_fileman.hpp"
@@ -49,6 +50,9 @@ namespace ui {
 
 // TODO: consolidate extesions into a shared header?
 static const fs::path c16_ext = u".C16";
+static const fs::path c16z_ext = u".C16Z";
+static const fs::path c8_ext = u".C8";
+static const fs::path c12_ext = u".C12";
 static const fs::path ppl_ext = u".PPL";
 
 void PlaylistView::load_file(const fs::path& playlist_path) {
@@ -78,12 +82,6 @@ void PlaylistView::load_file(const fs::path& playlist_path) {
 }
 
 Optional<PlaylistView::playlist_entry> PlaylistView::load_entry(fs::path&& path) {
-    File capture_file;
-
-    auto error = capture_file.open(path);
-    if (error)
-        return {};
-
     // Read metafile if it exists.
     auto metadata_path = get_metadata_path(path);
     auto metadata = read_metadata_file(metadata_path);
@@ -92,10 +90,18 @@ Optional<PlaylistView::playlist_entry> PlaylistView::load_entry(fs::path&& path)
     if (!metadata)
         metadata = {transmitter_model.target_frequency(), 500'000};
 
+    // The extension has the last word on the format.
+    metadata->sample_format = get_capture_format(path);
+
+    // Also checks the capture file can be opened.
+    const auto data_size = capture_data_size(path, metadata->sample_format);
+    if (data_size.is_error())
+        return {};
+
     return playlist_entry{
         std::move(path),
         *metadata,
-        capture_file.size(),
+        data_size.value(),
         0u};
 }
 
@@ -239,7 +245,6 @@ void PlaylistView::send_current_track() {
     // Prepare to send a file.
     replay_thread_.reset();
     transmitter_model.disable();
-    ready_signal_ = false;
 
     if (!current())
         return;
@@ -249,8 +254,8 @@ void PlaylistView::send_current_track() {
         chThdSleepMilliseconds(current()->ms_delay);
 
     // Open the sample file to send.
-    auto reader = std::make_unique<FileReader>();
-    auto error = reader->open(current()->path);
+    std::unique_ptr<stream::Reader> reader;
+    auto error = open_capture_reader(current()->path, current()->metadata.sample_format, reader);
     if (error) {
         show_file_error(current()->path, "Can't open file to send.");
         return;
@@ -258,15 +263,12 @@ void PlaylistView::send_current_track() {
 
     // ReplayThread starts immediately on construction so
     // these need to be set before creating the ReplayThread.
+    const auto baseband_rate = baseband::set_replay_sample_rate(current()->metadata.sample_rate);
     transmitter_model.set_target_frequency(current()->metadata.center_frequency);
-    transmitter_model.set_sampling_rate(current()->metadata.sample_rate * 8);
+    transmitter_model.set_sampling_rate(baseband_rate);
     transmitter_model.set_baseband_bandwidth(baseband_bandwidth);
     transmitter_model.enable();
 
-    // Set baseband sample rate too for waterfall to be correct.
-    // TODO: Why doesn't the transmitter_model just handle this?
-    baseband::set_sample_rate(transmitter_model.sampling_rate());
-
     // Reset the transmit progress bar.
     progressbar_transmit.set_value(0);
 
@@ -275,7 +277,6 @@ void PlaylistView::send_current_track() {
         std::move(reader),
         /* read_size */ 0x4000,
         /* buffer_count */ 3,
-        &ready_signal_,
         [](uint32_t return_code) {
             ReplayThreadDoneMessage message{return_code};
             EventDispatcher::send_message(message);
@@ -397,7 +398,7 @@ PlaylistView::PlaylistView(
     button_add.on_select = [this, &nav]() {
         if (is_active())
             return;
-        auto open_view = nav_.push<FileLoadView>(".C16");
+        auto open_view = nav_.push<FileLoadView>(".C16*|.C8|.C12");
         open_view->push_dir(u"CAPTURES");
         open_view->on_changed = [this](fs::path path) {
             // Set focus to play only on the first "add".
@@ -454,7 +455,8 @@ PlaylistView::PlaylistView(
     auto ext = path.extension();
     if (path_iequal(ext, ppl_ext))
         on_file_changed(path);
-    else if (path_iequal(ext, c16_ext))
+    else if (path_iequal(ext, c16_ext) || path_iequal(ext, c16z_ext) ||
+             path_iequal(ext, c8_ext) || path_iequal(ext, c12_ext))
         add_entry(fs::path{path});
 }
 
@@ -72,7 +72,6 @@ class PlaylistView : public View {
     };
 
     std::unique_ptr<ReplayThread> replay_thread_{};
-    bool ready_signal_{};  // Used to signal the ReplayThread.
 
     size_t current_index_{0};
     bool playlist_dirty_{};
@@ -191,15 +190,6 @@ class PlaylistView : public View {
             handle_replay_thread_done(message.return_code);
         }};
 
-    MessageHandlerRegistration message_handler_fifo_signal{
-        Message::ID::RequestSignal,
-        [this](const Message* p) {
-            auto message = static_cast<const RequestSignalMessage*>(p);
-            if (message->signal == RequestSignalMessage::Signal::FillRequest) {
-                ready_signal_ = true;
-            }
-        }};
-
     MessageHandlerRegistration message_handler_tx_progress{
         Message::ID::TXProgress,
         [this](const Message* p) {
@@ -70,7 +70,7 @@ struct SearchRecentEntry {
     }
 };
 
-using SearchRecentEntries = RecentEntries<SearchRecentEntry>;
+using SearchRecentEntries = RecentEntries<SearchRecentEntry, 64>;
 
 class SearchView : public View {
    public:
@@ -136,7 +136,7 @@ class SearchView : public View {
                                         {"Time", 8},
                                         {"Duration", 11}}};
     SearchRecentEntries recent{};
-    RecentEntriesView<RecentEntries<SearchRecentEntry>> recent_entries_view{columns, recent};
+    RecentEntriesView<SearchRecentEntries> recent_entries_view{columns, recent};
 
     Labels labels{
         {{1 * 8, 0}, "Min:      Max:       LNA VGA", Color::light_grey()},
@@ -31,17 +31,58 @@
 
 #include "core_control.hpp"
 
+#include <algorithm>
+
 using namespace portapack;
 
 namespace baseband {
 
-static void send_message(const Message* const message) {
+static Thread* message_thread = nullptr;
+
+/* Sleeps until the baseband has handled the message, woken by the event
+ * its dispatcher raises afterwards. Rechecks every tick as well, for when
+ * that event is disabled (shutdown). Gives up if the M4 has panicked. */
+static bool wait_for_message(const systime_t timeout) {
+    const auto start = chTimeNow();
+
+    chSysLock();
+    while (shared_memory.baseband_message) {
+        const bool timed_out = (timeout != TIME_INFINITE) && (chTimeNow() - start >= timeout);
+        if (timed_out || shared_memory.m4_panic_msg[0]) {
+            chSysUnlock();
+            return false;
+        }
+
+        message_thread = chThdSelf();
+        chSchGoSleepTimeoutS(THD_STATE_SUSPENDED, 1);
+        message_thread = nullptr;
+    }
+    chSysUnlock();
+
+    return true;
+}
+
+/* The message slot is the completion token: the baseband clears it once
+ * it has handled the message, and there is only ever one in flight. */
+static bool send_message(const Message* const message, const systime_t timeout = TIME_INFINITE) {
     // If message is only sent by this function via one thread, no need to check if
     // another message is present before setting new message.
     shared_memory.baseband_message = message;
     creg::m0apptxevent::assert_event();
-    while (shared_memory.baseband_message)
-        ;
+
+    if (!wait_for_message(timeout)) {
+        // Withdraw it, only safe as the baseband is not going to read it.
+        shared_memory.baseband_message = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void check_message_isr() {
+    if (message_thread && !shared_memory.baseband_message) {
+        chSchReadyI(message_thread);
+        message_thread = nullptr;
+    }
 }
 
 void AMConfig::apply() const {
@@ -296,17 +337,24 @@ void shutdown() {
 
     creg::m4txevent::disable();
 
+    // The image is replaced next anyway, don't hang if it never answers.
     ShutdownMessage message;
-    send_message(&message);
+    send_message(&message, MS2ST(1000));
 
     shared_memory.application_queue.reset();
 
     baseband_image_running = false;
 }
 
-void spectrum_streaming_start() {
+void spectrum_streaming_start(
+    const SpectrumStreamingConfigMessage::Window window,
+    const SpectrumStreamingConfigMessage::Averaging averaging,
+    const uint32_t averaging_count) {
     SpectrumStreamingConfigMessage message{
-        SpectrumStreamingConfigMessage::Mode::Running};
+        SpectrumStreamingConfigMessage::Mode::Running,
+        window,
+        averaging,
+        averaging_count};
     send_message(&message);
 }
 
@@ -336,6 +384,24 @@ void replay_start(ReplayConfig* const config) {
     send_message(&message);
 }
 
+/* Sets up replay of a capture recorded at sample_rate, returns the rate
+ * the transmitter has to run at. Captures are interpolated up to at least
+ * 4MHz, so 500kHz ones go out at 4MHz as they always have. */
+uint32_t set_replay_sample_rate(const uint32_t sample_rate) {
+    constexpr uint32_t baseband_rate_min = 4000000;
+
+    const uint32_t rate = std::max<uint32_t>(sample_rate, 1);
+    const uint32_t interpolation = std::min((baseband_rate_min + rate - 1) / rate, ReplayRateConfigMessage::interpolation_max);
+    const uint32_t baseband_rate = rate * interpolation;
+
+    set_sample_rate(baseband_rate);
+
+    ReplayRateConfigMessage message{interpolation, 1};
+    send_message(&message);
+
+    return baseband_rate;
+}
+
 void replay_stop() {
     ReplayConfigMessage message{nullptr};
     send_message(&message);
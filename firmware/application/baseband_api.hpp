@@ -91,13 +91,20 @@ void request_beep();
 void run_image(const portapack::spi_flash::image_tag_t image_tag);
 void shutdown();
 
-void spectrum_streaming_start();
+/* Called from the M4 event interrupt, with the system locked. */
+void check_message_isr();
+
+void spectrum_streaming_start(
+    const SpectrumStreamingConfigMessage::Window window = SpectrumStreamingConfigMessage::Window::Hamming,
+    const SpectrumStreamingConfigMessage::Averaging averaging = SpectrumStreamingConfigMessage::Averaging::None,
+    const uint32_t averaging_count = 1);
 void spectrum_streaming_stop();
 
 void set_sample_rate(const uint32_t sample_rate);
 void capture_start(CaptureConfig* const config);
 void capture_stop();
 void replay_start(ReplayConfig* const config);
+uint32_t set_replay_sample_rate(const uint32_t sample_rate);
 void replay_stop();
 
 } /* namespace baseband */
@@ -23,6 +23,27 @@
 
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
+#include "sd_card.hpp"
+
+/* Rounds the stream buffer size down to whole sectors that never cross a
+ * cluster boundary: a power of two number of sectors up to a cluster,
+ * whole clusters above that. Every write is then whole sectors, which FatFs
+ * hands to the card as one multi-sector transfer straight from the buffer,
+ * bypassing its sector window. */
+static size_t cluster_aligned_write_size(const size_t write_size) {
+    const size_t sector_size = _MIN_SS;
+    const size_t cluster_size = sd_card::fs.csize * sector_size;
+
+    if (cluster_size && (write_size >= cluster_size)) {
+        return write_size / cluster_size * cluster_size;
+    }
+
+    size_t size = sector_size;
+    while (size * 2 <= write_size) {
+        size *= 2;
+    }
+    return size;
+}
 
 struct BasebandCapture {
     BasebandCapture(CaptureConfig* const config) {
@@ -40,9 +61,10 @@ CaptureThread::CaptureThread(
     std::unique_ptr<stream::Writer> writer,
     size_t write_size,
     size_t buffer_count,
+    CaptureFormat format,
     std::function<void()> success_callback,
     std::function<void(File::Error)> error_callback)
-    : config{write_size, buffer_count},
+    : config{cluster_aligned_write_size(write_size), buffer_count, format},
       writer{std::move(writer)},
       success_callback{std::move(success_callback)},
       error_callback{std::move(error_callback)} {
@@ -75,14 +97,32 @@ Optional<File::Error> CaptureThread::run() {
     BasebandCapture capture{&config};
     BufferExchange buffers{&config};
 
+    // Card throughput, over the time spent writing.
+    auto window_start = chTimeNow();
+    uint32_t window_bytes = 0;
+    systime_t window_write_time = 0;
+
     while (!chThdShouldTerminate()) {
         auto buffer = buffers.get();
+        const auto write_start = chTimeNow();
         auto write_result = writer->write(buffer->data(), buffer->size());
         if (write_result.is_error()) {
             return write_result.error();
         }
+        window_write_time += chTimeNow() - write_start;
+        bytes_written_ += write_result.value();
+        window_bytes += buffer->size();
         buffer->empty();
         buffers.put(buffer);
+
+        if ((chTimeNow() - window_start) >= CH_FREQUENCY) {
+            if (window_write_time) {
+                write_rate_ = static_cast<uint64_t>(window_bytes) * CH_FREQUENCY / window_write_time;
+            }
+            window_start = chTimeNow();
+            window_bytes = 0;
+            window_write_time = 0;
+        }
     }
 
     return {};
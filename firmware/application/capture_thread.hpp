@@ -39,6 +39,7 @@ class CaptureThread {
         std::unique_ptr<stream::Writer> writer,
         size_t write_size,
         size_t buffer_count,
+        CaptureFormat format,
         std::function<void()> success_callback,
         std::function<void(File::Error)> error_callback);
     ~CaptureThread();
@@ -52,12 +53,24 @@ class CaptureThread {
         return config;
     }
 
+    // Bytes per second the card took while being written, 0 until known.
+    uint32_t write_rate() const {
+        return write_rate_;
+    }
+
+    // Bytes handed to the writer so far.
+    uint32_t bytes_written() const {
+        return bytes_written_;
+    }
+
    private:
     CaptureConfig config;
     std::unique_ptr<stream::Writer> writer;
     std::function<void()> success_callback;
     std::function<void(File::Error)> error_callback;
     Thread* thread{nullptr};
+    volatile uint32_t write_rate_{0};
+    volatile uint32_t bytes_written_{0};
 
     static msg_t static_fn(void* arg);
 
@@ -34,6 +34,7 @@
 #include "irq_controls.hpp"
 
 #include "buffer_exchange.hpp"
+#include "baseband_api.hpp"
 
 #include "ch.h"
 
@@ -52,6 +53,7 @@ CH_IRQ_HANDLER(M4Core_IRQHandler) {
     chSysLockFromIsr();
     BufferExchange::handle_isr();
     EventDispatcher::check_fifo_isr();
+    baseband::check_message_isr();
     chSysUnlockFromIsr();
 
     creg::m4txevent::clear();
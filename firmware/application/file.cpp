@@ -112,6 +112,14 @@ File::Result<File::Offset> File::truncate() {
     return {static_cast<File::Offset>(position)};
 }
 
+Optional<File::Error> File::expand(const Size size) {
+    const auto result = f_expand(&f, size, 1);
+    if (result != FR_OK) {
+        return {result};
+    }
+    return {};
+}
+
 File::Size File::size() const {
     return f_size(&f);
 }
@@ -322,6 +322,8 @@ class File {
     Offset tell() const;
     Result<Offset> seek(uint64_t Offset);
     Result<Offset> truncate();
+    // Allocates size bytes as one contiguous cluster run, new files only.
+    Optional<Error> expand(const Size size);
     Size size() const;
 
     template <size_t N>
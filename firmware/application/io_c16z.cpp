@@ -0,0 +1,164 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "io_c16z.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+Optional<File::Error> C16ZFileWriter::create(const std::filesystem::path& filename, const File::Size preallocate_size) {
+    const auto create_error = FileWriter::create(filename, preallocate_size);
+    if (create_error.is_valid()) {
+        return create_error;
+    }
+
+    header = iq_codec::make_file_header();
+    const auto write_result = FileWriter::write(&header, sizeof(header));
+    if (write_result.is_error()) {
+        return write_result.error();
+    }
+
+    return {};
+}
+
+File::Result<File::Size> C16ZFileWriter::write(const void* const buffer, const File::Size bytes) {
+    auto write_result = FileWriter::write(buffer, bytes);
+    if (write_result.is_ok()) {
+        count_samples(static_cast<const uint8_t*>(buffer), write_result.value());
+    }
+    return write_result;
+}
+
+/* Blocks span buffers, so they are counted once all of each one is in the
+ * file and the next one starts where it should. */
+void C16ZFileWriter::count_samples(const uint8_t* p, size_t n) {
+    while (n) {
+        const size_t taken = parser.push(p, n);
+        p += taken;
+        n -= taken;
+
+        iq_codec::BlockHeader block{};
+        while (parser.next(block)) {
+            header.sample_count += block.sample_count;
+        }
+    }
+}
+
+Optional<File::Error> C16ZFileWriter::update_header() {
+    if (!iq_codec::check_file_header(header)) {
+        return {};  // Never created
+    }
+
+    // The last block has no next one to vouch for it
+    iq_codec::BlockHeader block{};
+    while (parser.next(block, true)) {
+        header.sample_count += block.sample_count;
+    }
+
+    const auto offset = file_.seek(0);
+    if (offset.is_error()) {
+        return offset.error();
+    }
+
+    const auto write_result = file_.write(&header, sizeof(header));
+    if (write_result.is_error()) {
+        return write_result.error();
+    }
+
+    return {};
+}
+
+Optional<File::Error> C16ZFileReader::open(const std::filesystem::path& filename) {
+    const auto open_error = FileReader::open(filename);
+    if (open_error.is_valid()) {
+        return open_error;
+    }
+
+    const auto read_result = file_.read(&header, sizeof(header));
+    if (read_result.is_error()) {
+        return read_result.error();
+    }
+    if ((read_result.value() != sizeof(header)) || !iq_codec::check_file_header(header)) {
+        return {static_cast<File::Error>(FR_UNEXPECTED)};
+    }
+
+    return {};
+}
+
+File::Result<File::Size> C16ZFileReader::read(void* const buffer, const File::Size bytes) {
+    auto p = static_cast<uint8_t*>(buffer);
+    File::Size done = 0;
+
+    while (done < bytes) {
+        if (position == decoded_bytes) {
+            const auto block_result = next_block();
+            if (block_result.is_error()) {
+                return block_result.error();
+            }
+            if (block_result.value() == 0) {
+                break;  // End of file
+            }
+        }
+
+        const size_t chunk = std::min<File::Size>(bytes - done, decoded_bytes - position);
+        memcpy(p + done, reinterpret_cast<const uint8_t*>(samples.data()) + position, chunk);
+        position += chunk;
+        done += chunk;
+    }
+
+    bytes_read_ += done;
+    return {static_cast<File::Size>(done)};
+}
+
+File::Result<File::Size> C16ZFileReader::next_block() {
+    position = 0;
+    decoded_bytes = 0;
+
+    while (true) {
+        const bool end = at_end && (chunk_position == chunk_size);
+        iq_codec::BlockHeader block{};
+        const auto payload = parser.next(block, end);
+        if (payload) {
+            if (iq_codec::decode_block(block, payload, samples.data())) {
+                decoded_bytes = block.sample_count * sizeof(complex16_t);
+                return {static_cast<File::Size>(decoded_bytes)};
+            }
+            parser.reject();
+            continue;
+        }
+        if (end) {
+            return {static_cast<File::Size>(0)};
+        }
+
+        // The file goes through the parser, which skips whatever a dropped
+        // write left behind
+        if (chunk_position == chunk_size) {
+            const auto read_result = file_.read(chunk.data(), chunk.size());
+            if (read_result.is_error()) {
+                return read_result.error();
+            }
+            chunk_position = 0;
+            chunk_size = read_result.value();
+            at_end = chunk_size < chunk.size();
+        }
+        chunk_position += parser.push(&chunk[chunk_position], chunk_size - chunk_position);
+    }
+}
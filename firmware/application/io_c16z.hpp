@@ -0,0 +1,93 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#pragma once
+
+#include "io_file.hpp"
+
+#include "file.hpp"
+#include "iq_codec.hpp"
+#include "optional.hpp"
+
+#include <array>
+#include <cstdint>
+
+/* Writes the .C16Z file header, then passes the compressed blocks coming
+ * from the baseband through as they are, counting the samples on the way.
+ * The count goes into the header when the file is closed. */
+class C16ZFileWriter : public FileWriter {
+   public:
+    C16ZFileWriter() = default;
+
+    C16ZFileWriter(const C16ZFileWriter&) = delete;
+    C16ZFileWriter& operator=(const C16ZFileWriter&) = delete;
+    C16ZFileWriter(C16ZFileWriter&&) = delete;
+    C16ZFileWriter& operator=(C16ZFileWriter&&) = delete;
+
+    ~C16ZFileWriter() {
+        update_header();
+    }
+
+    Optional<File::Error> create(const std::filesystem::path& filename, const File::Size preallocate_size = 0);
+
+    File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
+
+   private:
+    iq_codec::FileHeader header{};
+    iq_codec::BlockParser parser{};
+
+    void count_samples(const uint8_t* p, size_t n);
+    Optional<File::Error> update_header();
+};
+
+/* Reads a .C16Z file back as plain complex16_t samples, so it can stand in
+ * for a FileReader on a .C16 file. */
+class C16ZFileReader : public FileReader {
+   public:
+    C16ZFileReader() = default;
+
+    C16ZFileReader(const C16ZFileReader&) = delete;
+    C16ZFileReader& operator=(const C16ZFileReader&) = delete;
+    C16ZFileReader(C16ZFileReader&&) = delete;
+    C16ZFileReader& operator=(C16ZFileReader&&) = delete;
+
+    Optional<File::Error> open(const std::filesystem::path& filename);
+
+    File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+    // Decoded size in bytes, 0 if the capture was not closed properly.
+    File::Size data_size() const {
+        return header.sample_count * sizeof(complex16_t);
+    }
+
+   private:
+    iq_codec::FileHeader header{};
+    iq_codec::BlockParser parser{};
+    std::array<complex16_t, iq_codec::block_samples_max> samples{};
+    std::array<uint8_t, 512> chunk{};
+    size_t chunk_position{0};
+    size_t chunk_size{0};
+    bool at_end{false};
+    size_t decoded_bytes{0};
+    size_t position{0};
+
+    File::Result<File::Size> next_block();
+};
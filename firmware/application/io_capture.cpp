@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "io_capture.hpp"
+
+#include "io_c16z.hpp"
+#include "metadata_file.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+// A raw capture that was never closed still has its preallocated tail,
+// its metadata says how much of the file is samples.
+static Optional<File::Size> capture_size_limit(const std::filesystem::path& path) {
+    const auto metadata = read_metadata_file(get_metadata_path(path));
+    if (metadata && metadata->data_size)
+        return {static_cast<File::Size>(*metadata->data_size)};
+    return {};
+}
+
+File::Result<File::Size> PackedFileReader::read(void* const buffer, const File::Size bytes) {
+    const size_t sample_size = capture_sample_size(format);
+    const size_t count = bytes / sizeof(complex16_t);
+
+    // Read the packed samples into the end of the buffer and expand them
+    // forward in place, each one is consumed before it is overwritten.
+    auto p = static_cast<uint8_t*>(buffer);
+    auto packed = p + (count * sizeof(complex16_t)) - (count * sample_size);
+    const auto read_result = read_file(packed, count * sample_size);
+    if (read_result.is_error()) {
+        return read_result.error();
+    }
+
+    // A capture stopped mid-sample drops the partial one
+    const size_t samples_read = read_result.value() / sample_size;
+    if (samples_read < count) {
+        // Short read, move what there is down to where the expansion expects it
+        const auto dst = p + (samples_read * sizeof(complex16_t)) - (samples_read * sample_size);
+        memmove(dst, packed, samples_read * sample_size);
+        packed = dst;
+    }
+    capture_format::unpack(format, packed, samples_read, reinterpret_cast<complex16_t*>(p));
+
+    const File::Size done = samples_read * sizeof(complex16_t);
+    bytes_read_ += done;
+    return {static_cast<File::Size>(done)};
+}
+
+Optional<File::Error> open_capture_reader(
+    const std::filesystem::path& path,
+    const CaptureFormat format,
+    std::unique_ptr<stream::Reader>& reader) {
+    Optional<File::Error> error;
+
+    switch (format) {
+        case CaptureFormat::C16Z: {
+            auto p = std::make_unique<C16ZFileReader>();
+            error = p->open(path);
+            reader = std::move(p);
+            break;
+        }
+
+        case CaptureFormat::C8:
+        case CaptureFormat::C12: {
+            auto p = std::make_unique<PackedFileReader>(format);
+            error = p->open(path);
+            p->set_size_limit(capture_size_limit(path));
+            reader = std::move(p);
+            break;
+        }
+
+        default: {
+            auto p = std::make_unique<FileReader>();
+            error = p->open(path);
+            p->set_size_limit(capture_size_limit(path));
+            reader = std::move(p);
+            break;
+        }
+    }
+
+    if (error)
+        reader.reset();
+
+    return error;
+}
+
+File::Result<File::Size> capture_data_size(
+    const std::filesystem::path& path,
+    const CaptureFormat format) {
+    if (format == CaptureFormat::C16Z) {
+        C16ZFileReader reader;
+        const auto error = reader.open(path);
+        if (error)
+            return *error;
+        if (reader.data_size())
+            return {static_cast<File::Size>(reader.data_size())};
+        // Not closed properly, the compressed size will have to do
+        return {static_cast<File::Size>(reader.file().size())};
+    }
+
+    File file;
+    const auto error = file.open(path);
+    if (error)
+        return *error;
+
+    File::Size size = file.size();
+    const auto limit = capture_size_limit(path);
+    if (limit)
+        size = std::min(size, *limit);
+
+    const size_t sample_size = capture_sample_size(format);
+    return {static_cast<File::Size>(size / sample_size * sizeof(complex16_t))};
+}
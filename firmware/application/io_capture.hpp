@@ -0,0 +1,63 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#pragma once
+
+#include "io.hpp"
+#include "io_file.hpp"
+
+#include "file.hpp"
+#include "message.hpp"
+#include "optional.hpp"
+
+#include <memory>
+
+/* Reads a packed .C8 or .C12 capture back as complex16_t samples, so it
+ * can stand in for a FileReader on a .C16 file. */
+class PackedFileReader : public FileReader {
+   public:
+    PackedFileReader(const CaptureFormat format)
+        : format{format} {
+    }
+
+    PackedFileReader(const PackedFileReader&) = delete;
+    PackedFileReader& operator=(const PackedFileReader&) = delete;
+    PackedFileReader(PackedFileReader&&) = delete;
+    PackedFileReader& operator=(PackedFileReader&&) = delete;
+
+    File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
+
+   private:
+    const CaptureFormat format;
+};
+
+/* Opens a capture of any format for replay as complex16_t samples. */
+Optional<File::Error> open_capture_reader(
+    const std::filesystem::path& path,
+    const CaptureFormat format,
+    std::unique_ptr<stream::Reader>& reader);
+
+/* Size of a capture in complex16_t bytes, which is what replay progress
+ * and durations go by. */
+File::Result<File::Size> capture_data_size(
+    const std::filesystem::path& path,
+    const CaptureFormat format);
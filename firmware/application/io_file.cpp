@@ -21,14 +21,62 @@
 
 #include "io_file.hpp"
 
+#include <algorithm>
+
 File::Result<File::Size> FileReader::read(void* const buffer, const File::Size bytes) {
-    auto read_result = file_.read(buffer, bytes);
+    auto read_result = read_file(buffer, bytes);
     if (read_result.is_ok()) {
         bytes_read_ += read_result.value();
     }
     return read_result;
 }
 
+File::Result<File::Size> FileReader::read_file(void* const buffer, File::Size bytes) {
+    if (size_limit_) {
+        const File::Size position = file_.tell();
+        bytes = (position < *size_limit_) ? std::min(bytes, *size_limit_ - position) : 0;
+        if (bytes == 0) {
+            return {static_cast<File::Size>(0)};
+        }
+    }
+    return file_.read(buffer, bytes);
+}
+
+FileWriter::~FileWriter() {
+    if (preallocated_) {
+        // Give back the clusters past the data.
+        file_.seek(bytes_written_);
+        file_.truncate();
+    }
+}
+
+Optional<File::Error> FileWriter::create(const std::filesystem::path& filename, const File::Size preallocate_size) {
+    const auto create_error = file_.create(filename);
+    if (create_error.is_valid() || (preallocate_size == 0)) {
+        return create_error;
+    }
+
+    // Each failed attempt scans the whole FAT, so don't try for long.
+    constexpr size_t attempts_max = 4;
+    constexpr File::Size size_min = 1024 * 1024;
+    File::Size size = preallocate_size;
+    for (size_t attempt = 0; (attempt < attempts_max) && (size >= size_min); attempt++, size /= 2) {
+        if (!file_.expand(size).is_valid()) {
+            preallocated_ = true;
+            break;
+        }
+    }
+
+    // Puts the chain in the directory entry now. A recording cut short
+    // then leaves a file, not clusters marked used that no file owns.
+    if (preallocated_) {
+        file_.sync();
+    }
+
+    // Not finding the room is no reason to fail, the file just grows as usual.
+    return {};
+}
+
 File::Result<File::Size> FileWriter::write(const void* const buffer, const File::Size bytes) {
     auto write_result = file_.write(buffer, bytes);
     if (write_result.is_ok()) {
@@ -44,9 +44,16 @@ class FileReader : public stream::Reader {
     File::Result<File::Size> read(void* const buffer, const File::Size bytes) override;
     const File& file() const& { return file_; }
 
+    /* Reads stop this many bytes into the file. Used for a capture that
+     * was never closed, so its preallocated tail isn't read. */
+    void set_size_limit(const Optional<File::Size> limit) { size_limit_ = limit; }
+
    protected:
     File file_{};
     uint64_t bytes_read_{0};
+    Optional<File::Size> size_limit_{};
+
+    File::Result<File::Size> read_file(void* const buffer, File::Size bytes);
 };
 
 class FileWriter : public stream::Writer {
@@ -58,9 +65,13 @@ class FileWriter : public stream::Writer {
     FileWriter(FileWriter&& file) = delete;
     FileWriter& operator=(FileWriter&&) = delete;
 
-    Optional<File::Error> create(const std::filesystem::path& filename) {
-        return file_.create(filename);
-    }
+    ~FileWriter();
+
+    /* With a preallocate_size, the file gets that many bytes of contiguous
+     * clusters up front, or the largest half, quarter... of it that can be
+     * found, so writes never wait on the FAT to extend the cluster chain.
+     * Whatever is left unwritten is cut off when the writer goes away. */
+    Optional<File::Error> create(const std::filesystem::path& filename, const File::Size preallocate_size = 0);
 
     File::Result<File::Size> write(const void* const buffer, const File::Size bytes) override;
     const File& file() const& { return file_; }
@@ -68,6 +79,7 @@ class FileWriter : public stream::Writer {
    protected:
     File file_{};
     uint64_t bytes_written_{0};
+    bool preallocated_{false};
 };
 
 using RawFileWriter = FileWriter;
@@ -31,12 +31,47 @@ using namespace std::literals;
 
 const std::string_view center_freq_name = "center_frequency"sv;
 const std::string_view sample_rate_name = "sample_rate"sv;
+const std::string_view sample_format_name = "sample_format"sv;
+const std::string_view data_size_name = "data_size"sv;
+
+struct capture_format_info {
+    CaptureFormat format;
+    std::string_view name;
+    const char16_t* extension;
+};
+
+// Names as written in the metadata file, which are also the extensions.
+static constexpr capture_format_info capture_formats[] = {
+    {CaptureFormat::C16, "C16"sv, u".C16"},
+    {CaptureFormat::C16Z, "C16Z"sv, u".C16Z"},
+    {CaptureFormat::C8, "C8"sv, u".C8"},
+    {CaptureFormat::C12, "C12"sv, u".C12"},
+};
 
 fs::path get_metadata_path(const fs::path& capture_path) {
     auto temp = capture_path;
     return temp.replace_extension(u".TXT");
 }
 
+CaptureFormat get_capture_format(const fs::path& capture_path) {
+    const auto ext = capture_path.extension();
+    for (const auto& info : capture_formats) {
+        if (path_iequal(ext, fs::path{info.extension}))
+            return info.format;
+    }
+
+    return CaptureFormat::C16;
+}
+
+fs::path get_capture_extension(const CaptureFormat format) {
+    for (const auto& info : capture_formats) {
+        if (info.format == format)
+            return info.extension;
+    }
+
+    return u".C16";
+}
+
 Optional<File::Error> write_metadata_file(const fs::path& path, capture_metadata metadata) {
     File f;
     auto error = f.create(path);
@@ -54,9 +89,34 @@ Optional<File::Error> write_metadata_file(const fs::path& path, capture_metadata
     if (error)
         return error;
 
+    // Plain C16 captures keep the original two line format.
+    if (metadata.sample_format != CaptureFormat::C16) {
+        for (const auto& info : capture_formats) {
+            if (info.format == metadata.sample_format) {
+                error = f.write_line(std::string{sample_format_name} + "=" + std::string{info.name});
+                if (error)
+                    return error;
+            }
+        }
+    }
+
+    if (metadata.data_size) {
+        error = f.write_line(std::string{data_size_name} + "=" +
+                             to_string_dec_uint(*metadata.data_size));
+        if (error)
+            return error;
+    }
+
     return {};
 }
 
+static void parse_capture_format(const std::string_view name, CaptureFormat& format) {
+    for (const auto& info : capture_formats) {
+        if (name == info.name)
+            format = info.format;
+    }
+}
+
 Optional<capture_metadata> read_metadata_file(const fs::path& path) {
     File f;
     auto error = f.open(path);
@@ -77,6 +137,13 @@ Optional<capture_metadata> read_metadata_file(const fs::path& path) {
             parse_int(cols[1], metadata.center_frequency);
         else if (cols[0] == sample_rate_name)
             parse_int(cols[1], metadata.sample_rate);
+        else if (cols[0] == sample_format_name)
+            parse_capture_format(trim(cols[1]), metadata.sample_format);
+        else if (cols[0] == data_size_name) {
+            uint32_t data_size = 0;
+            if (parse_int(cols[1], data_size))
+                metadata.data_size = data_size;
+        }
         else
             continue;
     }
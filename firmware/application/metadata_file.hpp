@@ -23,16 +23,25 @@
 #define __METADATA_FILE_HPP__
 
 #include "file.hpp"
+#include "message.hpp"
 #include "optional.hpp"
 #include "rf_path.hpp"
 
 struct capture_metadata {
     rf::Frequency center_frequency;
     uint32_t sample_rate;
+    CaptureFormat sample_format{CaptureFormat::C16};
+    // Bytes of samples written, only while the capture is being recorded.
+    // Once it is closed properly the file size holds.
+    Optional<uint32_t> data_size{};
 };
 
 std::filesystem::path get_metadata_path(const std::filesystem::path& capture_path);
 
+// Sample format implied by a capture's file extension, and the reverse.
+CaptureFormat get_capture_format(const std::filesystem::path& capture_path);
+std::filesystem::path get_capture_extension(CaptureFormat format);
+
 Optional<File::Error> write_metadata_file(const std::filesystem::path& path, capture_metadata metadata);
 Optional<capture_metadata> read_metadata_file(const std::filesystem::path& path);
 
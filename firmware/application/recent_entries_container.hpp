@@ -0,0 +1,376 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __RECENT_ENTRIES_CONTAINER_H__
+#define __RECENT_ENTRIES_CONTAINER_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <algorithm>
+#include <iterator>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/* Hash of a recent entry key. Integers and enums are handled here; other
+ * key types provide an overload in their own namespace, found by ADL. */
+template <typename T>
+constexpr std::enable_if_t<std::is_integral<T>::value || std::is_enum<T>::value, uint32_t>
+recent_entry_hash(const T key) {
+    const uint64_t v = static_cast<uint64_t>(key);
+    return static_cast<uint32_t>(static_cast<uint32_t>(v ^ (v >> 32)) * 2654435761U);
+}
+
+template <typename A, typename B>
+uint32_t recent_entry_hash(const std::pair<A, B>& key) {
+    return (recent_entry_hash(key.first) * 31) ^ recent_entry_hash(key.second);
+}
+
+constexpr size_t recent_entries_table_size(const size_t capacity) {
+    size_t size = 1;
+    while (size < capacity * 2) size <<= 1;
+    return size;
+}
+
+/* Most-recently-used first list of entries, with at most Capacity of them.
+ * Entries live in a fixed pool, linked in recency order by index, and are
+ * indexed by key in an open-addressing table (linear probing, backward
+ * shift deletion), so nothing is allocated per packet and lookups stay
+ * constant-time however full it gets. When full, inserting at the front
+ * evicts the back entry.
+ *
+ * Offers the subset of std::list the recent entries views use. An entry's
+ * key must not change while it is stored.
+ */
+template <class Entry, size_t Capacity>
+class RecentEntries {
+    static_assert(Capacity > 0 && Capacity < 0x8000, "Capacity out of range");
+
+    using Key = typename Entry::Key;
+    using index_t = uint16_t;
+
+    static constexpr index_t nil = Capacity;
+
+    static constexpr size_t table_size = recent_entries_table_size(Capacity);
+    static constexpr index_t empty_slot = 0xffff;
+
+    struct Node {
+        index_t prev;
+        index_t next;
+    };
+
+   public:
+    using value_type = Entry;
+    using reference = Entry&;
+    using const_reference = const Entry&;
+    using size_type = size_t;
+
+    template <bool Const>
+    class Iterator {
+       public:
+        using iterator_category = std::bidirectional_iterator_tag;
+        using value_type = Entry;
+        using difference_type = std::ptrdiff_t;
+        using pointer = std::conditional_t<Const, const Entry*, Entry*>;
+        using reference = std::conditional_t<Const, const Entry&, Entry&>;
+        using container_t = std::conditional_t<Const, const RecentEntries, RecentEntries>;
+
+        Iterator() = default;
+        Iterator(container_t* container, const index_t node)
+            : container{container}, node{node} {
+        }
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        Iterator(const Iterator<false>& other)
+            : container{other.container}, node{other.node} {
+        }
+
+        reference operator*() const { return container->entry(node); }
+        pointer operator->() const { return &container->entry(node); }
+
+        Iterator& operator++() {
+            node = container->nodes[node].next;
+            return *this;
+        }
+        Iterator operator++(int) {
+            auto result = *this;
+            ++*this;
+            return result;
+        }
+        Iterator& operator--() {
+            node = (node == nil) ? container->tail : container->nodes[node].prev;
+            return *this;
+        }
+        Iterator operator--(int) {
+            auto result = *this;
+            --*this;
+            return result;
+        }
+
+        bool operator==(const Iterator& other) const { return node == other.node; }
+        bool operator!=(const Iterator& other) const { return node != other.node; }
+
+       private:
+        container_t* container{nullptr};
+        index_t node{nil};
+
+        friend class RecentEntries;
+        friend class Iterator<true>;
+    };
+
+    using iterator = Iterator<false>;
+    using const_iterator = Iterator<true>;
+    using reverse_iterator = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    RecentEntries() {
+        table.fill(empty_slot);
+        for (index_t i = 0; i < Capacity; i++) {
+            nodes[i].next = (static_cast<size_t>(i) + 1 < Capacity) ? (i + 1) : nil;
+        }
+        free_list = 0;
+    }
+
+    RecentEntries(const RecentEntries&) = delete;
+    RecentEntries& operator=(const RecentEntries&) = delete;
+
+    ~RecentEntries() {
+        clear();
+    }
+
+    iterator begin() { return {this, head}; }
+    iterator end() { return {this, nil}; }
+    const_iterator begin() const { return {this, head}; }
+    const_iterator end() const { return {this, nil}; }
+    reverse_iterator rbegin() { return reverse_iterator{end()}; }
+    reverse_iterator rend() { return reverse_iterator{begin()}; }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator{end()}; }
+    const_reverse_iterator rend() const { return const_reverse_iterator{begin()}; }
+
+    size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    static constexpr size_t capacity() { return Capacity; }
+
+    Entry& front() { return entry(head); }
+    const Entry& front() const { return entry(head); }
+    Entry& back() { return entry(tail); }
+    const Entry& back() const { return entry(tail); }
+
+    iterator find(const Key& key) {
+        return {this, lookup(key)};
+    }
+    const_iterator find(const Key& key) const {
+        return {this, lookup(key)};
+    }
+
+    template <typename... Args>
+    Entry& emplace_front(Args&&... args) {
+        if (count == Capacity) {
+            pop_back();
+        }
+        const index_t node = free_list;
+        free_list = nodes[node].next;
+        new (storage[node]) Entry(std::forward<Args>(args)...);
+        count++;
+        link_front(node);
+        index_insert(node);
+        return entry(node);
+    }
+
+    Entry& push_front(const Entry& value) {
+        return emplace_front(value);
+    }
+
+    void pop_back() {
+        if (count) erase(iterator{this, tail});
+    }
+
+    iterator erase(const_iterator position) {
+        const index_t node = position.node;
+        const index_t next = nodes[node].next;
+        index_remove(node);
+        unlink(node);
+        entry(node).~Entry();
+        nodes[node].next = free_list;
+        free_list = node;
+        count--;
+        return {this, next};
+    }
+
+    void clear() {
+        while (count) pop_back();
+    }
+
+    /* Moves the entry to the front, or creates it there. */
+    Entry& update_or_insert(const Key& key) {
+        const index_t node = lookup(key);
+        if (node == nil) {
+            return emplace_front(key);
+        }
+        unlink(node);
+        link_front(node);
+        return entry(node);
+    }
+
+    /* Stable sort by relinking, entries stay where they are. */
+    template <typename Compare>
+    void sort(Compare compare) {
+        std::array<index_t, Capacity> order;
+        size_t n = 0;
+        for (index_t node = head; node != nil; node = nodes[node].next) {
+            order[n++] = node;
+        }
+        std::stable_sort(order.begin(), order.begin() + n, [this, &compare](const index_t a, const index_t b) {
+            return compare(entry(a), entry(b));
+        });
+        head = nil;
+        tail = nil;
+        for (size_t i = n; i > 0; i--) {
+            link_front(order[i - 1]);
+        }
+    }
+
+   private:
+    alignas(Entry) uint8_t storage[Capacity][sizeof(Entry)];
+    std::array<Node, Capacity> nodes{};
+    std::array<index_t, table_size> table{};
+    index_t head{nil};
+    index_t tail{nil};
+    index_t free_list{nil};
+    size_t count{0};
+
+    Entry& entry(const index_t node) {
+        return *std::launder(reinterpret_cast<Entry*>(storage[node]));
+    }
+    const Entry& entry(const index_t node) const {
+        return *std::launder(reinterpret_cast<const Entry*>(storage[node]));
+    }
+
+    static size_t home_slot(const Key& key) {
+        return (recent_entry_hash(key) >> 16) & (table_size - 1);
+    }
+
+    index_t lookup(const Key& key) const {
+        for (size_t slot = home_slot(key);; slot = (slot + 1) & (table_size - 1)) {
+            const index_t node = table[slot];
+            if (node == empty_slot) return nil;
+            if (entry(node).key() == key) return node;
+        }
+    }
+
+    void index_insert(const index_t node) {
+        size_t slot = home_slot(entry(node).key());
+        while (table[slot] != empty_slot) {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        table[slot] = node;
+    }
+
+    void index_remove(const index_t node) {
+        size_t slot = home_slot(entry(node).key());
+        while (table[slot] != node) {
+            slot = (slot + 1) & (table_size - 1);
+        }
+        table[slot] = empty_slot;
+
+        // Shift back any later entries that probed past the hole.
+        for (size_t next = (slot + 1) & (table_size - 1); table[next] != empty_slot; next = (next + 1) & (table_size - 1)) {
+            const size_t home = home_slot(entry(table[next]).key());
+            const bool movable = (slot <= next) ? ((home <= slot) || (home > next)) : ((home <= slot) && (home > next));
+            if (movable) {
+                table[slot] = table[next];
+                table[next] = empty_slot;
+                slot = next;
+            }
+        }
+    }
+
+    void link_front(const index_t node) {
+        nodes[node].prev = nil;
+        nodes[node].next = head;
+        if (head != nil)
+            nodes[head].prev = node;
+        else
+            tail = node;
+        head = node;
+    }
+
+    void unlink(const index_t node) {
+        const index_t prev = nodes[node].prev;
+        const index_t next = nodes[node].next;
+        if (prev != nil)
+            nodes[prev].next = next;
+        else
+            head = next;
+        if (next != nil)
+            nodes[next].prev = prev;
+        else
+            tail = prev;
+    }
+};
+
+template <typename ContainerType, typename Key>
+typename ContainerType::const_iterator find(const ContainerType& entries, const Key key) {
+    return entries.find(key);
+}
+
+template <typename ContainerType, typename Key>
+typename ContainerType::iterator find(ContainerType& entries, const Key key) {
+    return entries.find(key);
+}
+
+template <typename ContainerType>
+static void truncate_entries(ContainerType& entries, const size_t entries_max = 64) {
+    while (entries.size() > entries_max) {
+        entries.pop_back();
+    }
+}
+
+template <typename ContainerType, typename Key>
+typename ContainerType::reference on_packet(ContainerType& entries, const Key key) {
+    return entries.update_or_insert(key);
+}
+
+template <typename ContainerType>
+static std::pair<typename ContainerType::const_iterator, typename ContainerType::const_iterator> range_around(
+    const ContainerType& entries,
+    typename ContainerType::const_iterator item,
+    const size_t count) {
+    auto start = item;
+    auto end = item;
+    size_t i = 0;
+
+    // Move start iterator toward first entry.
+    while ((start != std::begin(entries)) && (i < count / 2)) {
+        std::advance(start, -1);
+        i++;
+    }
+
+    // Move end iterator toward last entry.
+    while ((end != std::end(entries)) && (i < count)) {
+        std::advance(end, 1);
+        i++;
+    }
+
+    return {start, end};
+}
+
+#endif /*__RECENT_ENTRIES_CONTAINER_H__*/
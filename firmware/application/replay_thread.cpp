@@ -25,6 +25,9 @@
 #include "baseband_api.hpp"
 #include "buffer_exchange.hpp"
 
+#include <array>
+#include <cstring>
+
 struct BasebandReplay {
     BasebandReplay(ReplayConfig* const config) {
         baseband::replay_start(config);
@@ -41,11 +44,9 @@ ReplayThread::ReplayThread(
     std::unique_ptr<stream::Reader> reader,
     size_t read_size,
     size_t buffer_count,
-    bool* ready_signal,
     std::function<void(uint32_t return_code)> terminate_callback)
     : config{read_size, buffer_count},
       reader{std::move(reader)},
-      ready_sig{ready_signal},
       terminate_callback{std::move(terminate_callback)} {
     // Need significant stack for FATFS
     thread = chThdCreateFromHeap(NULL, 1024, NORMALPRIO + 10, ReplayThread::static_fn, this);
@@ -68,58 +69,100 @@ msg_t ReplayThread::static_fn(void* arg) {
     return 0;
 }
 
+static bool adjacent(const StreamBuffer* const a, const StreamBuffer* const b) {
+    return static_cast<const uint8_t*>(a->data()) + a->capacity() == b->data();
+}
+
+/* Reads ahead into every buffer the baseband has handed back. Buffers that
+ * are back to back in memory, as the baseband allocates them, are filled
+ * by one read, which FatFs transfers whole sectors at a time straight into
+ * them. */
 uint32_t ReplayThread::run() {
+    // Returns once the baseband has set up the buffers, ready to fill.
     BasebandReplay replay{&config};
     BufferExchange buffers{&config};
 
-    StreamBuffer* prefill_buffer{nullptr};
+    std::array<StreamBuffer*, buffer_count_max> batch{};
+    bool started = false;
+    // Filled buffers the baseband has not handed back yet.
+    size_t queued = 0;
 
-    // Wait for FIFOs to be allocated in baseband
-    // Wait for ui_replay_view to tell us that the buffers are ready (awful :( )
-    while (!(*ready_sig)) {
-        chThdSleep(100);
-    };
+    while (!chThdShouldTerminate()) {
+        size_t count = 0;
+        if (started) {
+            // Sleeps until the baseband has consumed a buffer.
+            batch[count++] = buffers.get();
+        }
+        while (count < batch.size()) {
+            const auto buffer = buffers.get_prefill();
+            if (!buffer) {
+                break;
+            }
+            batch[count++] = buffer;
+        }
+        if (started) {
+            queued -= count;
+        }
 
-    // While empty buffers fifo is not empty...
-    while (!buffers.empty()) {
-        prefill_buffer = buffers.get_prefill();
+        for (size_t first = 0; first < count;) {
+            size_t last = first + 1;
+            while ((last < count) && adjacent(batch[last - 1], batch[last])) {
+                last++;
+            }
 
-        if (prefill_buffer == nullptr) {
-            buffers.put_app(prefill_buffer);
-        } else {
-            size_t blocks = config.read_size / 512;
+            const auto read_result = fill(&batch[first], last - first);
+            if (read_result.is_error()) {
+                return READ_ERROR;
+            }
 
-            for (size_t c = 0; c < blocks; c++) {
-                auto read_result = reader->read(&((uint8_t*)prefill_buffer->data())[c * 512], 512);
-                if (read_result.is_error()) {
-                    return READ_ERROR;
+            const size_t filled = (read_result.value() + config.read_size - 1) / config.read_size;
+            for (size_t i = first; i < first + filled; i++) {
+                buffers.put(batch[i]);
+            }
+            queued += filled;
+            if (filled < last - first) {
+                // A file shorter than the prefill still has to start the
+                // baseband. Stopping it drops what it has not played, so
+                // wait for every filled buffer to come back first.
+                if (!started) {
+                    baseband::set_fifo_data(nullptr);
+                    started = true;
+                }
+                for (; queued > 0; queued--) {
+                    buffers.get();
                 }
+                return END_OF_FILE;
             }
 
-            prefill_buffer->set_size(config.read_size);
-
-            buffers.put(prefill_buffer);
+            first = last;
         }
-    };
 
-    baseband::set_fifo_data(nullptr);
+        if (!started) {
+            // All buffers are full, the baseband can start.
+            baseband::set_fifo_data(nullptr);
+            started = true;
+        }
+    }
 
-    while (!chThdShouldTerminate()) {
-        auto buffer = buffers.get();
+    return TERMINATED;
+}
 
-        auto read_result = reader->read(buffer->data(), buffer->capacity());
-        if (read_result.is_error()) {
-            return READ_ERROR;
-        } else {
-            if (read_result.value() == 0) {
-                return END_OF_FILE;
-            }
-        }
+File::Result<File::Size> ReplayThread::fill(StreamBuffer* const* const run, const size_t count) {
+    const File::Size size = count * config.read_size;
+    const auto read_result = reader->read(run[0]->data(), size);
+    if (read_result.is_error()) {
+        return read_result;
+    }
 
-        buffer->set_size(buffer->capacity());
+    // Silence after the end of the file rather than stale samples.
+    const auto bytes_read = read_result.value();
+    if (bytes_read < size) {
+        memset(static_cast<uint8_t*>(run[0]->data()) + bytes_read, 0, size - bytes_read);
+    }
 
-        buffers.put(buffer);
+    for (size_t i = 0; i < count; i++) {
+        run[i]->set_size(run[i]->capacity());
     }
 
-    return TERMINATED;
+    return read_result;
 }
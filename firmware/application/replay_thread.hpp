@@ -40,7 +40,6 @@ class ReplayThread {
         std::unique_ptr<stream::Reader> reader,
         size_t read_size,
         size_t buffer_count,
-        bool* ready_signal,
         std::function<void(uint32_t return_code)> terminate_callback);
     ~ReplayThread();
 
@@ -62,13 +61,16 @@ class ReplayThread {
    private:
     ReplayConfig config;
     std::unique_ptr<stream::Reader> reader;
-    bool* ready_sig;
     std::function<void(uint32_t return_code)> terminate_callback;
     Thread* thread{nullptr};
 
+    // As many as the baseband's StreamOutput can have.
+    static constexpr size_t buffer_count_max = 8;
+
     static msg_t static_fn(void* arg);
 
     uint32_t run();
+    File::Result<File::Size> fill(StreamBuffer* const* const run, const size_t count);
 };
 
 #endif /*__REPLAY_THREAD_H__*/
@@ -35,8 +35,34 @@ namespace ui {
 
 BasebandStatsView::BasebandStatsView() {
     add_children({
+        &labels,
+        &text_head,
+        &text_budget,
+        &text_min,
+        &text_avg,
+        &text_p99,
+        &text_max,
+        &text_missed,
         &text_stats,
     });
+    for (auto& text : text_stages) {
+        add_child(&text);
+    }
+}
+
+void BasebandStatsView::paint(Painter& painter) {
+    constexpr auto margin = 5;
+    constexpr auto lines = 14;
+
+    painter.fill_rectangle(
+        {{5 * 8 - margin, 3 * 16 - margin},
+         {19 * 8 + margin * 2, lines * 16 + margin * 2}},
+        Color::black());
+
+    painter.draw_rectangle(
+        {{4 * 8 - margin, 3 * 16 - margin - 8},
+         {21 * 8 + margin * 2, lines * 16 + margin * 2 + 16}},
+        Color::dark_cyan());
 }
 
 static std::string ticks_to_percent_string(const uint32_t ticks) {
@@ -55,4 +81,24 @@ void BasebandStatsView::on_statistics_update(const BasebandStatistics& statistic
     text_stats.set(message);
 }
 
+/* Cycles as microseconds and as a share of the budget. */
+static std::string cycles_to_load_string(const uint32_t cycles, const uint32_t budget) {
+    const uint32_t us = cycles / (base_m4_clk_f / 1000000);
+    const uint32_t percent = budget ? (static_cast<uint64_t>(cycles) * 100 / budget) : 0;
+    return to_string_dec_uint(us, 5) + "us " + to_string_dec_uint(std::min<uint32_t>(percent, 999), 3) + "%";
+}
+
+void BasebandStatsView::on_profile_update(const BasebandProfile& profile) {
+    const auto budget = profile.budget_cycles;
+    text_budget.set(cycles_to_load_string(budget, budget));
+    text_min.set(cycles_to_load_string(profile.min_cycles, budget));
+    text_avg.set(cycles_to_load_string(profile.avg_cycles, budget));
+    text_p99.set(cycles_to_load_string(profile.p99_cycles, budget));
+    text_max.set(cycles_to_load_string(profile.max_cycles, budget));
+    text_missed.set(to_string_dec_uint(profile.deadline_misses, 5) + "/" + to_string_dec_uint(profile.executes, 6));
+    for (size_t n = 0; n < text_stages.size(); n++) {
+        text_stages[n].set(cycles_to_load_string(profile.stage_cycles[n], budget));
+    }
+}
+
 } /* namespace ui */
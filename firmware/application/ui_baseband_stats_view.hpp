@@ -28,18 +28,61 @@
 
 #include "message.hpp"
 
+#include <array>
+
 namespace ui {
 
+/* Where the M4 baseband thread spends its time, shown over the running
+ * app. Times are per buffer, against the budget the DMA period allows. */
 class BasebandStatsView : public View {
    public:
     BasebandStatsView();
 
+    void paint(Painter& painter) override;
+
    private:
+    Labels labels{
+        {{5 * 8, 5 * 16}, "Budget", Color::dark_cyan()},
+        {{5 * 8, 6 * 16}, "Min", Color::dark_cyan()},
+        {{5 * 8, 7 * 16}, "Avg", Color::dark_cyan()},
+        {{5 * 8, 8 * 16}, "P99", Color::dark_cyan()},
+        {{5 * 8, 9 * 16}, "Max", Color::dark_cyan()},
+        {{5 * 8, 10 * 16}, "Missed", Color::dark_cyan()},
+        {{5 * 8, 11 * 16}, "Decim", Color::dark_cyan()},
+        {{5 * 8, 12 * 16}, "Demod", Color::dark_cyan()},
+        {{5 * 8, 13 * 16}, "Audio", Color::dark_cyan()},
+        {{5 * 8, 14 * 16}, "Spectr", Color::dark_cyan()},
+        {{5 * 8, 15 * 16}, "Other", Color::dark_cyan()},
+    };
+
+    Text text_head{{5 * 8, 3 * 16, 19 * 8, 1 * 16}, "Baseband profile"};
+
+    Text text_budget{{12 * 8, 5 * 16, 12 * 8, 1 * 16}, ""};
+    Text text_min{{12 * 8, 6 * 16, 12 * 8, 1 * 16}, ""};
+    Text text_avg{{12 * 8, 7 * 16, 12 * 8, 1 * 16}, ""};
+    Text text_p99{{12 * 8, 8 * 16, 12 * 8, 1 * 16}, ""};
+    Text text_max{{12 * 8, 9 * 16, 12 * 8, 1 * 16}, ""};
+    Text text_missed{{12 * 8, 10 * 16, 12 * 8, 1 * 16}, ""};
+    std::array<Text, BasebandProfile::StageCount> text_stages{{
+        {{12 * 8, 15 * 16, 12 * 8, 1 * 16}, ""},
+        {{12 * 8, 11 * 16, 12 * 8, 1 * 16}, ""},
+        {{12 * 8, 12 * 16, 12 * 8, 1 * 16}, ""},
+        {{12 * 8, 13 * 16, 12 * 8, 1 * 16}, ""},
+        {{12 * 8, 14 * 16, 12 * 8, 1 * 16}, ""},
+    }};
+
+    // Thread loads, from processors that send BasebandStatistics
     Text text_stats{
-        {0 * 8, 0, (4 * 4 + 3) * 8, 1 * 16},
+        {5 * 8, 16 * 16, (4 * 4 + 3) * 8, 1 * 16},
         "",
     };
 
+    MessageHandlerRegistration message_handler_profile{
+        Message::ID::BasebandProfile,
+        [this](const Message* const p) {
+            this->on_profile_update(static_cast<const BasebandProfileMessage*>(p)->profile);
+        }};
+
     MessageHandlerRegistration message_handler_stats{
         Message::ID::BasebandStatistics,
         [this](const Message* const p) {
@@ -47,6 +90,7 @@ class BasebandStatsView : public View {
         }};
 
     void on_statistics_update(const BasebandStatistics& statistics);
+    void on_profile_update(const BasebandProfile& profile);
 };
 
 } /* namespace ui */
@@ -731,7 +731,14 @@ void SystemView::toggle_overlay() {
             break;
         case 3:
             this->remove_child(&this->overlay2);
+            this->add_child(&this->overlay3);
             this->set_dirty();
+            shared_memory.request_m4_performance_counter = SharedMemory::m4_performance_counter_profile;
+            break;
+        case 4:
+            this->remove_child(&this->overlay3);
+            this->set_dirty();
+            shared_memory.request_m4_performance_counter = 0;
             overlay_active = 0;
             break;
     }
@@ -747,8 +754,10 @@ void SystemView::paint_overlay() {
         last_paint_state = !last_paint_state;
         if (overlay_active == 1)
             this->overlay.set_dirty();
-        else
+        else if (overlay_active == 2)
             this->overlay2.set_dirty();
+        else
+            this->overlay3.set_dirty();
     }
 }
 
@@ -34,6 +34,7 @@
 #include "ui_audio.hpp"
 #include "ui_sd_card_status_view.hpp"
 #include "ui_dfu_menu.hpp"
+#include "ui_baseband_stats_view.hpp"
 
 #include "bitmap.hpp"
 #include "ff.h"
@@ -334,6 +335,7 @@ class SystemView : public View {
     InformationView info_view{navigation_view};
     DfuMenu overlay{navigation_view};
     DfuMenu2 overlay2{navigation_view};
+    BasebandStatsView overlay3{};
     NavigationView navigation_view{};
     Context& context_;
 };
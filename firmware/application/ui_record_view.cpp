@@ -24,6 +24,7 @@
 #include "portapack.hpp"
 using namespace portapack;
 
+#include "io_c16z.hpp"
 #include "io_file.hpp"
 #include "io_wave.hpp"
 
@@ -37,6 +38,12 @@ using namespace portapack;
 
 namespace ui {
 
+// FAT32 files stop short of 4GiB.
+static constexpr uint64_t max_file_size = 0xFFFFFFFF;
+
+// Seconds between metadata rewrites while recording.
+static constexpr uint32_t metadata_interval = 10;
+
 /*void RecordView::toggle_pitch_rssi() {
         pitch_rssi_enabled = !pitch_rssi_enabled;
 
@@ -129,6 +136,27 @@ void RecordView::set_sampling_rate(const size_t new_sampling_rate) {
     }
 }
 
+CaptureFormat RecordView::capture_format() const {
+    switch (file_type) {
+        case FileType::CompressedS16:
+            return CaptureFormat::C16Z;
+        case FileType::RawS8:
+            return CaptureFormat::C8;
+        case FileType::PackedS12:
+            return CaptureFormat::C12;
+        default:
+            return CaptureFormat::C16;
+    }
+}
+
+void RecordView::set_file_type(const FileType new_file_type) {
+    if (new_file_type != file_type) {
+        stop();
+        file_type = new_file_type;
+        update_status_display();
+    }
+}
+
 // Setter for datetime and frequency filename
 void RecordView::set_filename_date_frequency(bool set) {
     filename_date_frequency = set;
@@ -194,22 +222,45 @@ void RecordView::start() {
             }
         } break;
 
-        case FileType::RawS16: {
-            const auto metadata_file_error =
-                write_metadata_file(get_metadata_path(base_path),
-                                    {receiver_model.target_frequency(), sampling_rate / 8});
+        case FileType::RawS16:
+        case FileType::CompressedS16:
+        case FileType::RawS8:
+        case FileType::PackedS12: {
+            const auto format = capture_format();
             // Not sure why sample_rate is div. 8, but stored value matches rate settings.
+            capture_metadata new_metadata{receiver_model.target_frequency(), sampling_rate / 8, format};
+            // C16Z keeps its data size in its own header.
+            if (format != CaptureFormat::C16Z)
+                new_metadata.data_size = 0;
+            const auto metadata_file_error = write_metadata_file(get_metadata_path(base_path), new_metadata);
             if (metadata_file_error.is_valid()) {
                 handle_error(metadata_file_error.value());
                 return;
             }
 
-            auto p = std::make_unique<RawFileWriter>();
-            auto create_error = p->create(base_path.replace_extension(u".C16"));
-            if (create_error.is_valid()) {
-                handle_error(create_error.value());
+            // Room for as long as the card allows, what text_time_available shows.
+            const File::Size preallocate_size = std::min<uint64_t>(std::filesystem::space(u"").free, max_file_size);
+
+            if (format == CaptureFormat::C16Z) {
+                auto p = std::make_unique<C16ZFileWriter>();
+                auto create_error = p->create(base_path.replace_extension(u".C16Z"), preallocate_size);
+                if (create_error.is_valid()) {
+                    handle_error(create_error.value());
+                } else {
+                    writer = std::move(p);
+                }
             } else {
-                writer = std::move(p);
+                // Packed samples come from the baseband ready to write.
+                auto p = std::make_unique<RawFileWriter>();
+                auto create_error = p->create(base_path.replace_extension(get_capture_extension(format)), preallocate_size);
+                if (create_error.is_valid()) {
+                    handle_error(create_error.value());
+                } else {
+                    writer = std::move(p);
+                    metadata_path = get_metadata_path(base_path);
+                    metadata = new_metadata;
+                    metadata_age = 0;
+                }
             }
         } break;
 
@@ -223,6 +274,7 @@ void RecordView::start() {
         capture_thread = std::make_unique<CaptureThread>(
             std::move(writer),
             write_size, buffer_count,
+            capture_format(),
             []() {
                 CaptureThreadDoneMessage message{};
                 EventDispatcher::send_message(message);
@@ -247,13 +299,34 @@ void RecordView::stop() {
         button_record.set_bitmap(&bitmap_record);
     }
 
+    if (!metadata_path.empty()) {
+        // The writer cut the file to its data, its size holds again.
+        metadata.data_size = Optional<uint32_t>{};
+        write_metadata_file(metadata_path, metadata);
+        metadata_path = {};
+    }
+
     update_status_display();
 }
 
 void RecordView::on_tick_second() {
+    // Until the file is closed, its size includes the preallocated tail.
+    // A crash loses at most the last few seconds written since.
+    if (is_active() && !metadata_path.empty() && (++metadata_age >= metadata_interval)) {
+        metadata_age = 0;
+        metadata.data_size = capture_thread->bytes_written();
+        write_metadata_file(metadata_path, metadata);
+    }
+
     update_status_display();
 }
 
+uint32_t RecordView::bytes_per_second() const {
+    // Compressed captures are counted at the raw rate, the ratio depends on the signal.
+    const size_t sample_size = (file_type == FileType::CompressedS16) ? sizeof(complex16_t) : capture_sample_size(capture_format());
+    return file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / 8 * sample_size);  // TODO: Why 8/4??
+}
+
 void RecordView::update_status_display() {
     if (is_active()) {
         const auto dropped_percent = std::min(99U, capture_thread->state().dropped_percent());
@@ -265,10 +338,13 @@ void RecordView::update_status_display() {
                 button_pitch_rssi.invert_colors();
         }*/
 
-    if (sampling_rate) {
+    if (is_active() && capture_thread->write_rate()) {
+        // While recording, how fast the card keeps up instead.
+        const auto rate = capture_thread->write_rate();
+        text_time_available.set(to_string_decimal(rate / 1000000.0f, 2) + "MB/s");
+    } else if (sampling_rate) {
         const auto space_info = std::filesystem::space(u"");
-        const uint32_t bytes_per_second = file_type == FileType::WAV ? (sampling_rate * 2) : (sampling_rate / 8 * 4);  // TODO: Why 8/4??
-        const uint32_t available_seconds = space_info.free / bytes_per_second;
+        const uint32_t available_seconds = space_info.free / bytes_per_second();
         const uint32_t seconds = available_seconds % 60;
         const uint32_t available_minutes = available_seconds / 60;
         const uint32_t minutes = available_minutes % 60;
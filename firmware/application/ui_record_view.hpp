@@ -25,6 +25,7 @@
 #include "ui_widget.hpp"
 
 #include "capture_thread.hpp"
+#include "metadata_file.hpp"
 #include "signal.hpp"
 
 #include "bitmap.hpp"
@@ -42,6 +43,9 @@ class RecordView : public View {
     enum FileType {
         RawS16 = 2,
         WAV = 3,
+        CompressedS16 = 4,
+        RawS8 = 5,
+        PackedS12 = 6,
     };
 
     RecordView(
@@ -56,6 +60,7 @@ class RecordView : public View {
     void focus() override;
 
     void set_sampling_rate(const size_t new_sampling_rate);
+    void set_file_type(const FileType new_file_type);
 
     void start();
     void stop();
@@ -71,9 +76,11 @@ class RecordView : public View {
 
     void on_tick_second();
     void update_status_display();
+    uint32_t bytes_per_second() const;
 
     void handle_capture_thread_done(const File::Error error);
     void handle_error(const File::Error error);
+    CaptureFormat capture_format() const;
 
     // bool pitch_rssi_enabled = false;
 
@@ -83,12 +90,18 @@ class RecordView : public View {
 
     const std::filesystem::path filename_stem_pattern;
     const std::filesystem::path folder;
-    const FileType file_type;
+    FileType file_type;
     const size_t write_size;
     const size_t buffer_count;
     size_t sampling_rate{0};
     SignalToken signal_token_tick_second{};
 
+    // Raw captures only, their metadata keeps the data size up to date
+    // while recording.
+    std::filesystem::path metadata_path{};
+    capture_metadata metadata{};
+    uint32_t metadata_age{0};
+
     Rectangle rect_background{
         Color::black()};
 
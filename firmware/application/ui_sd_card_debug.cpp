@@ -32,6 +32,8 @@
 #include "ch.h"
 #include "hal.h"
 
+#include <algorithm>
+
 class SDCardTestThread {
    public:
     enum Result {
@@ -59,12 +61,19 @@ class SDCardTestThread {
         "OK",
     };
 
+    struct WriteStats {
+        halrtcnt_t duration_min{0};
+        halrtcnt_t duration_max{0};
+        halrtcnt_t duration_p99{0};
+        halrtcnt_t test_duration{0};
+        File::Size bytes{0};
+        size_t count{0};
+        bool expanded{false};
+    };
+
     struct Stats {
-        halrtcnt_t write_duration_min{0};
-        halrtcnt_t write_duration_max{0};
-        halrtcnt_t write_test_duration{0};
-        File::Size write_bytes{0};
-        size_t write_count{0};
+        WriteStats write{};
+        WriteStats write_expanded{};
 
         halrtcnt_t read_duration_min{0};
         halrtcnt_t read_duration_max{0};
@@ -94,6 +103,7 @@ class SDCardTestThread {
     static constexpr File::Size write_size = 16384;
     static constexpr File::Size bytes_to_write = 16 * 1024 * 1024;
     static constexpr File::Size bytes_to_read = bytes_to_write;
+    static constexpr size_t write_count_max = bytes_to_write / write_size;
 
     static Thread* thread;
     volatile Result _result{Result::Incomplete};
@@ -108,17 +118,25 @@ class SDCardTestThread {
     Result run() {
         const std::filesystem::path filename{u"_PPTEST_.DAT"};
 
-        const auto write_result = write(filename);
-        if (write_result != Result::OK) {
-            return write_result;
-        }
+        // Once growing the cluster chain as it goes, once preallocated.
+        for (const bool expand : {false, true}) {
+            auto& stats = expand ? _stats.write_expanded : _stats.write;
+            const auto write_result = write(filename, expand, stats);
+            if (write_result != Result::OK) {
+                return write_result;
+            }
 
-        if (_stats.write_bytes < bytes_to_write) {
-            return Result::FailWriteIncomplete;
-        }
+            if (stats.bytes < bytes_to_write) {
+                return Result::FailWriteIncomplete;
+            }
 
-        if (chThdShouldTerminate()) {
-            return Result::FailAbort;
+            if (chThdShouldTerminate()) {
+                return Result::FailAbort;
+            }
+
+            if (!expand) {
+                f_unlink(reinterpret_cast<const TCHAR*>(filename.c_str()));
+            }
         }
 
         const auto read_result = read(filename);
@@ -139,9 +157,10 @@ class SDCardTestThread {
         return Result::OK;
     }
 
-    Result write(const std::filesystem::path& filename) {
+    Result write(const std::filesystem::path& filename, const bool expand, WriteStats& stats) {
         const auto buffer = std::make_unique<std::array<uint8_t, write_size>>();
-        if (!buffer) {
+        const auto durations = std::make_unique<std::array<halrtcnt_t, write_count_max>>();
+        if (!buffer || !durations) {
             return Result::FailHeap;
         }
 
@@ -151,10 +170,14 @@ class SDCardTestThread {
             return Result::FailFileOpenWrite;
         }
 
+        // A fragmented card may have no run this long, the file then just
+        // grows and the preallocated figures are left out.
+        stats.expanded = expand && !file.expand(bytes_to_write).is_valid();
+
         lfsr_word_t v = 1;
 
         const halrtcnt_t test_start = halGetCounterValue();
-        while (!chThdShouldTerminate() && (_stats.write_bytes < bytes_to_write)) {
+        while (!chThdShouldTerminate() && (stats.bytes < bytes_to_write)) {
             lfsr_fill(v,
                       reinterpret_cast<lfsr_word_t*>(buffer->data()),
                       sizeof(*buffer.get()) / sizeof(lfsr_word_t));
@@ -165,22 +188,28 @@ class SDCardTestThread {
                 break;
             }
             const halrtcnt_t write_end = halGetCounterValue();
-            _stats.write_bytes += buffer->size();
-            _stats.write_count++;
+            stats.bytes += buffer->size();
 
             const halrtcnt_t write_duration = write_end - write_start;
-            if ((_stats.write_duration_min == 0) || (write_duration < _stats.write_duration_min)) {
-                _stats.write_duration_min = write_duration;
+            (*durations)[stats.count++] = write_duration;
+            if ((stats.duration_min == 0) || (write_duration < stats.duration_min)) {
+                stats.duration_min = write_duration;
             }
-            if (write_duration > _stats.write_duration_max) {
-                _stats.write_duration_max = write_duration;
+            if (write_duration > stats.duration_max) {
+                stats.duration_max = write_duration;
             }
         }
 
         file.sync();
 
         const halrtcnt_t test_end = halGetCounterValue();
-        _stats.write_test_duration = test_end - test_start;
+        stats.test_duration = test_end - test_start;
+
+        if (stats.count) {
+            const auto p99 = durations->begin() + (stats.count * 99 / 100);
+            std::nth_element(durations->begin(), p99, durations->begin() + stats.count);
+            stats.duration_p99 = *p99;
+        }
 
         return Result::OK;
     }
@@ -260,6 +289,8 @@ SDCardDebugView::SDCardDebugView(NavigationView& nav) {
         &text_test_write_time_value,
         &text_test_write_rate_title,
         &text_test_write_rate_value,
+        &text_test_write_p99_title,
+        &text_test_write_p99_value,
         &text_test_read_time_title,
         &text_test_read_time_value,
         &text_test_read_rate_title,
@@ -319,6 +350,7 @@ void SDCardDebugView::on_status(const sd_card::Status) {
     text_capacity_value.set("");
     text_test_write_time_value.set("");
     text_test_write_rate_value.set("");
+    text_test_write_p99_value.set("");
     text_test_read_time_value.set("");
     text_test_read_rate_value.set("");
 
@@ -398,6 +430,7 @@ static std::string format_bytes_per_ticks_as_mib(const File::Size bytes, const h
 void SDCardDebugView::on_test() {
     text_test_write_time_value.set("");
     text_test_write_rate_value.set("");
+    text_test_write_p99_value.set("");
     text_test_read_time_value.set("");
     text_test_read_rate_value.set("");
 
@@ -421,16 +454,20 @@ void SDCardDebugView::on_test() {
 
     if (thread.result() == SDCardTestThread::Result::OK) {
         const auto stats = thread.stats();
-        const auto write_duration_avg = stats.write_test_duration / stats.write_count;
+        const auto write_duration_avg = stats.write.test_duration / stats.write.count;
 
         text_test_write_time_value.set(
-            format_ticks_as_ms(stats.write_duration_min) + "/" +
+            format_ticks_as_ms(stats.write.duration_min) + "/" +
             format_ticks_as_ms(write_duration_avg) + "/" +
-            format_ticks_as_ms(stats.write_duration_max));
+            format_ticks_as_ms(stats.write.duration_max));
 
         text_test_write_rate_value.set(
-            format_bytes_per_ticks_as_mib(stats.write_bytes, stats.write_duration_min * stats.write_count) + " " +
-            format_bytes_per_ticks_as_mib(stats.write_bytes, stats.write_test_duration));
+            format_bytes_per_ticks_as_mib(stats.write.bytes, stats.write.duration_min * stats.write.count) + " " +
+            format_bytes_per_ticks_as_mib(stats.write.bytes, stats.write.test_duration));
+
+        text_test_write_p99_value.set(
+            format_ticks_as_ms(stats.write.duration_p99) + "/" +
+            (stats.write_expanded.expanded ? format_ticks_as_ms(stats.write_expanded.duration_p99) : "n/a"));
 
         const auto read_duration_avg = stats.read_test_duration / stats.read_count;
 
@@ -162,29 +162,42 @@ class SDCardDebugView : public View {
         "",
     };
 
+    // Plain/preallocated file
+    static constexpr size_t test_write_p99_characters = 15;
+
+    Text text_test_write_p99_title{
+        {0, 14 * 16, (8 * 8), 16},
+        "W p99 ms",
+    };
+
+    Text text_test_write_p99_value{
+        {240 - (test_write_p99_characters * 8), 14 * 16, (test_write_p99_characters * 8), 16},
+        "",
+    };
+
     ///////////////////////////////////////////////////////////////////////
 
     static constexpr size_t test_read_time_characters = 23;
 
     Text text_test_read_time_title{
-        {0, 14 * 16, (4 * 8), 16},
+        {0, 15 * 16, (4 * 8), 16},
         "R ms",
     };
 
     Text text_test_read_time_value{
-        {240 - (test_read_time_characters * 8), 14 * 16, (test_read_time_characters * 8), 16},
+        {240 - (test_read_time_characters * 8), 15 * 16, (test_read_time_characters * 8), 16},
         "",
     };
 
     static constexpr size_t test_read_rate_characters = 23;
 
     Text text_test_read_rate_title{
-        {0, 15 * 16, (6 * 8), 16},
+        {0, 16 * 16, (6 * 8), 16},
         "R MB/s",
     };
 
     Text text_test_read_rate_value{
-        {240 - (test_read_rate_characters * 8), 15 * 16, (test_read_rate_characters * 8), 16},
+        {240 - (test_read_rate_characters * 8), 16 * 16, (test_read_rate_characters * 8), 16},
         "",
     };
 
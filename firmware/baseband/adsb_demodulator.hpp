@@ -0,0 +1,267 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __ADSB_DEMODULATOR_H__
+#define __ADSB_DEMODULATOR_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "dsp_types.hpp"
+#include "adsb_frame.hpp"
+
+namespace adsb {
+
+constexpr size_t long_frame_bits = 112;
+constexpr size_t parity_bits = 24;
+
+/* Syndrome left by a single bit error at each position of a long frame.
+ * Errors in the data bits leave the CRC of that bit alone, errors in the
+ * parity bits leave the bit itself. */
+constexpr std::array<uint32_t, long_frame_bits> make_single_bit_syndromes() {
+    std::array<uint32_t, long_frame_bits> syndromes{};
+    for (size_t bit = 0; bit < long_frame_bits - parity_bits; bit++) {
+        uint8_t data[11]{};
+        data[bit >> 3] = 0x80 >> (bit & 7);
+        syndromes[bit] = compute_crc(data, 11);
+    }
+    for (size_t bit = long_frame_bits - parity_bits; bit < long_frame_bits; bit++) {
+        syndromes[bit] = 1UL << (long_frame_bits - 1 - bit);
+    }
+    return syndromes;
+}
+
+inline constexpr std::array<uint32_t, long_frame_bits> single_bit_syndromes = make_single_bit_syndromes();
+
+/* Mode S demodulator for 2Msps complex8 baseband.
+ *
+ * One pulse = 500ns = 1 sample, one bit = 1us = 2 samples. Magnitudes go
+ * into a small circular buffer instead of being shifted along, and the
+ * adjacent-sample relations the preamble needs are kept as two running
+ * bitmasks, so each sample costs one packed mask compare until a candidate
+ * turns up.
+ *
+ * Bits whose two halves are close in level are remembered as weak. An
+ * extended squitter that fails its CRC is repaired if the syndrome points
+ * at a single weak bit.
+ */
+class ADSBDemodulator {
+   public:
+    struct Statistics {
+        uint32_t preambles{0};
+        uint32_t frames{0};
+        uint32_t corrected{0};
+        uint32_t rejected{0};
+    };
+
+    template <typename Callback>
+    void execute(const buffer_c8_t& buffer, Callback callback) {
+        for (size_t i = 0; i < buffer.count; i++) {
+            const int32_t re = buffer.p[i].real();
+            const int32_t im = buffer.p[i].imag();
+            const uint32_t mag = static_cast<uint32_t>(re * re + im * im);
+
+            const uint32_t prev_mag = mags[(head - 1) & mags_mask];
+            mags[head & mags_mask] = mag;
+            head++;
+
+            falls = (falls << 1) | ((prev_mag > mag) ? 1 : 0);
+            rises = (rises << 1) | ((prev_mag < mag) ? 1 : 0);
+
+            if (decoding) {
+                // The second sample of each bit completes it
+                if (sample_count & 1) {
+                    consume_bit(prev_mag, mag, callback);
+                }
+                sample_count++;
+            }
+
+            // Continue looking for preamble even if in a packet,
+            // switch if the new preamble is stronger.
+            if (((falls & falls_mask) == falls_mask) && ((rises & rises_mask) == rises_mask)) {
+                check_preamble();
+            }
+        }
+    }
+
+    void reset() {
+        decoding = false;
+        falls = 0;
+        rises = 0;
+        mags.fill(0);
+    }
+
+    const Statistics& statistics() const {
+        return stats;
+    }
+
+   private:
+    /* Preamble window of 17 samples, w[0] the oldest: pulses at w[1], w[3],
+     * w[8] and w[10], data starting at w[17]. Bit (16 - k) of falls is set
+     * when w[k - 1] > w[k], rises likewise for w[k - 1] < w[k]. */
+    static constexpr uint32_t rises_mask = (1UL << (16 - 1)) | (1UL << (16 - 3)) | (1UL << (16 - 10));
+    static constexpr uint32_t falls_mask = (1UL << (16 - 2)) | (1UL << (16 - 4)) | (1UL << (16 - 9)) | (1UL << (16 - 11));
+
+    static constexpr size_t mags_size = 32;
+    static constexpr size_t mags_mask = mags_size - 1;
+
+    std::array<uint32_t, mags_size> mags{};
+    size_t head{0};
+    uint32_t falls{0};
+    uint32_t rises{0};
+
+    ADSBFrame frame{};
+    bool decoding{false};
+    size_t sample_count{0};
+    size_t bit_count{0};
+    size_t msg_len{long_frame_bits};
+    uint8_t byte{0};
+    uint32_t amp{0};
+    std::array<uint8_t, long_frame_bits / 8> weak_bits{};
+
+    Statistics stats{};
+
+    uint32_t window(const size_t k) const {
+        return mags[(head - 17 + k) & mags_mask];
+    }
+
+    void check_preamble() {
+        const uint32_t w1 = window(1);
+        if ((window(4) >= w1) || (window(5) >= w1) || (window(6) >= w1) || (window(7) >= w1))
+            return;
+
+        // The samples between the two spikes must be < than the average
+        // of the high spikes level. We don't test bits too near to
+        // the high levels as signals can be out of phase so part of the
+        // energy can be in the near samples.
+        const uint32_t this_amp = w1 + window(3) + window(8) + window(10);
+        const uint32_t high = this_amp / 9;
+        if ((window(5) >= high) || (window(6) >= high) ||
+            // Similarly samples 12-14 must be low, as it is the space
+            // between the preamble and the data.
+            (window(12) >= high) || (window(13) >= high) || (window(14) >= high))
+            return;
+
+        if (!decoding || (this_amp > amp)) {
+            stats.preambles++;
+            decoding = true;
+            msg_len = long_frame_bits;
+            amp = this_amp;
+            sample_count = 0;
+            bit_count = 0;
+            weak_bits.fill(0);
+            frame.clear();
+        }
+    }
+
+    template <typename Callback>
+    void consume_bit(const uint32_t first, const uint32_t second, Callback& callback) {
+        const uint8_t bit = (first > second) ? 1 : 0;
+        const uint32_t delta = bit ? (first - second) : (second - first);
+        if (delta * 2 < first + second) {
+            weak_bits[bit_count >> 3] |= 0x80 >> (bit_count & 7);
+        }
+
+        byte = (byte << 1) | bit;
+        bit_count++;
+
+        if (bit_count & 7)
+            return;
+
+        frame.push_byte(byte);
+
+        if (bit_count == 8) {
+            const uint8_t df = byte >> 3;
+            // DFs 16 or greater are long 112. DFs 15 or less are short 56.
+            if (!(df & 0x10))
+                msg_len = 56;
+
+            // Abandon frames in formats nobody sends, most likely noise
+            if (!is_known_df(df)) {
+                decoding = false;
+                frame.clear();
+                return;
+            }
+        }
+
+        if (bit_count >= msg_len) {
+            decoding = false;
+            if (accept()) {
+                stats.frames++;
+                callback(frame, amp);
+            } else {
+                stats.rejected++;
+            }
+            frame.clear();
+        }
+    }
+
+    static bool is_known_df(const uint8_t df) {
+        switch (df) {
+            case 0:
+            case 4:
+            case 5:
+            case 11:
+            case 16:
+            case 17:
+            case 18:
+            case 20:
+            case 21:
+                return true;
+            default:
+                return df >= 24;
+        }
+    }
+
+    /* Only extended squitters and all-call replies can be checked here,
+     * the other formats overlay the sender's address on the parity and are
+     * resolved by the application against the aircraft it knows. */
+    bool accept() {
+        const uint8_t df = frame.get_DF();
+        if ((df == 17) || (df == 18))
+            return repair();
+        if (df == 11)
+            return frame.syndrome() < 0x80;  // Interrogator identifier in low bits
+        return true;
+    }
+
+    bool repair() {
+        const uint32_t syndrome = frame.syndrome();
+        if (syndrome == 0)
+            return true;
+
+        for (size_t bit = 0; bit < long_frame_bits; bit++) {
+            if (single_bit_syndromes[bit] == syndrome) {
+                if (!(weak_bits[bit >> 3] & (0x80 >> (bit & 7))))
+                    return false;
+                frame.flip_bit(bit);
+                stats.corrected++;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+} /* namespace adsb */
+
+#endif /*__ADSB_DEMODULATOR_H__*/
@@ -25,6 +25,7 @@
 #include "portapack_shared_memory.hpp"
 
 #include "audio_dma.hpp"
+#include "baseband_profiler.hpp"
 
 #include "message.hpp"
 
@@ -48,6 +49,7 @@ void AudioOutput::configure(
 
 void AudioOutput::write(
     const buffer_s16_t& audio) {
+    BasebandProfiler::Probe probe{BasebandProfiler::Stage::Audio};
     std::array<float, 32> audio_f;
     for (size_t i = 0; i < audio.count; i++) {
         audio_f[i] = audio.p[i] * ki;
@@ -60,6 +62,7 @@ void AudioOutput::write(
 
 void AudioOutput::write(
     const buffer_f32_t& audio) {
+    BasebandProfiler::Probe probe{BasebandProfiler::Stage::Audio};
     block_buffer.feed(
         audio,
         [this](const buffer_f32_t& buffer) {
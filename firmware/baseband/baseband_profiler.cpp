@@ -0,0 +1,116 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "baseband_profiler.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include <algorithm>
+
+BasebandProfiler::Stage BasebandProfiler::stage = BasebandProfiler::Stage::Other;
+uint32_t BasebandProfiler::stage_start = 0;
+std::array<uint32_t, BasebandProfiler::Stage::StageCount> BasebandProfiler::stage_cycles{};
+
+BasebandProfiler::Stage BasebandProfiler::switch_to(const Stage next) {
+    const uint32_t now = cycles();
+    stage_cycles[stage] += now - stage_start;
+    stage_start = now;
+
+    const auto previous = stage;
+    stage = next;
+    return previous;
+}
+
+void BasebandProfiler::begin() {
+    stage = Stage::Other;
+    execute_start = stage_start = cycles();
+}
+
+void BasebandProfiler::end(const buffer_c8_t& buffer) {
+    switch_to(Stage::Other);
+    const uint32_t elapsed = stage_start - execute_start;
+
+    if (buffer.sampling_rate) {
+        budget = static_cast<uint64_t>(buffer.count) * halGetCounterFrequency() / buffer.sampling_rate;
+    }
+
+    min_cycles = executes ? std::min(min_cycles, elapsed) : elapsed;
+    max_cycles = std::max(max_cycles, elapsed);
+    total_cycles += elapsed;
+    executes++;
+    if (budget) {
+        if (elapsed > budget) {
+            deadline_misses++;
+        }
+        const size_t bin = static_cast<uint64_t>(elapsed) * histogram_steps / budget;
+        auto& count = histogram[std::min(bin, histogram_bins - 1)];
+        if (count < UINT16_MAX) count++;
+    }
+
+    samples += buffer.count;
+    if (samples >= buffer.sampling_rate * report_interval) {
+        if (shared_memory.request_m4_performance_counter == SharedMemory::m4_performance_counter_profile) {
+            const BasebandProfileMessage message{capture()};
+            shared_memory.application_queue.push(message);
+        }
+        clear();
+    }
+}
+
+/* Upper edge of the histogram bin reaching the given share of executes. */
+uint32_t BasebandProfiler::percentile(const uint32_t permille) const {
+    const uint32_t target = (executes * permille + 999) / 1000;
+    uint32_t count = 0;
+    for (size_t bin = 0; bin < histogram.size(); bin++) {
+        count += histogram[bin];
+        if (count && (count >= target)) {
+            return std::min<uint32_t>(static_cast<uint64_t>(bin + 1) * budget / histogram_steps, max_cycles);
+        }
+    }
+    return max_cycles;
+}
+
+BasebandProfile BasebandProfiler::capture() {
+    BasebandProfile profile;
+    profile.budget_cycles = budget;
+    profile.executes = executes;
+    profile.deadline_misses = deadline_misses;
+    profile.min_cycles = min_cycles;
+    profile.avg_cycles = executes ? (total_cycles / executes) : 0;
+    profile.p99_cycles = percentile(990);
+    profile.max_cycles = max_cycles;
+    for (size_t n = 0; n < stage_cycles.size(); n++) {
+        profile.stage_cycles[n] = executes ? (stage_cycles[n] / executes) : 0;
+    }
+    return profile;
+}
+
+void BasebandProfiler::clear() {
+    samples = 0;
+    executes = 0;
+    deadline_misses = 0;
+    min_cycles = 0;
+    max_cycles = 0;
+    total_cycles = 0;
+    histogram.fill(0);
+    stage_cycles.fill(0);
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __BASEBAND_PROFILER_H__
+#define __BASEBAND_PROFILER_H__
+
+#include "ch.h"
+
+#include "dsp_types.hpp"
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Cycle accounting for the baseband thread, from the DWT cycle counter.
+ *
+ * BasebandThread times each execute() against the DMA period of the buffer
+ * it was given. Processors may mark out stages of their work with Probes;
+ * the cycles between two probe boundaries go to whichever stage was
+ * innermost, so nested probes do not count twice. Interrupts taken meanwhile
+ * are counted with the stage they interrupted.
+ *
+ * Reports go to the application once a second while it asks for them.
+ */
+class BasebandProfiler {
+   public:
+    using Stage = BasebandProfile::Stage;
+
+    class Probe {
+       public:
+        explicit Probe(const Stage stage)
+            : previous{switch_to(stage)} {
+        }
+
+        ~Probe() {
+            switch_to(previous);
+        }
+
+        Probe(const Probe&) = delete;
+        Probe& operator=(const Probe&) = delete;
+
+        /* Charges what follows to another stage until the next call or the
+         * end of the probe's scope. */
+        void next(const Stage stage) {
+            switch_to(stage);
+        }
+
+       private:
+        const Stage previous;
+    };
+
+    static uint32_t cycles() {
+        return halGetCounterValue();
+    }
+
+    void begin();
+    void end(const buffer_c8_t& buffer);
+
+   private:
+    static constexpr float report_interval{1.0f};
+
+    /* Execute times in 1/32ths of the budget, up to twice the budget. */
+    static constexpr size_t histogram_steps = 32;
+    static constexpr size_t histogram_bins = histogram_steps * 2;
+
+    static Stage stage;
+    static uint32_t stage_start;
+    static std::array<uint32_t, Stage::StageCount> stage_cycles;
+
+    uint32_t execute_start{0};
+    size_t samples{0};
+    uint32_t budget{0};
+    uint32_t executes{0};
+    uint32_t deadline_misses{0};
+    uint32_t min_cycles{0};
+    uint32_t max_cycles{0};
+    uint64_t total_cycles{0};
+    std::array<uint16_t, histogram_bins> histogram{};
+
+    static Stage switch_to(const Stage next);
+
+    uint32_t percentile(const uint32_t permille) const;
+    BasebandProfile capture();
+    void clear();
+};
+
+#endif /*__BASEBAND_PROFILER_H__*/
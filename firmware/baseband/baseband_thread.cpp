@@ -88,8 +88,13 @@ void BasebandThread::run() {
                 buffer_tmp.p, buffer_tmp.count, sampling_rate};
 
             if (baseband_processor) {
+                profiler.begin();
                 baseband_processor->execute(buffer);
+                profiler.end(buffer);
             }
+
+            // Wake the application for messages held back too long.
+            shared_memory.application_queue.flush();
         }
     }
 
@@ -25,6 +25,7 @@
 #include "thread_base.hpp"
 #include "message.hpp"
 #include "baseband_processor.hpp"
+#include "baseband_profiler.hpp"
 
 #include <ch.h>
 
@@ -56,6 +57,7 @@ class BasebandThread : public ThreadBase {
     BasebandProcessor* baseband_processor{nullptr};
     baseband::Direction _direction{baseband::Direction::Receive};
     uint32_t sampling_rate{0};
+    BasebandProfiler profiler{};
 
     void run() override;
 };
@@ -26,20 +26,31 @@
 #include "complex.hpp"
 
 #include "dsp_decimate.hpp"
+#include "dsp_fir_taps.hpp"
 
 #include <array>
+#include <type_traits>
 
-class ChannelDecimator {
+enum class ChannelDecimationFactor {
+    By2,
+    By4,
+    By8,
+    By16,
+    By32,
+};
+
+/* Stage stands in for the stages after the first. DecimateBy2CIC3 costs
+ * least, but droops and lets more alias in as the channel fills the output
+ * band. DecimateBy2Halfband stays flat to 0.2 of the output rate and keeps
+ * aliases 60dB down, for about twice the cycles. Only the chosen filter's
+ * state is kept.
+ */
+template <class Stage>
+class CascadeChannelDecimator {
    public:
-    enum class DecimationFactor {
-        By2,
-        By4,
-        By8,
-        By16,
-        By32,
-    };
-
-    constexpr ChannelDecimator(
+    using DecimationFactor = ChannelDecimationFactor;
+
+    constexpr CascadeChannelDecimator(
         const DecimationFactor decimation_factor,
         const bool fs_over_4_downconvert = true)
         : decimation_factor{decimation_factor},
@@ -61,14 +72,22 @@ class ChannelDecimator {
 
     dsp::decimate::TranslateByFSOver4AndDecimateBy2CIC3 translate{};
     dsp::decimate::Complex8DecimateBy2CIC3 cic_0{};
-    dsp::decimate::DecimateBy2CIC3 cic_1{};
-    dsp::decimate::DecimateBy2CIC3 cic_2{};
-    dsp::decimate::DecimateBy2CIC3 cic_3{};
-    dsp::decimate::DecimateBy2CIC3 cic_4{};
+    Stage stage_1{make_stage()};
+    Stage stage_2{make_stage()};
+    Stage stage_3{make_stage()};
+    Stage stage_4{make_stage()};
 
     DecimationFactor decimation_factor{DecimationFactor::By32};
     const bool fs_over_4_downconvert{true};
 
+    static constexpr Stage make_stage() {
+        if constexpr (std::is_same_v<Stage, dsp::decimate::DecimateBy2Halfband>) {
+            return Stage{taps_halfband_decim.taps};
+        } else {
+            return Stage{};
+        }
+    }
+
     buffer_c16_t execute_decimation(const buffer_c8_t& buffer);
 
     buffer_c16_t execute_stage_0(
@@ -76,4 +95,10 @@ class ChannelDecimator {
         const buffer_c16_t& work_baseband_buffer);
 };
 
+extern template class CascadeChannelDecimator<dsp::decimate::DecimateBy2CIC3>;
+extern template class CascadeChannelDecimator<dsp::decimate::DecimateBy2Halfband>;
+
+using ChannelDecimator = CascadeChannelDecimator<dsp::decimate::DecimateBy2CIC3>;
+using HalfbandChannelDecimator = CascadeChannelDecimator<dsp::decimate::DecimateBy2Halfband>;
+
 #endif /*__CHANNEL_DECIMATOR_H__*/
@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_CHANNELIZER_H__
+#define __DSP_CHANNELIZER_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+#include <type_traits>
+
+#include "dsp_types.hpp"
+#include "dsp_fft.hpp"
+#include "dsp_window.hpp"
+
+namespace dsp {
+namespace channelizer {
+
+/* Prototype low-pass for an M-channel filterbank: windowed sinc with
+ * cutoff fs / (2M), M * P taps, in Q15 scaled so the centre tap is ~1.0
+ * (DC gain M). */
+template <size_t M, size_t P>
+constexpr std::array<int16_t, M * P> make_prototype_taps() {
+    constexpr size_t L = M * P;
+    constexpr auto window = window_make_cosine_sum<L>(window_blackman_harris);
+
+    std::array<int16_t, L> taps{};
+    for (size_t n = 0; n < L; n++) {
+        const int64_t t = static_cast<int64_t>(n) - static_cast<int64_t>(L / 2);
+        double sinc = 1.0;
+        if (t != 0) {
+            // sin(pi * t / M) == cos(2 * pi * (2t - M) / 4M)
+            const int64_t k = ((2 * t - static_cast<int64_t>(M)) % static_cast<int64_t>(4 * M) + 4 * M) % (4 * M);
+            const double s = window_cos_2pi(static_cast<size_t>(k), 4 * M);
+            sinc = s / (3.14159265358979323846 * t / M);
+        }
+        const double w = window[(n <= L / 2) ? n : (L - n)] / 32767.0;
+        const double q = sinc * w * 32767.0;
+        taps[n] = static_cast<int16_t>((q < 0.0) ? (q - 0.5) : (q + 0.5));
+    }
+    return taps;
+}
+
+/* Critically sampled polyphase analysis filterbank. Splits an input stream
+ * at fs into M channels at fs / M. Channel k is centred on k * fs / M
+ * (channels above M/2 are the negative frequencies). Each block of M
+ * input samples costs P complex MACs per sample plus one M-point FFT.
+ */
+template <size_t M, size_t P>
+class PolyphaseChannelizer {
+   public:
+    static_assert(power_of_two(M) && (M >= 4), "channel count must be a power of two >= 4");
+
+    static constexpr size_t channel_count = M;
+    static constexpr size_t taps_per_branch = P;
+
+    using taps_t = std::array<int16_t, M * P>;
+
+    constexpr PolyphaseChannelizer(const taps_t& taps = default_taps)
+        : taps_{taps} {
+    }
+
+    /* Output is written channel after channel into dst, which needs room
+     * for src.count samples (src.count / M per channel). Afterwards
+     * consumer(k, channel_buffer) is called for each channel k. */
+    template <typename T, typename Consumer>
+    void execute(const buffer_t<T>& src, const buffer_c16_t& dst, Consumer consumer) {
+        /* Full-scale complex8 input maps to full-scale complex16 output. */
+        constexpr float input_gain = std::is_same<T, complex8_t>::value ? 256.0f : 1.0f;
+        constexpr float scale = input_gain / (32768.0f * M);
+
+        const size_t blocks = src.count / M;
+
+        for (size_t b = 0; b < blocks; b++) {
+            const auto* const in = &src.p[b * M];
+            auto& row = history[phase];
+            for (size_t t = 0; t < M; t++) {
+                row[t] = {static_cast<int16_t>(in[t].real()), static_cast<int16_t>(in[t].imag())};
+            }
+
+            /* Branch p sees inputs x[nM - p], i.e. element M-1-p of each
+             * block, filtered by taps p, p + M, p + 2M, ... */
+            std::array<int32_t, M> acc_re{};
+            std::array<int32_t, M> acc_im{};
+            size_t row_index = phase;
+            for (size_t q = 0; q < P; q++) {
+                const auto& h = history[row_index];
+                const int16_t* const tap = &taps_[q * M];
+                for (size_t p = 0; p < M; p++) {
+                    const auto s = h[M - 1 - p];
+                    acc_re[p] += s.real() * tap[p];
+                    acc_im[p] += s.imag() * tap[p];
+                }
+                row_index = (row_index == 0) ? (P - 1) : (row_index - 1);
+            }
+            phase = (phase + 1) % P;
+
+            for (size_t p = 0; p < M; p++) {
+                fft_data[bit_reverse(p)] = {acc_re[p] * scale, acc_im[p] * scale};
+            }
+            fft_c_preswapped_radix4(fft_data);
+
+            /* Forward FFT bin (M - k) mod M is channel k. */
+            for (size_t k = 0; k < M; k++) {
+                const auto v = fft_data[(M - k) & (M - 1)];
+                dst.p[k * blocks + b] = {saturate(v.real()), saturate(v.imag())};
+            }
+        }
+
+        for (size_t k = 0; k < M; k++) {
+            consumer(k, buffer_c16_t{&dst.p[k * blocks], blocks, static_cast<uint32_t>(src.sampling_rate / M), src.timestamp});
+        }
+    }
+
+   private:
+    static constexpr taps_t default_taps = make_prototype_taps<M, P>();
+
+    const taps_t taps_;
+    std::array<std::array<complex16_t, M>, P> history{};
+    std::array<std::complex<float>, M> fft_data{};
+    size_t phase{0};
+
+    static constexpr size_t bit_reverse(const size_t x) {
+        size_t r = 0;
+        for (size_t b = 0; b < log_2(M); b++) {
+            if (x & (1 << b)) r |= 1 << (log_2(M) - 1 - b);
+        }
+        return r;
+    }
+
+    static int16_t saturate(const float v) {
+        return (v > 32767.0f) ? 32767 : ((v < -32768.0f) ? -32768 : static_cast<int16_t>(v));
+    }
+};
+
+} /* namespace channelizer */
+} /* namespace dsp */
+
+#endif /*__DSP_CHANNELIZER_H__*/
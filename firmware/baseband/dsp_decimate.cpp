@@ -26,373 +26,6 @@
 namespace dsp {
 namespace decimate {
 
-static inline complex32_t mac_fs4_shift(
-    const vec2_s16* const z,
-    const vec2_s16* const t,
-    const size_t index,
-    const complex32_t accum) {
-    /* Accumulate sample * tap results for samples already in z buffer.
-     * Multiply using swap/negation to achieve Fs/4 shift.
-     * For iterations where samples are shifting out of z buffer (being discarded).
-     * Expect negated tap t[2] to accomodate instruction set limitations.
-     */
-    const bool negated_t2 = index & 1;
-    const auto q1_i0 = z[index * 2 + 0];
-    const auto i1_q0 = z[index * 2 + 1];
-    const auto t1_t0 = t[index];
-    const auto real = negated_t2 ? smlsd(q1_i0, t1_t0, accum.real()) : smlad(q1_i0, t1_t0, accum.real());
-    const auto imag = negated_t2 ? smlad(i1_q0, t1_t0, accum.imag()) : smlsd(i1_q0, t1_t0, accum.imag());
-    return {real, imag};
-}
-
-static inline complex32_t mac_shift(
-    const vec2_s16* const z,
-    const vec2_s16* const t,
-    const size_t index,
-    const complex32_t accum) {
-    /* Accumulate sample * tap results for samples already in z buffer.
-     * For iterations where samples are shifting out of z buffer (being discarded).
-     * real += i1 * t1 + i0 * t0
-     * imag += q1 * t1 + q0 * t0
-     */
-    const auto i1_i0 = z[index * 2 + 0];
-    const auto q1_q0 = z[index * 2 + 1];
-    const auto t1_t0 = t[index];
-    const auto real = smlad(i1_i0, t1_t0, accum.real());
-    const auto imag = smlad(q1_q0, t1_t0, accum.imag());
-    return {real, imag};
-}
-
-static inline complex32_t mac_fs4_shift_and_store(
-    vec2_s16* const z,
-    const vec2_s16* const t,
-    const size_t decimation_factor,
-    const size_t index,
-    const complex32_t accum) {
-    /* Accumulate sample * tap results for samples already in z buffer.
-     * Place new samples into z buffer.
-     * Expect negated tap t[2] to accomodate instruction set limitations.
-     */
-    const bool negated_t2 = index & 1;
-    const auto q1_i0 = z[decimation_factor + index * 2 + 0];
-    const auto i1_q0 = z[decimation_factor + index * 2 + 1];
-    const auto t1_t0 = t[decimation_factor / 2 + index];
-    z[index * 2 + 0] = q1_i0;
-    const auto real = negated_t2 ? smlsd(q1_i0, t1_t0, accum.real()) : smlad(q1_i0, t1_t0, accum.real());
-    z[index * 2 + 1] = i1_q0;
-    const auto imag = negated_t2 ? smlad(i1_q0, t1_t0, accum.imag()) : smlsd(i1_q0, t1_t0, accum.imag());
-    return {real, imag};
-}
-
-static inline complex32_t mac_shift_and_store(
-    vec2_s16* const z,
-    const vec2_s16* const t,
-    const size_t decimation_factor,
-    const size_t index,
-    const complex32_t accum) {
-    /* Accumulate sample * tap results for samples already in z buffer.
-     * Place new samples into z buffer.
-     * Expect negated tap t[2] to accomodate instruction set limitations.
-     */
-    const auto i1_i0 = z[decimation_factor + index * 2 + 0];
-    const auto q1_q0 = z[decimation_factor + index * 2 + 1];
-    const auto t1_t0 = t[decimation_factor / 2 + index];
-    z[index * 2 + 0] = i1_i0;
-    const auto real = smlad(i1_i0, t1_t0, accum.real());
-    z[index * 2 + 1] = q1_q0;
-    const auto imag = smlad(q1_q0, t1_t0, accum.imag());
-    return {real, imag};
-}
-
-static inline complex32_t mac_fs4_shift_and_store_new_c8_samples(
-    vec2_s16* const z,
-    const vec2_s16* const t,
-    const vec4_s8* const in,
-    const size_t decimation_factor,
-    const size_t index,
-    const size_t length,
-    const complex32_t accum) {
-    /* Accumulate sample * tap results for new samples.
-     * Place new samples into z buffer.
-     * Expect negated tap t[2] to accomodate instruction set limitations.
-     */
-    const bool negated_t2 = index & 1;
-    const auto q1_i1_q0_i0 = in[index];
-    const auto t1_t0 = t[(length - decimation_factor) / 2 + index];
-    const auto i1_q1_i0_q0 = rev16(q1_i1_q0_i0);
-    const auto i1_q1_q0_i0 = pkhbt(q1_i1_q0_i0, i1_q1_i0_q0);
-    const auto q1_i0 = sxtb16(i1_q1_q0_i0);
-    const auto i1_q0 = sxtb16(i1_q1_q0_i0, 8);
-    z[length - decimation_factor * 2 + index * 2 + 0] = q1_i0;
-    const auto real = negated_t2 ? smlsd(q1_i0, t1_t0, accum.real()) : smlad(q1_i0, t1_t0, accum.real());
-    z[length - decimation_factor * 2 + index * 2 + 1] = i1_q0;
-    const auto imag = negated_t2 ? smlad(i1_q0, t1_t0, accum.imag()) : smlsd(i1_q0, t1_t0, accum.imag());
-    return {real, imag};
-}
-
-static inline complex32_t mac_shift_and_store_new_c16_samples(
-    vec2_s16* const z,
-    const vec2_s16* const t,
-    const vec2_s16* const in,
-    const size_t decimation_factor,
-    const size_t index,
-    const size_t length,
-    const complex32_t accum) {
-    /* Accumulate sample * tap results for new samples.
-     * Place new samples into z buffer.
-     * Expect negated tap t[2] to accomodate instruction set limitations.
-     */
-    const auto q0_i0 = in[index * 2 + 0];
-    const auto q1_i1 = in[index * 2 + 1];
-    const auto i1_i0 = pkhbt(q0_i0, q1_i1, 16);
-    const auto q1_q0 = pkhtb(q1_i1, q0_i0, 16);
-    const auto t1_t0 = t[(length - decimation_factor) / 2 + index];
-    z[length - decimation_factor * 2 + index * 2 + 0] = i1_i0;
-    const auto real = smlad(i1_i0, t1_t0, accum.real());
-    z[length - decimation_factor * 2 + index * 2 + 1] = q1_q0;
-    const auto imag = smlad(q1_q0, t1_t0, accum.imag());
-    return {real, imag};
-}
-
-static inline uint32_t scale_round_and_pack(
-    const complex32_t value,
-    const int32_t scale_factor) {
-    /* Multiply 32-bit components of the complex<int32_t> by a scale factor,
-     * into int64_ts, then round to nearest LSB (1 << 32), saturate to 16 bits,
-     * and pack into a complex<int16_t>.
-     */
-    const auto scaled_real = __SMMULR(value.real(), scale_factor);
-    const auto saturated_real = __SSAT(scaled_real, 16);
-
-    const auto scaled_imag = __SMMULR(value.imag(), scale_factor);
-    const auto saturated_imag = __SSAT(scaled_imag, 16);
-
-    return __PKHBT(saturated_real, saturated_imag, 16);
-}
-
-template <typename Tap>
-static void taps_copy(
-    const Tap* const source,
-    Tap* const target,
-    const size_t count,
-    const bool shift_up) {
-    const uint32_t negate_pattern = shift_up ? 0b1110 : 0b0100;
-    for (size_t i = 0; i < count; i++) {
-        const bool negate = (negate_pattern >> (i & 3)) & 1;
-        target[i] = negate ? -source[i] : source[i];
-    }
-}
-
-// FIRC8xR16x24FS4Decim4 //////////////////////////////////////////////////
-
-void FIRC8xR16x24FS4Decim4::configure(
-    const std::array<tap_t, taps_count>& taps,
-    const int32_t scale,
-    const Shift shift) {
-    taps_copy(taps.data(), taps_.data(), taps_.size(), shift == Shift::Up);
-    output_scale = scale;
-    z_.fill({});
-}
-
-buffer_c16_t FIRC8xR16x24FS4Decim4::execute(
-    const buffer_c8_t& src,
-    const buffer_c16_t& dst) {
-    vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
-    const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
-    uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
-
-    const auto k = output_scale;
-
-    const size_t count = src.count / decimation_factor;
-    for (size_t i = 0; i < count; i++) {
-        const vec4_s8* const in = static_cast<const vec4_s8*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
-
-        complex32_t accum;
-
-        // Oldest samples are discarded.
-        accum = mac_fs4_shift(z, t, 0, accum);
-        accum = mac_fs4_shift(z, t, 1, accum);
-
-        // Middle samples are shifted earlier in the "z" delay buffer.
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 0, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 1, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 2, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 3, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 4, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 5, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 6, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 7, accum);
-
-        // Newest samples come from "in" buffer, are copied to "z" delay buffer.
-        accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 0, taps_count, accum);
-        accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 1, taps_count, accum);
-
-        d[i] = scale_round_and_pack(accum, k);
-    }
-
-    return {
-        dst.p,
-        count,
-        src.sampling_rate / decimation_factor};
-}
-
-// FIRC8xR16x24FS4Decim8 //////////////////////////////////////////////////
-
-void FIRC8xR16x24FS4Decim8::configure(
-    const std::array<tap_t, taps_count>& taps,
-    const int32_t scale,
-    const Shift shift) {
-    taps_copy(taps.data(), taps_.data(), taps_.size(), shift == Shift::Up);
-    output_scale = scale;
-    z_.fill({});
-}
-
-buffer_c16_t FIRC8xR16x24FS4Decim8::execute(
-    const buffer_c8_t& src,
-    const buffer_c16_t& dst) {
-    vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
-    const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
-    uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
-
-    const auto k = output_scale;
-
-    const size_t count = src.count / decimation_factor;
-    for (size_t i = 0; i < count; i++) {
-        const vec4_s8* const in = static_cast<const vec4_s8*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
-
-        complex32_t accum;
-
-        // Oldest samples are discarded.
-        accum = mac_fs4_shift(z, t, 0, accum);
-        accum = mac_fs4_shift(z, t, 1, accum);
-        accum = mac_fs4_shift(z, t, 2, accum);
-        accum = mac_fs4_shift(z, t, 3, accum);
-
-        // Middle samples are shifted earlier in the "z" delay buffer.
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 0, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 1, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 2, accum);
-        accum = mac_fs4_shift_and_store(z, t, decimation_factor, 3, accum);
-
-        // Newest samples come from "in" buffer, are copied to "z" delay buffer.
-        accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 0, taps_count, accum);
-        accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 1, taps_count, accum);
-        accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 2, taps_count, accum);
-        accum = mac_fs4_shift_and_store_new_c8_samples(z, t, in, decimation_factor, 3, taps_count, accum);
-
-        d[i] = scale_round_and_pack(accum, k);
-    }
-
-    return {
-        dst.p,
-        count,
-        src.sampling_rate / decimation_factor};
-}
-
-// FIRC16xR16x16Decim2 ////////////////////////////////////////////////////
-
-void FIRC16xR16x16Decim2::configure(
-    const std::array<tap_t, taps_count>& taps,
-    const int32_t scale) {
-    std::copy(taps.cbegin(), taps.cend(), taps_.begin());
-    output_scale = scale;
-    z_.fill({});
-}
-
-buffer_c16_t FIRC16xR16x16Decim2::execute(
-    const buffer_c16_t& src,
-    const buffer_c16_t& dst) {
-    vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
-    const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
-    uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
-
-    const auto k = output_scale;
-
-    const size_t count = src.count / decimation_factor;
-    for (size_t i = 0; i < count; i++) {
-        const vec2_s16* const in = static_cast<const vec2_s16*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
-
-        complex32_t accum;
-
-        // Oldest samples are discarded.
-        accum = mac_shift(z, t, 0, accum);
-
-        // Middle samples are shifted earlier in the "z" delay buffer.
-        accum = mac_shift_and_store(z, t, decimation_factor, 0, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 1, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 2, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 3, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 4, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 5, accum);
-
-        // Newest samples come from "in" buffer, are copied to "z" delay buffer.
-        accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 0, taps_count, accum);
-
-        d[i] = scale_round_and_pack(accum, k);
-    }
-
-    return {
-        dst.p,
-        count,
-        src.sampling_rate / decimation_factor};
-}
-
-// FIRC16xR16x32Decim8 ////////////////////////////////////////////////////
-
-void FIRC16xR16x32Decim8::configure(
-    const std::array<tap_t, taps_count>& taps,
-    const int32_t scale) {
-    std::copy(taps.cbegin(), taps.cend(), taps_.begin());
-    output_scale = scale;
-    z_.fill({});
-}
-
-buffer_c16_t FIRC16xR16x32Decim8::execute(
-    const buffer_c16_t& src,
-    const buffer_c16_t& dst) {
-    vec2_s16* const z = static_cast<vec2_s16*>(__builtin_assume_aligned(z_.data(), 4));
-    const vec2_s16* const t = static_cast<vec2_s16*>(__builtin_assume_aligned(taps_.data(), 4));
-    uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
-
-    const auto k = output_scale;
-
-    const size_t count = src.count / decimation_factor;
-    for (size_t i = 0; i < count; i++) {
-        const vec2_s16* const in = static_cast<const vec2_s16*>(__builtin_assume_aligned(&src.p[i * decimation_factor], 4));
-
-        complex32_t accum;
-
-        // Oldest samples are discarded.
-        accum = mac_shift(z, t, 0, accum);
-        accum = mac_shift(z, t, 1, accum);
-        accum = mac_shift(z, t, 2, accum);
-        accum = mac_shift(z, t, 3, accum);
-
-        // Middle samples are shifted earlier in the "z" delay buffer.
-        accum = mac_shift_and_store(z, t, decimation_factor, 0, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 1, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 2, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 3, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 4, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 5, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 6, accum);
-        accum = mac_shift_and_store(z, t, decimation_factor, 7, accum);
-
-        // Newest samples come from "in" buffer, are copied to "z" delay buffer.
-        accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 0, taps_count, accum);
-        accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 1, taps_count, accum);
-        accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 2, taps_count, accum);
-        accum = mac_shift_and_store_new_c16_samples(z, t, in, decimation_factor, 3, taps_count, accum);
-
-        d[i] = scale_round_and_pack(accum, k);
-    }
-
-    return {
-        dst.p,
-        count,
-        src.sampling_rate / decimation_factor};
-}
-
 buffer_c16_t Complex8DecimateBy2CIC3::execute(const buffer_c8_t& src, const buffer_c16_t& dst) {
     /* Decimates by two using a non-recursive third-order CIC filter.
      */
@@ -585,6 +218,80 @@ buffer_c16_t DecimateBy2CIC3::execute(
     return {dst.p, src.count / 2, src.sampling_rate / 2};
 }
 
+buffer_c16_t DecimateBy2Halfband::execute(
+    const buffer_c16_t& src,
+    const buffer_c16_t& dst) {
+    /* y0 = (g2, g1) . (o[-5], o[-4]) + (g0, g0) . (o[-3], o[-2])
+     *    + (g1, g2) . (o[-1], o0) + c * e[-2]
+     * y1 = ( 0, g2) . (o[-5], o[-4]) + (g1, g0) . (o[-3], o[-2])
+     *    + (g0, g1) . (o[-1], o0) + g2 * o1 + c * e[-1]
+     * for odd samples o, even samples e, both channels alike.
+     * Consumes 16 bytes (4 s16:s16 samples) per loop iteration,
+     * Produces  8 bytes (2 s16:s16 samples) per loop iteration.
+     */
+    constexpr int32_t round = 1 << 14;
+
+    uint32_t ia = i_a;
+    uint32_t qa = q_a;
+    uint32_t ib = i_b;
+    uint32_t qb = q_b;
+    uint32_t o1 = odd_1;
+    uint32_t e2 = even_2;
+    uint32_t e1 = even_1;
+
+    void* s = src.p;
+    void* d = dst.p;
+    const auto d_end = &dst.p[src.count / 2];
+    while (d < d_end) {
+        const uint32_t e0 = *__SIMD32(s)++; /* Q:I even */
+        const uint32_t o0 = *__SIMD32(s)++; /* Q:I odd */
+        const uint32_t e_next = *__SIMD32(s)++;
+        const uint32_t o_next = *__SIMD32(s)++;
+
+        const uint32_t ic = __PKHBT(o1, o0, 16); /* I0:I[-1] */
+        const uint32_t qc = __PKHTB(o0, o1, 16); /* Q0:Q[-1] */
+
+        int32_t i = __SMLAD(ia, t_2_1, round);
+        int32_t q = __SMLAD(qa, t_2_1, round);
+        i = __SMLAD(ib, t_0_0, i);
+        q = __SMLAD(qb, t_0_0, q);
+        i = __SMLAD(ic, t_1_2, i);
+        q = __SMLAD(qc, t_1_2, q);
+        i = __SMLABB(e2, t_c, i);
+        q = __SMLATB(e2, t_c, q);
+        *__SIMD32(d)++ = __PKHBT(__SSAT(i >> 15, 16), __SSAT(q >> 15, 16), 16);
+
+        i = __SMLAD(ia, u_z_2, round);
+        q = __SMLAD(qa, u_z_2, round);
+        i = __SMLAD(ib, u_1_0, i);
+        q = __SMLAD(qb, u_1_0, q);
+        i = __SMLAD(ic, u_0_1, i);
+        q = __SMLAD(qc, u_0_1, q);
+        i = __SMLABB(o_next, t_2, i);
+        q = __SMLATB(o_next, t_2, q);
+        i = __SMLABB(e1, t_c, i);
+        q = __SMLATB(e1, t_c, q);
+        *__SIMD32(d)++ = __PKHBT(__SSAT(i >> 15, 16), __SSAT(q >> 15, 16), 16);
+
+        ia = ib;
+        qa = qb;
+        ib = ic;
+        qb = qc;
+        o1 = o_next;
+        e2 = e0;
+        e1 = e_next;
+    }
+    i_a = ia;
+    q_a = qa;
+    i_b = ib;
+    q_b = qb;
+    odd_1 = o1;
+    even_2 = e2;
+    even_1 = e1;
+
+    return {dst.p, src.count / 2, src.sampling_rate / 2};
+}
+
 void FIR64AndDecimateBy2Real::configure(
     const std::array<int16_t, taps_count>& new_taps) {
     std::copy(new_taps.cbegin(), new_taps.cend(), taps.begin());
@@ -638,7 +345,7 @@ buffer_c16_t FIRAndDecimateComplex::execute(
      * -> int16_t output, decimated by decimation_factor.
      * taps are normalized to 1 << 16 == 1.0.
      */
-    const auto output_sampling_rate = src.sampling_rate / decimation_factor_;
+    const auto output_sampling_rate = static_cast<uint32_t>(src.sampling_rate / decimation_factor_);
     const size_t output_samples = src.count / decimation_factor_;
 
     void* dst_p = dst.p;
@@ -26,6 +26,8 @@
 #include <array>
 #include <memory>
 #include <algorithm>
+#include <type_traits>
+#include <utility>
 
 #include "utility.hpp"
 
@@ -69,6 +71,59 @@ class DecimateBy2CIC3 {
     uint32_t _iq1{0};
 };
 
+/* Polyphase halfband decimating by two, for 11 taps h[0..10] where the
+ * centre is 0.5 and h[1], h[3], ... are zero. Only the three distinct
+ * odd-branch taps cost anything: every other input goes through six taps,
+ * the rest only feed the centre. Two outputs per loop, the second sees the
+ * same packed sample pairs as the first, one place along. Gain of 1, may
+ * work in place like DecimateBy2CIC3.
+ */
+class DecimateBy2Halfband {
+   public:
+    using taps_t = std::array<int16_t, 11>;
+
+    constexpr DecimateBy2Halfband(const taps_t& taps)
+        : t_2_1{pack(taps[0], taps[2])},
+          t_0_0{pack(taps[4], taps[6])},
+          t_1_2{pack(taps[8], taps[10])},
+          u_z_2{pack(0, taps[0])},
+          u_1_0{pack(taps[2], taps[4])},
+          u_0_1{pack(taps[6], taps[8])},
+          t_2{pack(taps[10], 0)},
+          t_c{pack(taps[5], 0)} {
+    }
+
+    buffer_c16_t execute(
+        const buffer_c16_t& src,
+        const buffer_c16_t& dst);
+
+   private:
+    static constexpr uint32_t pack(const int16_t lo, const int16_t hi) {
+        return static_cast<uint16_t>(lo) | (static_cast<uint32_t>(static_cast<uint16_t>(hi)) << 16);
+    }
+
+    /* Tap pairs, low half first: for the first output of each two, and
+     * for the second, whose window starts one odd sample later. */
+    const uint32_t t_2_1;
+    const uint32_t t_0_0;
+    const uint32_t t_1_2;
+    const uint32_t u_z_2;
+    const uint32_t u_1_0;
+    const uint32_t u_0_1;
+    const uint32_t t_2;
+    const uint32_t t_c;
+
+    /* Oldest four odd samples as I and Q pairs, the newest odd sample,
+     * and the two even samples still to reach the centre tap. */
+    uint32_t i_a{0};
+    uint32_t q_a{0};
+    uint32_t i_b{0};
+    uint32_t q_b{0};
+    uint32_t odd_1{0};
+    uint32_t even_2{0};
+    uint32_t even_1{0};
+};
+
 class FIR64AndDecimateBy2Real {
    public:
     static constexpr size_t taps_count = 64;
@@ -85,12 +140,32 @@ class FIR64AndDecimateBy2Real {
     std::array<int16_t, taps_count> taps{};
 };
 
-class FIRC8xR16x24FS4Decim4 {
+/* Decimating FIR with Taps real, symmetric taps, built at compile time for
+ * each input type, length and factor, so a new channel bandwidth is a new
+ * taps table in dsp_fir_taps.hpp rather than a new class.
+ *
+ * Samples are kept as packed pairs, I and Q apart, in a history written
+ * twice so the window is always one run. Symmetry lets each pair of taps
+ * serve the pair of samples at either end of the window: SMLAD for the
+ * front, SMLADX for the back, which sees them in reverse order. Half the
+ * taps are stored and loaded, and no sums need to fit in 16 bits, so
+ * complex16 input is as exact as complex8.
+ *
+ * With FsOver4, the taps are also moved to -fs/4 (Shift::Down) or +fs/4.
+ * The rotation of each sample depends only on its place in the window, so
+ * it costs no more than choosing between SMLAD and SMLSD, and accumulating
+ * the negative terms apart.
+ *
+ * Output is the accumulated sum times scale / 2^32, rounded and saturated
+ * to 16 bits.
+ */
+template <typename In, size_t Taps, size_t Decim, bool FsOver4>
+class FIRDecimator {
    public:
-    static constexpr size_t taps_count = 24;
-    static constexpr size_t decimation_factor = 4;
+    static constexpr size_t taps_count = Taps;
+    static constexpr size_t decimation_factor = Decim;
 
-    using sample_t = complex8_t;
+    using sample_t = In;
     using tap_t = int16_t;
 
     enum class Shift : bool {
@@ -101,90 +176,150 @@ class FIRC8xR16x24FS4Decim4 {
     void configure(
         const std::array<tap_t, taps_count>& taps,
         const int32_t scale,
-        const Shift shift = Shift::Down);
+        const Shift shift = Shift::Down) {
+        for (size_t j = 0; j < taps_.size(); j++) {
+            taps_[j] = {taps[j * 2 + 0], taps[j * 2 + 1]};
+        }
+        output_scale = scale;
+        shift_up = (shift == Shift::Up);
+        z_i.fill({});
+        z_q.fill({});
+        start = 0;
+    }
 
     buffer_c16_t execute(
-        const buffer_c8_t& src,
-        const buffer_c16_t& dst);
+        const buffer_t<sample_t>& src,
+        const buffer_c16_t& dst) {
+        return shift_up ? execute_shifted<true>(src, dst) : execute_shifted<false>(src, dst);
+    }
 
    private:
-    std::array<vec2_s16, taps_count - decimation_factor> z_{};
-    std::array<tap_t, taps_count> taps_{};
-    int32_t output_scale = 0;
-};
-
-class FIRC8xR16x24FS4Decim8 {
-   public:
-    static constexpr size_t taps_count = 24;
-    static constexpr size_t decimation_factor = 8;
-
-    using sample_t = complex8_t;
-    using tap_t = int16_t;
-
-    enum class Shift : bool {
-        Down = true,
-        Up = false
-    };
-
-    void configure(
-        const std::array<tap_t, taps_count>& taps,
-        const int32_t scale,
-        const Shift shift = Shift::Down);
+    static_assert(std::is_same<In, complex8_t>::value || std::is_same<In, complex16_t>::value, "input must be complex8 or complex16");
+    static_assert((Taps % 4) == 0, "taps must come in pairs of pairs");
+    static_assert(((Decim % 2) == 0) && ((Taps % Decim) == 0), "decimation must be even and divide the taps");
+    static_assert(!FsOver4 || ((Decim % 4) == 0), "fs/4 shift needs a decimation that is a multiple of 4");
 
-    buffer_c16_t execute(
-        const buffer_c8_t& src,
-        const buffer_c16_t& dst);
+    static constexpr size_t window_words = Taps / 2;
+    static constexpr size_t new_words = Decim / 2;
 
-   private:
-    std::array<vec2_s16, taps_count - decimation_factor> z_{};
-    std::array<tap_t, taps_count> taps_{};
-    int32_t output_scale = 0;
-};
+    /* Pairs of taps, oldest sample first. */
+    std::array<vec2_s16, Taps / 4> taps_{};
 
-class FIRC16xR16x16Decim2 {
-   public:
-    static constexpr size_t taps_count = 16;
-    static constexpr size_t decimation_factor = 2;
+    /* Pairs of samples, each written at n and n + window_words. */
+    std::array<vec2_s16, window_words * 2> z_i{};
+    std::array<vec2_s16, window_words * 2> z_q{};
+    size_t start{0};
 
-    using sample_t = complex16_t;
-    using tap_t = int16_t;
+    int32_t output_scale{0};
+    bool shift_up{false};
 
-    void configure(
-        const std::array<tap_t, taps_count>& taps,
-        const int32_t scale);
+    struct Accumulator {
+        int32_t plus{0};
+        int32_t minus{0};
+    };
 
-    buffer_c16_t execute(
-        const buffer_c16_t& src,
-        const buffer_c16_t& dst);
+    /* Sign of the I (Q) part of a sample at window position p, times
+     * 1, -j, -1, j moving down, 1, j, -1, -j moving up. Lanes are packed
+     * so the part itself is always the one in the lane. */
+    static constexpr int sign_i(const size_t p, const bool up) {
+        return !FsOver4 ? 1 : ((((p & 3) == 2) || ((p & 3) == (up ? 1 : 3))) ? -1 : 1);
+    }
 
-   private:
-    std::array<vec2_s16, taps_count - decimation_factor> z_{};
-    std::array<tap_t, taps_count> taps_{};
-    int32_t output_scale = 0;
-};
+    static constexpr int sign_q(const size_t p, const bool up) {
+        return sign_i(p, !up);
+    }
 
-class FIRC16xR16x32Decim8 {
-   public:
-    static constexpr size_t taps_count = 32;
-    static constexpr size_t decimation_factor = 8;
+    /* Pair of samples times a pair of taps, lane signs s0 and s1, straight
+     * or exchanged. */
+    template <int S0, int S1, bool Exchange>
+    static void mac(Accumulator& acc, const vec2_s16 x, const vec2_s16 t) {
+        int32_t& sum = (S0 > 0) ? acc.plus : acc.minus;
+        if (S0 == S1) {
+            sum = Exchange ? smladx(x, t, sum) : smlad(x, t, sum);
+        } else {
+            sum = Exchange ? smlsdx(x, t, sum) : smlsd(x, t, sum);
+        }
+    }
 
-    using sample_t = complex16_t;
-    using tap_t = int16_t;
+    template <bool Up, size_t J>
+    void mac_ends(const vec2_s16* const i, const vec2_s16* const q, Accumulator& acc_i, Accumulator& acc_q) const {
+        constexpr size_t front = J * 2;
+        constexpr size_t back = Taps - 2 - J * 2;
+        const auto t = taps_[J];
+        mac<sign_i(front, Up), sign_i(front + 1, Up), false>(acc_i, i[J], t);
+        mac<sign_q(front, Up), sign_q(front + 1, Up), false>(acc_q, q[J], t);
+        mac<sign_i(back, Up), sign_i(back + 1, Up), true>(acc_i, i[window_words - 1 - J], t);
+        mac<sign_q(back, Up), sign_q(back + 1, Up), true>(acc_q, q[window_words - 1 - J], t);
+    }
 
-    void configure(
-        const std::array<tap_t, taps_count>& taps,
-        const int32_t scale);
+    template <bool Up, size_t... J>
+    void mac_window(const vec2_s16* const i, const vec2_s16* const q, Accumulator& acc_i, Accumulator& acc_q, std::index_sequence<J...>) const {
+        (mac_ends<Up, J>(i, q, acc_i, acc_q), ...);
+    }
 
-    buffer_c16_t execute(
-        const buffer_c16_t& src,
-        const buffer_c16_t& dst);
+    /* Two samples as an I pair and a Q pair. With FsOver4 the second
+     * sample's parts trade places, its sign is left to the taps. */
+    static void load_pair(const sample_t* const in, vec2_s16& i, vec2_s16& q) {
+        if constexpr (std::is_same<In, complex8_t>::value) {
+            const auto q1_i1_q0_i0 = *static_cast<const vec4_s8*>(__builtin_assume_aligned(in, 4));
+            const auto i1_i0 = sxtb16(q1_i1_q0_i0);
+            const auto q1_q0 = sxtb16(q1_i1_q0_i0, 8);
+            i = FsOver4 ? pkhbt(i1_i0, q1_q0) : i1_i0;
+            q = FsOver4 ? pkhbt(q1_q0, i1_i0) : q1_q0;
+        } else {
+            const auto p = static_cast<const vec2_s16*>(__builtin_assume_aligned(in, 4));
+            const auto q0_i0 = p[0];
+            const auto q1_i1 = p[1];
+            if (FsOver4) {
+                i = pkhbt(q0_i0, q1_i1);
+                q = pkhtb(pkhbt(q1_i1, q1_i1, 16), q0_i0, 16);
+            } else {
+                i = pkhbt(q0_i0, q1_i1, 16);
+                q = pkhtb(q1_i1, q0_i0, 16);
+            }
+        }
+    }
 
-   private:
-    std::array<vec2_s16, taps_count - decimation_factor> z_{};
-    std::array<tap_t, taps_count> taps_{};
-    int32_t output_scale = 0;
+    template <bool Up>
+    buffer_c16_t execute_shifted(
+        const buffer_t<sample_t>& src,
+        const buffer_c16_t& dst) {
+        uint32_t* const d = static_cast<uint32_t*>(__builtin_assume_aligned(dst.p, 4));
+        const auto k = output_scale;
+
+        const size_t count = src.count / decimation_factor;
+        for (size_t n = 0; n < count; n++) {
+            const sample_t* const in = &src.p[n * decimation_factor];
+            for (size_t w = 0; w < new_words; w++) {
+                vec2_s16 i, q;
+                load_pair(&in[w * 2], i, q);
+                z_i[start + w] = z_i[start + w + window_words] = i;
+                z_q[start + w] = z_q[start + w + window_words] = q;
+            }
+            start += new_words;
+            if (start == window_words) start = 0;
+
+            Accumulator acc_i{};
+            Accumulator acc_q{};
+            mac_window<Up>(&z_i[start], &z_q[start], acc_i, acc_q, std::make_index_sequence<Taps / 4>{});
+
+            const auto real = __SSAT(__SMMULR(acc_i.plus - acc_i.minus, k), 16);
+            const auto imag = __SSAT(__SMMULR(acc_q.plus - acc_q.minus, k), 16);
+            d[n] = __PKHBT(real, imag, 16);
+        }
+
+        return {
+            dst.p,
+            count,
+            static_cast<uint32_t>(src.sampling_rate / decimation_factor)};
+    }
 };
 
+using FIRC8xR16x24FS4Decim4 = FIRDecimator<complex8_t, 24, 4, true>;
+using FIRC8xR16x24FS4Decim8 = FIRDecimator<complex8_t, 24, 8, true>;
+using FIRC16xR16x16Decim2 = FIRDecimator<complex16_t, 16, 2, false>;
+using FIRC16xR16x32Decim8 = FIRDecimator<complex16_t, 32, 8, false>;
+
 class FIRAndDecimateComplex {
    public:
     using sample_t = complex16_t;
@@ -27,6 +27,9 @@
 
 #include <hal.h>
 
+#include <algorithm>
+#include <iterator>
+
 namespace dsp {
 namespace demodulate {
 
@@ -82,9 +85,155 @@ static inline float angle_precise(const complex32_t t) {
     return atan2f(t.imag(), t.real());
 }
 
+/* The fixed-point angles below are Q29 radians, so +/-pi fits in 32 bits. */
+static constexpr int32_t q29_pi = 1686629713;
+static constexpr int32_t q29_pi_2 = 843314857;
+
+static inline uint32_t magnitude(const int32_t v) {
+    return (v < 0) ? 0U - static_cast<uint32_t>(v) : static_cast<uint32_t>(v);
+}
+
+/* Folds the angle of the first octant, atan(min / max), out to all four
+ * quadrants. */
+static inline int32_t angle_unfold(int32_t angle, const complex32_t t, const bool steep) {
+    if (steep) {
+        angle = q29_pi_2 - angle;
+    }
+    if (t.real() < 0) {
+        angle = q29_pi - angle;
+    }
+    return (t.imag() < 0) ? -angle : angle;
+}
+
+/* Minimax odd polynomial for atan() over [0, 1], good to 1.2e-5 radians.
+ * Both sides of the ratio are cut to 16 bits so one 32 bit UDIV does the
+ * division, which costs another 3e-5 at worst. */
+static inline int32_t angle_polynomial(const complex32_t t) {
+    constexpr int32_t c1 = 1073598282; /* Q30 */
+    constexpr int32_t c3 = -354661821;
+    constexpr int32_t c5 = 193443518;
+    constexpr int32_t c7 = -91434290;
+    constexpr int32_t c9 = 22381431;
+
+    const auto x = magnitude(t.real());
+    const auto y = magnitude(t.imag());
+    const bool steep = y > x;
+    const auto num = steep ? x : y;
+    const auto den = steep ? y : x;
+    if (den == 0) {
+        return 0;
+    }
+
+    const auto shift = __builtin_clz(den);
+    const uint32_t den_16 = (den << shift) >> 16;
+    const int32_t z = ((num << shift) / den_16) << 14; /* Q30 */
+    const int32_t z2 = __SMMULR(z, z) << 2;
+    int32_t p = c9;
+    p = c7 + (__SMMULR(p, z2) << 2);
+    p = c5 + (__SMMULR(p, z2) << 2);
+    p = c3 + (__SMMULR(p, z2) << 2);
+    p = c1 + (__SMMULR(p, z2) << 2);
+    return angle_unfold(__SMMULR(p, z) << 1, t, steep);
+}
+
+/* Vectoring CORDIC. The vector is first turned into the right half-plane and
+ * scaled to [2^28, 2^29) so the 1.65 gain cannot overflow. Sixteen turns
+ * leave at most atan(2^-15), 3e-5 radians. */
+static inline int32_t angle_cordic(const complex32_t t) {
+    static constexpr int32_t atan_table[] = {
+        421657428, 248918915, 131521918, 66762579, 33510843, 16771758, 8387925, 4194219,
+        2097141, 1048575, 524288, 262144, 131072, 65536, 32768, 16384};
+
+    const auto largest = std::max(magnitude(t.real()), magnitude(t.imag()));
+    if (largest == 0) {
+        return 0;
+    }
+    const int shift = __builtin_clz(largest) - 3;
+    int32_t x = (shift >= 0) ? (t.real() << shift) : (t.real() >> -shift);
+    int32_t y = (shift >= 0) ? (t.imag() << shift) : (t.imag() >> -shift);
+
+    int32_t angle = 0;
+    if (x < 0) {
+        const int32_t x0 = x;
+        if (y >= 0) {
+            x = y;
+            y = -x0;
+            angle = q29_pi_2;
+        } else {
+            x = -y;
+            y = x0;
+            angle = -q29_pi_2;
+        }
+    }
+    for (size_t i = 0; i < std::size(atan_table); i++) {
+        const int32_t x0 = x;
+        if (y > 0) {
+            x += y >> i;
+            y -= x0 >> i;
+            angle += atan_table[i];
+        } else {
+            x -= y >> i;
+            y += x0 >> i;
+            angle -= atan_table[i];
+        }
+    }
+    return angle;
+}
+
+/* Im(s * conj(z)) / |s|^2 is |z| / |s| * sin() of the step. */
+static inline float angle_quotient(const complex32_t t, const complex16_t::rep_type s) {
+    const uint32_t mag_sq = __SMUAD(s, s);
+    return mag_sq ? static_cast<float>(t.imag()) / static_cast<float>(mag_sq) : 0.0f;
+}
+
+struct AnglePrecise {
+    static constexpr float scale = 1.0f;
+    static float angle(const complex32_t t, const complex16_t::rep_type) {
+        return angle_precise(t);
+    }
+};
+
+struct AnglePolynomial {
+    static constexpr float scale = 1.0f / 536870912.0f;
+    static float angle(const complex32_t t, const complex16_t::rep_type) {
+        return angle_polynomial(t);
+    }
+};
+
+struct AngleCORDIC {
+    static constexpr float scale = 1.0f / 536870912.0f;
+    static float angle(const complex32_t t, const complex16_t::rep_type) {
+        return angle_cordic(t);
+    }
+};
+
+struct AngleQuotient {
+    static constexpr float scale = 1.0f;
+    static float angle(const complex32_t t, const complex16_t::rep_type s) {
+        return angle_quotient(t, s);
+    }
+};
+
 buffer_f32_t FM::execute(
     const buffer_c16_t& src,
     const buffer_f32_t& dst) {
+    switch (discriminator_) {
+        case Discriminator::Polynomial:
+            return execute_with<AnglePolynomial>(src, dst);
+        case Discriminator::CORDIC:
+            return execute_with<AngleCORDIC>(src, dst);
+        case Discriminator::Quotient:
+            return execute_with<AngleQuotient>(src, dst);
+        default:
+            return execute_with<AnglePrecise>(src, dst);
+    }
+}
+
+template <typename Angle>
+buffer_f32_t FM::execute_with(
+    const buffer_c16_t& src,
+    const buffer_f32_t& dst) {
+    const float k = kf * Angle::scale;
     auto z = z_;
 
     const void* src_p = src.p;
@@ -96,8 +245,8 @@ buffer_f32_t FM::execute(
         const auto t0 = multiply_conjugate_s16_s32(s0, z);
         const auto t1 = multiply_conjugate_s16_s32(s1, s0);
         z = s1;
-        *(dst_p++) = angle_precise(t0) * kf;
-        *(dst_p++) = angle_precise(t1) * kf;
+        *(dst_p++) = Angle::angle(t0, s0) * k;
+        *(dst_p++) = Angle::angle(t1, s1) * k;
     }
     z_ = z;
 
@@ -132,7 +281,10 @@ buffer_s16_t FM::execute(
     return {dst.p, src.count, src.sampling_rate};
 }
 
-void FM::configure(const float sampling_rate, const float deviation_hz) {
+void FM::configure(
+    const float sampling_rate,
+    const float deviation_hz,
+    const Discriminator discriminator) {
     /*
      * angle: -pi to pi. output range: -32768 to 32767.
      * Maximum delta-theta (output of atan2) at maximum deviation frequency:
@@ -140,6 +292,7 @@ void FM::configure(const float sampling_rate, const float deviation_hz) {
      */
     kf = static_cast<float>(1.0f / (2.0 * pi * deviation_hz / sampling_rate));
     ks16 = 32767.0f * kf;
+    discriminator_ = discriminator;
 }
 
 }  // namespace demodulate
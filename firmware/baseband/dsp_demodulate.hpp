@@ -49,6 +49,20 @@ class SSB {
 
 class FM {
    public:
+    /* How the float output turns each conjugate product into a phase step.
+     * Atan2f is exact. Polynomial and CORDIC are fixed-point arctangents,
+     * good to 3e-5 radians for a fraction of atan2f's cycles. Quotient
+     * divides the conjugate product's imaginary part by the squared
+     * magnitude, which gives sin() of the step, so it is only fit for steps
+     * well under a radian. The 16 bit output has its own approximation.
+     */
+    enum class Discriminator {
+        Atan2f,
+        Polynomial,
+        CORDIC,
+        Quotient,
+    };
+
     buffer_f32_t execute(
         const buffer_c16_t& src,
         const buffer_f32_t& dst);
@@ -57,12 +71,21 @@ class FM {
         const buffer_c16_t& src,
         const buffer_s16_t& dst);
 
-    void configure(const float sampling_rate, const float deviation_hz);
+    void configure(
+        const float sampling_rate,
+        const float deviation_hz,
+        const Discriminator discriminator = Discriminator::Atan2f);
 
    private:
     complex16_t::rep_type z_{0};
     float kf{0};
     float ks16{0};
+    Discriminator discriminator_{Discriminator::Atan2f};
+
+    template <typename Angle>
+    buffer_f32_t execute_with(
+        const buffer_c16_t& src,
+        const buffer_f32_t& dst);
 };
 
 } /* namespace demodulate */
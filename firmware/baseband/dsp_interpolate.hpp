@@ -0,0 +1,185 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_INTERPOLATE_H__
+#define __DSP_INTERPOLATE_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+#include "dsp_types.hpp"
+
+#include "simd.hpp"
+
+namespace dsp {
+namespace interpolate {
+
+/* Rational L/M resampler taking complex16 capture samples to complex8
+ * baseband, for 1 <= M <= L <= phases_max.
+ *
+ * The prototype low-pass is a Kaiser windowed sinc of L * taps_per_phase
+ * taps cut off at the input Nyquist rate, split into L phases. Each output
+ * costs taps_per_phase MACs on I and on Q, done two at a time with SMLAD
+ * on separate I and Q delay lines.
+ */
+class PolyphaseInterpolator {
+   public:
+    static constexpr size_t phases_max = 16;
+    static constexpr size_t taps_per_phase = 8;
+
+    void configure(const size_t interpolation, const size_t decimation) {
+        L = (interpolation < 1) ? 1 : ((interpolation > phases_max) ? phases_max : interpolation);
+        M = (decimation < 1) ? 1 : ((decimation > L) ? L : decimation);
+        design_taps();
+        reset();
+    }
+
+    void reset() {
+        history_i.fill(0);
+        history_q.fill(0);
+        head = 0;
+        phase = 0;
+    }
+
+    size_t interpolation() const {
+        return L;
+    }
+
+    size_t decimation() const {
+        return M;
+    }
+
+    /* Input samples the next execute() consumes for output_count outputs.
+     * Never more than output_count. */
+    size_t input_count(const size_t output_count) const {
+        return output_count ? ((phase + (output_count - 1) * M) / L) : 0;
+    }
+
+    void execute(const complex16_t* src, const buffer_c8_t& dst) {
+        for (size_t n = 0; n < dst.count; n++) {
+            while (phase >= L) {
+                push(*(src++));
+                phase -= L;
+            }
+            dst.p[n] = filter(taps[phase]);
+            phase += M;
+        }
+    }
+
+   private:
+    static_assert((taps_per_phase & (taps_per_phase - 1)) == 0, "taps per phase must be a power of two");
+
+    static constexpr float kaiser_beta = 4.5f;  // ~50dB stopband, below complex8 resolution
+
+    using phase_taps_t = std::array<vec2_s16, taps_per_phase / 2>;
+
+    /* Taps of each phase in delay line order, oldest sample first. */
+    std::array<phase_taps_t, phases_max> taps{};
+
+    /* Written twice, taps_per_phase apart, so the newest taps_per_phase
+     * samples always lie in one run starting at head. */
+    std::array<int16_t, taps_per_phase * 2> history_i{};
+    std::array<int16_t, taps_per_phase * 2> history_q{};
+    size_t head{0};
+
+    size_t L{1};
+    size_t M{1};
+    size_t phase{0};
+
+    void push(const complex16_t sample) {
+        history_i[head] = history_i[head + taps_per_phase] = sample.real();
+        history_q[head] = history_q[head + taps_per_phase] = sample.imag();
+        head = (head + 1) & (taps_per_phase - 1);
+    }
+
+    complex8_t filter(const phase_taps_t& h) const {
+        // Q15 taps, complex16 in, complex8 out
+        int32_t acc_i = 1 << 22;
+        int32_t acc_q = 1 << 22;
+        for (size_t k = 0; k < h.size(); k++) {
+            acc_i = smlad(h[k], load(&history_i[head + k * 2]), acc_i);
+            acc_q = smlad(h[k], load(&history_q[head + k * 2]), acc_q);
+        }
+        return {saturate(acc_i >> 23), saturate(acc_q >> 23)};
+    }
+
+    /* The M4 allows unaligned word loads, head moves a sample at a time. */
+    static vec2_s16 load(const int16_t* const p) {
+        vec2_s16 v;
+        memcpy(&v.w, p, sizeof(v.w));
+        return v;
+    }
+
+    static int8_t saturate(const int32_t v) {
+        return (v > 127) ? 127 : ((v < -128) ? -128 : v);
+    }
+
+    static float bessel_i0(const float x) {
+        float sum = 1.0f;
+        float term = 1.0f;
+        for (size_t k = 1; k < 16; k++) {
+            const float f = x / (2.0f * k);
+            term *= f * f;
+            sum += term;
+        }
+        return sum;
+    }
+
+    /* Phase p sees the newest sample through prototype tap p, the one
+     * before through tap p + L, and so on. Each phase is normalized to
+     * unity DC gain so a constant input comes out without ripple. */
+    void design_taps() {
+        const size_t length = L * taps_per_phase;
+        const float centre = length / 2;
+
+        for (size_t p = 0; p < L; p++) {
+            std::array<float, taps_per_phase> h{};
+            float sum = 0.0f;
+            for (size_t i = 0; i < taps_per_phase; i++) {
+                const float t = (p + i * L) - centre;
+                const float x = t / L;
+                const float sinc = (t == 0.0f) ? 1.0f : std::sin(pi * x) / (pi * x);
+                const float r = t / centre;
+                const float window = bessel_i0(kaiser_beta * std::sqrt(std::max(0.0f, 1.0f - r * r))) / bessel_i0(kaiser_beta);
+                h[i] = sinc * window;
+                sum += h[i];
+            }
+
+            for (size_t s = 0; s < taps_per_phase; s += 2) {
+                taps[p][s / 2] = {to_q15(h[taps_per_phase - 1 - s] / sum), to_q15(h[taps_per_phase - 2 - s] / sum)};
+            }
+        }
+    }
+
+    static int16_t to_q15(const float v) {
+        const float q = std::round(v * 32768.0f);
+        return (q > 32767.0f) ? 32767 : ((q < -32768.0f) ? -32768 : static_cast<int16_t>(q));
+    }
+};
+
+} /* namespace interpolate */
+} /* namespace dsp */
+
+#endif /*__DSP_INTERPOLATE_H__*/
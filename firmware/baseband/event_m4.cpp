@@ -103,6 +103,8 @@ void EventDispatcher::on_message(const Message* const message) {
         default:
             on_message_default(message);
             shared_memory.baseband_message = nullptr;
+            // Wake the application, it sleeps until the message is handled.
+            creg::m4txevent::assert_event();
             break;
     }
 }
@@ -28,11 +28,10 @@
 #include "rssi_thread.hpp"
 
 #include "adsb_frame.hpp"
+#include "adsb_demodulator.hpp"
 
 using namespace adsb;
 
-#define ADSB_PREAMBLE_LENGTH 16
-
 class ADSBRXProcessor : public BasebandProcessor {
    public:
     void execute(const buffer_c8_t& buffer) override;
@@ -45,19 +44,8 @@ class ADSBRXProcessor : public BasebandProcessor {
     BasebandThread baseband_thread{baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive};
     RSSIThread rssi_thread{NORMALPRIO + 10};
 
-    ADSBFrame frame{};
+    ADSBDemodulator demodulator{};
     bool configured{false};
-    uint32_t prev_mag{0};
-    size_t bit_count{0}, sample_count{0};
-    size_t msgLen{112};
-    uint32_t shifter[ADSB_PREAMBLE_LENGTH + 1];
-    bool decoding{};
-    bool preamble{}, active{};
-    uint16_t bit_pos{0};
-    uint8_t cur_bit{0};
-    uint32_t sample{0};
-    int32_t re{}, im{};
-    int32_t amp{0};
 };
 
 #endif
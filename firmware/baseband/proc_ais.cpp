@@ -24,24 +24,73 @@
 #include "portapack_shared_memory.hpp"
 
 #include "dsp_fir_taps.hpp"
+#include "sine_table.hpp"
 
 #include "event_m4.hpp"
 
 AISProcessor::AISProcessor() {
     decim_0.configure(taps_11k0_decim_0.taps, 33554432);
-    decim_1.configure(taps_11k0_decim_1.taps, 131072);
+    demod_a.configure();
+    demod_b.configure();
 }
 
 void AISProcessor::execute(const buffer_c8_t& buffer) {
     /* 2.4576MHz, 2048 samples */
 
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-    const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
-    const auto decimator_out = decim_1_out;
 
-    /* 38.4kHz, 32 samples */
-    feed_channel_stats(decimator_out);
+    /* 307.2kHz, 256 samples, both channels at +/-25kHz */
+    feed_channel_stats(decim_0_out);
+
+    mix(decim_0_out);
+
+    demod_a.execute({dst_a.data(), decim_0_out.count, decim_0_out.sampling_rate, decim_0_out.timestamp});
+    demod_b.execute({dst_b.data(), decim_0_out.count, decim_0_out.sampling_rate, decim_0_out.timestamp});
+}
+
+void AISProcessor::mix(const buffer_c16_t& src) {
+    /* A single oscillator at +25kHz shifts channel A up to DC, and its
+     * conjugate shifts channel B down. */
+    constexpr float frac_scale = 1.0f / (1 << 24);
+
+    for (size_t i = 0; i < src.count; i++) {
+        const size_t n_sin = mix_phase >> 24;
+        const size_t n_cos = (n_sin + sine_table_f32_period / 4) & (sine_table_f32_period - 1);
+        const float frac = (mix_phase & 0xffffff) * frac_scale;
+        const float sin_w = sine_table_f32[n_sin] + frac * (sine_table_f32[n_sin + 1] - sine_table_f32[n_sin]);
+        const float cos_w = sine_table_f32[n_cos] + frac * (sine_table_f32[n_cos + 1] - sine_table_f32[n_cos]);
+        mix_phase += mix_phase_inc;
+
+        const float re = src.p[i].real();
+        const float im = src.p[i].imag();
+        const float re_cos = re * cos_w;
+        const float im_sin = im * sin_w;
+        const float re_sin = re * sin_w;
+        const float im_cos = im * cos_w;
+
+        dst_a[i] = {
+            static_cast<int16_t>(__SSAT(static_cast<int32_t>(re_cos - im_sin), 16)),
+            static_cast<int16_t>(__SSAT(static_cast<int32_t>(re_sin + im_cos), 16))};
+        dst_b[i] = {
+            static_cast<int16_t>(__SSAT(static_cast<int32_t>(re_cos + im_sin), 16)),
+            static_cast<int16_t>(__SSAT(static_cast<int32_t>(im_cos - re_sin), 16))};
+    }
+}
 
+AISProcessor::Demodulator::Demodulator(
+    const ais::Channel channel)
+    : channel{channel} {
+}
+
+void AISProcessor::Demodulator::configure() {
+    decim_1.configure(taps_11k0_decim_1.taps, 131072);
+}
+
+void AISProcessor::Demodulator::execute(const buffer_c16_t& buffer) {
+    /* Decimates in place. */
+    const auto decimator_out = decim_1.execute(buffer, buffer);
+
+    /* 38.4kHz, 32 samples */
     for (size_t i = 0; i < decimator_out.count; i++) {
         if (mf.execute_once(decimator_out.p[i])) {
             clock_recovery(mf.get_output());
@@ -49,7 +98,7 @@ void AISProcessor::execute(const buffer_c8_t& buffer) {
     }
 }
 
-void AISProcessor::consume_symbol(
+void AISProcessor::Demodulator::consume_symbol(
     const float raw_symbol) {
     const uint_fast8_t sliced_symbol = (raw_symbol >= 0.0f) ? 1 : 0;
     const auto decoded_symbol = nrzi_decode(sliced_symbol);
@@ -57,9 +106,9 @@ void AISProcessor::consume_symbol(
     packet_builder.execute(decoded_symbol);
 }
 
-void AISProcessor::payload_handler(
+void AISProcessor::Demodulator::payload_handler(
     const baseband::Packet& packet) {
-    const AISPacketMessage message{packet};
+    const AISPacketMessage message{packet, channel};
     shared_memory.application_queue.push(message);
 }
 
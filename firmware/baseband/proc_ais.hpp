@@ -41,6 +41,7 @@
 #include <bitset>
 
 #include "ais_baseband.hpp"
+#include "ais_packet.hpp"
 
 class AISProcessor : public BasebandProcessor {
    public:
@@ -50,6 +51,42 @@ class AISProcessor : public BasebandProcessor {
 
    private:
     static constexpr size_t baseband_fs = 2457600;
+    static constexpr size_t decim_0_fs = baseband_fs / 8;
+
+    /* Channel A sits below the tuned frequency, channel B above it. */
+    static constexpr uint32_t mix_phase_inc = (static_cast<uint64_t>(baseband::ais::channel_offset) << 32) / decim_0_fs;
+
+    /* One complete receive chain per AIS channel, fed 38.4kHz baseband. */
+    class Demodulator {
+       public:
+        Demodulator(const ais::Channel channel);
+
+        void configure();
+        void execute(const buffer_c16_t& buffer);
+
+       private:
+        const ais::Channel channel;
+
+        dsp::decimate::FIRC16xR16x32Decim8 decim_1{};
+        dsp::matched_filter::MatchedFilter mf{baseband::ais::square_taps_38k4_1t_p, 2};
+
+        clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery{
+            19200,
+            9600,
+            {0.0555f},
+            [this](const float symbol) { this->consume_symbol(symbol); }};
+        symbol_coding::NRZIDecoder nrzi_decode{};
+        PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder{
+            {0b0101010101111110, 16, 1},
+            {0b111110, 6},
+            {0b01111110, 8},
+            [this](const baseband::Packet& packet) {
+                this->payload_handler(packet);
+            }};
+
+        void consume_symbol(const float symbol);
+        void payload_handler(const baseband::Packet& packet);
+    };
 
     BasebandThread baseband_thread{baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive};
     RSSIThread rssi_thread{NORMALPRIO + 10};
@@ -59,26 +96,16 @@ class AISProcessor : public BasebandProcessor {
         dst.data(),
         dst.size()};
 
+    std::array<complex16_t, 256> dst_a{};
+    std::array<complex16_t, 256> dst_b{};
+
     dsp::decimate::FIRC8xR16x24FS4Decim8 decim_0{};
-    dsp::decimate::FIRC16xR16x32Decim8 decim_1{};
-    dsp::matched_filter::MatchedFilter mf{baseband::ais::square_taps_38k4_1t_p, 2};
-
-    clock_recovery::ClockRecovery<clock_recovery::FixedErrorFilter> clock_recovery{
-        19200,
-        9600,
-        {0.0555f},
-        [this](const float symbol) { this->consume_symbol(symbol); }};
-    symbol_coding::NRZIDecoder nrzi_decode{};
-    PacketBuilder<BitPattern, BitPattern, BitPattern> packet_builder{
-        {0b0101010101111110, 16, 1},
-        {0b111110, 6},
-        {0b01111110, 8},
-        [this](const baseband::Packet& packet) {
-            this->payload_handler(packet);
-        }};
-
-    void consume_symbol(const float symbol);
-    void payload_handler(const baseband::Packet& packet);
+    uint32_t mix_phase{0};
+
+    Demodulator demod_a{ais::Channel::A};
+    Demodulator demod_b{ais::Channel::B};
+
+    void mix(const buffer_c16_t& src);
 };
 
 #endif /*__PROC_AIS_H__*/
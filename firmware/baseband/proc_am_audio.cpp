@@ -22,6 +22,7 @@
 #include "proc_am_audio.hpp"
 
 #include "audio_output.hpp"
+#include "baseband_profiler.hpp"
 
 #include "event_m4.hpp"
 
@@ -32,6 +33,7 @@ void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
+    BasebandProfiler::Probe probe{BasebandProfiler::Stage::Decimate};
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
     const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
 
@@ -43,6 +45,7 @@ void NarrowbandAMAudio::execute(const buffer_c8_t& buffer) {
     // TODO: Feed channel_stats post-decimation data?
     feed_channel_stats(channel_out);
 
+    probe.next(BasebandProfiler::Stage::Demodulate);
     auto audio = demodulate(channel_out);
     audio_compressor.execute_in_place(audio);
     audio_output.write(audio);
@@ -38,16 +38,21 @@ CaptureProcessor::CaptureProcessor() {
 void CaptureProcessor::execute(const buffer_c8_t& buffer) {
     /* 2.4576MHz, 2048 samples */
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
-    const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
+
+    // Plain C16 samples are decimated straight into the stream buffer.
+    const size_t decim_1_count = decim_0_out.count / decim_1.decimation_factor;
+    const size_t decim_1_bytes = decim_1_count * sizeof(complex16_t);
+    void* const reserved = (stream && (format == CaptureFormat::C16)) ? stream->reserve(decim_1_bytes) : nullptr;
+    const buffer_c16_t decim_1_dst = reserved ? buffer_c16_t{static_cast<complex16_t*>(reserved), decim_1_count} : dst_buffer;
+
+    const auto decim_1_out = decim_1.execute(decim_0_out, decim_1_dst);
     const auto& decimator_out = decim_1_out;
     const auto& channel = decimator_out;
 
-    if (stream) {
-        const size_t bytes_to_write = sizeof(*decimator_out.p) * decimator_out.count;
-        const size_t written = stream->write(decimator_out.p, bytes_to_write);
-        if (written != bytes_to_write) {
-            // TODO eventually report error somewhere
-        }
+    if (reserved) {
+        stream->commit(decim_1_bytes);
+    } else if (stream) {
+        write_stream(decimator_out);
     }
 
     feed_channel_stats(channel);
@@ -59,6 +64,34 @@ void CaptureProcessor::execute(const buffer_c8_t& buffer) {
     }
 }
 
+void CaptureProcessor::write_stream(const buffer_c16_t& samples) {
+    const void* data = samples.p;
+    size_t bytes_to_write = sizeof(*samples.p) * samples.count;
+
+    if (format == CaptureFormat::C16Z) {
+        // One block per buffer, compressed before it queues for the SD card
+        bytes_to_write = iq_codec::encode_block(samples.p, samples.count, encoded.data());
+        data = encoded.data();
+    } else if (format != CaptureFormat::C16) {
+        // Packed straight into the stream buffer when it has the room
+        bytes_to_write = samples.count * capture_sample_size(format);
+        const auto reserved = static_cast<uint8_t*>(stream->reserve(bytes_to_write));
+        if (reserved) {
+            capture_format::pack(format, samples.p, samples.count, reserved);
+            stream->commit(bytes_to_write);
+            return;
+        }
+        capture_format::pack(format, samples.p, samples.count, encoded.data());
+        data = encoded.data();
+    }
+
+    // A block cut short would leave the next C16Z header mid-payload, or
+    // split a packed sample and misframe every one after it.
+    if (!stream->write_whole(data, bytes_to_write)) {
+        // TODO eventually report error somewhere
+    }
+}
+
 void CaptureProcessor::on_message(const Message* const message) {
     switch (message->id) {
         case Message::ID::UpdateSpectrum:
@@ -98,6 +131,7 @@ void CaptureProcessor::samplerate_config(const SamplerateConfigMessage& message)
 
 void CaptureProcessor::capture_config(const CaptureConfigMessage& message) {
     if (message.config) {
+        format = message.config->format;
         stream = std::make_unique<StreamInput>(message.config);
     } else {
         stream.reset();
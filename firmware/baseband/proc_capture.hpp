@@ -32,6 +32,7 @@
 #include "spectrum_collector.hpp"
 
 #include "stream_input.hpp"
+#include "iq_codec.hpp"
 
 #include <array>
 #include <memory>
@@ -64,11 +65,15 @@ class CaptureProcessor : public BasebandProcessor {
     int32_t channel_filter_transition = 0;
 
     std::unique_ptr<StreamInput> stream{};
+    CaptureFormat format{CaptureFormat::C16};
+    // Compressed or packed samples, never larger than the C16 ones
+    std::array<uint8_t, iq_codec::max_encoded_size(512)> encoded{};
 
     SpectrumCollector channel_spectrum{};
     size_t spectrum_interval_samples = 0;
     size_t spectrum_samples = 0;
 
+    void write_stream(const buffer_c16_t& samples);
     void samplerate_config(const SamplerateConfigMessage& message);
     void capture_config(const CaptureConfigMessage& message);
 };
@@ -0,0 +1,54 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "proc_channelizer.hpp"
+
+#include "portapack_shared_memory.hpp"
+
+#include "event_m4.hpp"
+
+void ChannelizerProcessor::execute(const buffer_c8_t& buffer) {
+    /* 3.072MHz, 2048 samples in; channel_count channels of 384kHz,
+     * 256 samples each out. */
+
+    channelizer.execute(buffer, dst_buffer, [this](const size_t channel, const buffer_c16_t& data) {
+        this->consume_channel(channel, data);
+    });
+}
+
+void ChannelizerProcessor::consume_channel(const size_t channel, const buffer_c16_t& data) {
+    channel_stats[channel].feed(
+        data,
+        [this, channel](const ChannelStatistics& statistics) {
+            statistics_message.max_db[channel] = statistics.max_db;
+
+            /* All channels report on the same block; send once the last has. */
+            if (channel == channel_count - 1) {
+                shared_memory.application_queue.push(statistics_message);
+            }
+        });
+}
+
+int main() {
+    EventDispatcher event_dispatcher{std::make_unique<ChannelizerProcessor>()};
+    event_dispatcher.run();
+    return 0;
+}
@@ -0,0 +1,69 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __PROC_CHANNELIZER_H__
+#define __PROC_CHANNELIZER_H__
+
+#include "baseband_processor.hpp"
+#include "baseband_thread.hpp"
+#include "rssi_thread.hpp"
+
+#include "dsp_channelizer.hpp"
+#include "channel_stats_collector.hpp"
+
+#include "message.hpp"
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+/* Splits one capture into channel_count narrowband streams. Decoders that
+ * want several channels at once derive from this and override
+ * consume_channel(). By default each channel's peak level is reported.
+ */
+class ChannelizerProcessor : public BasebandProcessor {
+   public:
+    static constexpr size_t channel_count = MultiChannelStatisticsMessage::channel_count;
+
+    void execute(const buffer_c8_t& buffer) override;
+
+   protected:
+    /* Called once per DMA block for every channel, in channel order. */
+    virtual void consume_channel(const size_t channel, const buffer_c16_t& data);
+
+   private:
+    static constexpr size_t baseband_fs = 3072000;
+
+    BasebandThread baseband_thread{baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Receive};
+    RSSIThread rssi_thread{NORMALPRIO + 10};
+
+    std::array<complex16_t, 2048> dst{};
+    const buffer_c16_t dst_buffer{
+        dst.data(),
+        dst.size()};
+
+    dsp::channelizer::PolyphaseChannelizer<channel_count, 8> channelizer{};
+
+    std::array<ChannelStatsCollector, channel_count> channel_stats{};
+    MultiChannelStatisticsMessage statistics_message{};
+};
+
+#endif /*__PROC_CHANNELIZER_H__*/
@@ -23,6 +23,7 @@
 #include "proc_nfm_audio.hpp"
 #include "sine_table_int8.hpp"
 #include "portapack_shared_memory.hpp"
+#include "baseband_profiler.hpp"
 
 #include "event_m4.hpp"
 
@@ -36,6 +37,7 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
+    BasebandProfiler::Probe probe{BasebandProfiler::Stage::Decimate};
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
     const auto decim_1_out = decim_1.execute(decim_0_out, dst_buffer);
 
@@ -45,6 +47,7 @@ void NarrowbandFMAudio::execute(const buffer_c8_t& buffer) {
 
     feed_channel_stats(channel_out);
 
+    probe.next(BasebandProfiler::Stage::Demodulate);
     if (!pitch_rssi_enabled) {
         // Normal mode, output demodulated audio
         auto audio = demod.execute(channel_out, audio_buffer);
@@ -143,7 +146,7 @@ void NarrowbandFMAudio::configure(const NBFMConfigureMessage& message) {
     decim_0.configure(message.decim_0_filter.taps, 33554432);
     decim_1.configure(message.decim_1_filter.taps, 131072);
     channel_filter.configure(message.channel_filter.taps, message.channel_decimation);
-    demod.configure(demod_input_fs, message.deviation);
+    demod.configure(demod_input_fs, message.deviation, dsp::demodulate::FM::Discriminator::Polynomial);
     channel_filter_low_f = message.channel_filter.low_frequency_normalized * channel_filter_input_fs;
     channel_filter_high_f = message.channel_filter.high_frequency_normalized * channel_filter_input_fs;
     channel_filter_transition = message.channel_filter.transition_normalized * channel_filter_input_fs;
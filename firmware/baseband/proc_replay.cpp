@@ -28,6 +28,9 @@
 
 #include "utility.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 ReplayProcessor::ReplayProcessor() {
     channel_filter_low_f = taps_200k_decim_1.low_frequency_normalized * 1000000;
     channel_filter_high_f = taps_200k_decim_1.high_frequency_normalized * 1000000;
@@ -37,43 +40,55 @@ ReplayProcessor::ReplayProcessor() {
 
     channel_spectrum.set_decimation_factor(1);
 
+    // 500kHz captures at 4MHz until told otherwise.
+    interpolator.configure(8, 1);
+
     configured = false;
 }
 
 void ReplayProcessor::execute(const buffer_c8_t& buffer) {
-    /* 4MHz, 2048 samples */
-
     if (!configured) return;
 
-    // File data is in C16 format, we need C8
-    // File samplerate is 500kHz, we're at 4MHz
-    // iq_buffer can only be 512 C16 samples (RAM limitation)
-    // To fill up the 2048-sample C8 buffer, we need:
-    // 2048 samples * 2 bytes per sample = 4096 bytes
-    // Since we're oversampling by 4M/500k = 8, we only need 2048/8 = 256 samples from the file and duplicate them 8 times each
-    // So 256 * 4 bytes per sample (C16) = 1024 bytes from the file
-    if (stream) {
-        const size_t bytes_to_read = sizeof(*buffer.p) * 2 * (buffer.count / 8);  // *2 (C16), /8 (oversampling) should be == 1024
-        bytes_read += stream->read(iq_buffer.p, bytes_to_read);
-    }
+    // File data is in C16 format at the capture rate, interpolated up to
+    // the baseband rate. iq can only be 256 C16 samples (RAM
+    // limitation), the interpolator needs at most one input per output so
+    // the buffer is filled in runs of 256 output samples.
+    spectrum_samples += buffer.count;
+    const bool spectrum_due = spectrum_samples >= spectrum_interval_samples;
+    const uint32_t capture_fs = baseband_fs * interpolator.decimation() / interpolator.interpolation();
+
+    for (size_t offset = 0; offset < buffer.count; offset += iq.size()) {
+        const size_t count = std::min(iq.size(), buffer.count - offset);
+        const size_t iq_count = interpolator.input_count(count);
+        const size_t bytes_to_read = iq_count * sizeof(complex16_t);
+
+        size_t read = 0;
+        if (stream) {
+            read = stream->read(iq.data(), bytes_to_read);
+            if (read < bytes_to_read) {
+                // The application didn't read ahead far enough.
+                underruns++;
+            }
+            bytes_read += read;
+        }
+        if (read < bytes_to_read) {
+            memset(reinterpret_cast<uint8_t*>(iq.data()) + read, 0, bytes_to_read - read);
+        }
 
-    // Fill and "stretch"
-    for (size_t i = 0; i < buffer.count; i++) {
-        if (i & 3) {
-            buffer.p[i] = buffer.p[i - 1];
-        } else {
-            auto re_out = iq_buffer.p[i >> 3].real() >> 8;
-            auto im_out = iq_buffer.p[i >> 3].imag() >> 8;
-            buffer.p[i] = {(int8_t)re_out, (int8_t)im_out};
+        // Each run refills only the capture samples it reads, so those go to
+        // the spectrum as they come, at the capture rate.
+        if (spectrum_due) {
+            channel_spectrum.feed({iq.data(), iq_count, capture_fs}, channel_filter_low_f, channel_filter_high_f, channel_filter_transition);
         }
+
+        interpolator.execute(iq.data(), {&buffer.p[offset], count, buffer.sampling_rate});
     }
 
-    spectrum_samples += buffer.count;
-    if (spectrum_samples >= spectrum_interval_samples) {
+    if (spectrum_due) {
         spectrum_samples -= spectrum_interval_samples;
-        channel_spectrum.feed(iq_buffer, channel_filter_low_f, channel_filter_high_f, channel_filter_transition);
 
         txprogress_message.progress = bytes_read;  // Inform UI about progress
+        txprogress_message.underruns = underruns;
         txprogress_message.done = false;
         shared_memory.application_queue.push(txprogress_message);
     }
@@ -93,9 +108,14 @@ void ReplayProcessor::on_message(const Message* const message) {
         case Message::ID::ReplayConfig:
             configured = false;
             bytes_read = 0;
+            underruns = 0;
             replay_config(*reinterpret_cast<const ReplayConfigMessage*>(message));
             break;
 
+        case Message::ID::ReplayRateConfig:
+            replay_rate_config(*reinterpret_cast<const ReplayRateConfigMessage*>(message));
+            break;
+
         // App has prefilled the buffers, we're ready to go now
         case Message::ID::FIFOData:
             configured = true;
@@ -121,6 +141,12 @@ void ReplayProcessor::replay_config(const ReplayConfigMessage& message) {
     } else {
         stream.reset();
     }
+    interpolator.reset();
+}
+
+void ReplayProcessor::replay_rate_config(const ReplayRateConfigMessage& message) {
+    static_assert(ReplayRateConfigMessage::interpolation_max <= dsp::interpolate::PolyphaseInterpolator::phases_max, "interpolation out of range");
+    interpolator.configure(message.interpolation, message.decimation);
 }
 
 int main() {
@@ -26,6 +26,7 @@
 #include "baseband_processor.hpp"
 #include "baseband_thread.hpp"
 
+#include "dsp_interpolate.hpp"
 #include "spectrum_collector.hpp"
 
 #include "stream_output.hpp"
@@ -47,11 +48,10 @@ class ReplayProcessor : public BasebandProcessor {
 
     BasebandThread baseband_thread{baseband_fs, this, NORMALPRIO + 20, baseband::Direction::Transmit};
 
+    // Capture samples for up to iq.size() output samples at a time.
     std::array<complex16_t, 256> iq{};
-    const buffer_c16_t iq_buffer{
-        iq.data(),
-        iq.size(),
-        baseband_fs / 8};
+
+    dsp::interpolate::PolyphaseInterpolator interpolator{};
 
     int32_t channel_filter_low_f = 0;
     int32_t channel_filter_high_f = 0;
@@ -65,9 +65,11 @@ class ReplayProcessor : public BasebandProcessor {
 
     bool configured{false};
     uint32_t bytes_read{0};
+    uint32_t underruns{0};
 
     void samplerate_config(const SamplerateConfigMessage& message);
     void replay_config(const ReplayConfigMessage& message);
+    void replay_rate_config(const ReplayRateConfigMessage& message);
 
     TXProgressMessage txprogress_message{};
     RequestSignalMessage sig_message{RequestSignalMessage::Signal::FillRequest};
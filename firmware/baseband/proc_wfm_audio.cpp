@@ -24,6 +24,7 @@
 
 #include "portapack_shared_memory.hpp"
 #include "audio_output.hpp"
+#include "baseband_profiler.hpp"
 #include "dsp_fft.hpp"
 #include "event_m4.hpp"
 
@@ -34,6 +35,7 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
         return;
     }
 
+    BasebandProfiler::Probe probe{BasebandProfiler::Stage::Decimate};
     const auto decim_0_out = decim_0.execute(buffer, dst_buffer);
     const auto channel = decim_1.execute(decim_0_out, dst_buffer);
 
@@ -46,6 +48,8 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
         channel_spectrum.feed(channel, channel_filter_low_f, channel_filter_high_f, channel_filter_transition);
     }
 
+    probe.next(BasebandProfiler::Stage::Demodulate);
+
     /* 384kHz complex<int16_t>[256]
      * -> FM demodulation
      * -> 384kHz int16_t[256] */
@@ -55,6 +59,8 @@ void WidebandFMAudio::execute(const buffer_c8_t& buffer) {
 
     auto audio_oversampled = demod.execute(channel, work_audio_buffer);
 
+    probe.next(BasebandProfiler::Stage::Audio);
+
     /* 384kHz int16_t[256]
      * -> 4th order CIC decimation by 2, gain of 1
      * -> 192kHz int16_t[128] */
@@ -170,7 +176,7 @@ void WidebandFMAudio::configure(const WFMConfigureMessage& message) {
     channel_filter_low_f = message.decim_1_filter.low_frequency_normalized * decim_1_input_fs;
     channel_filter_high_f = message.decim_1_filter.high_frequency_normalized * decim_1_input_fs;
     channel_filter_transition = message.decim_1_filter.transition_normalized * decim_1_input_fs;
-    demod.configure(demod_input_fs, message.deviation);
+    demod.configure(demod_input_fs, message.deviation, dsp::demodulate::FM::Discriminator::Polynomial);
     audio_filter.configure(message.audio_filter.taps);
     audio_output.configure(message.audio_hpf_config, message.audio_deemph_config);
 
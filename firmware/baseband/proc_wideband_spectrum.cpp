@@ -39,8 +39,7 @@ void WidebandSpectrum::execute(const buffer_c8_t& buffer) {
     }
 
     for (size_t i = 0; i < spectrum.size(); i++) {
-        // TODO: Removed window-presum windowing, due to lack of available code RAM.
-        // TODO: Apply window to improve spectrum bin sidelobes.
+        // Windowing is applied by SpectrumCollector, while bit-reversing for the FFT.
         spectrum[i] += buffer.p[i + 0];
         spectrum[i] += buffer.p[i + 1024];
     }
@@ -73,6 +72,8 @@ void WidebandSpectrum::on_message(const Message* const msg) {
             trigger = message.trigger;
             baseband_thread.set_sampling_rate(baseband_fs);
             phase = 0;
+            // The app retunes between triggers, each feed stands alone.
+            channel_spectrum.set_continuous(false);
             configured = true;
             break;
 
@@ -25,6 +25,7 @@
 
 #include "utility.hpp"
 #include "event_m4.hpp"
+#include "baseband_profiler.hpp"
 #include "portapack_shared_memory.hpp"
 
 #include <algorithm>
@@ -44,7 +45,19 @@ void SpectrumCollector::on_message(const Message* const message) {
     }
 }
 
+static constexpr window_half_t<SpectrumCollector::fft_size> spectrum_window_hamming =
+    window_make_cosine_sum<SpectrumCollector::fft_size>(window_hamming);
+static constexpr window_half_t<SpectrumCollector::fft_size> spectrum_window_hann =
+    window_make_cosine_sum<SpectrumCollector::fft_size>(window_hann);
+static constexpr window_half_t<SpectrumCollector::fft_size> spectrum_window_blackman_harris =
+    window_make_cosine_sum<SpectrumCollector::fft_size>(window_blackman_harris);
+static constexpr window_half_t<SpectrumCollector::fft_size> spectrum_window_flat_top =
+    window_make_cosine_sum<SpectrumCollector::fft_size>(window_flat_top);
+
 void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message) {
+    set_window(message.window);
+    set_averaging(message.averaging, message.averaging_count);
+
     if (message.mode == SpectrumStreamingConfigMessage::Mode::Running) {
         start();
     } else {
@@ -52,6 +65,47 @@ void SpectrumCollector::set_state(const SpectrumStreamingConfigMessage& message)
     }
 }
 
+void SpectrumCollector::set_window(const SpectrumStreamingConfigMessage::Window window_type) {
+    using Window = SpectrumStreamingConfigMessage::Window;
+
+    /* Levels are corrected by each window's coherent gain, relative to
+     * Hamming, so switching windows does not shift the display. */
+    WindowCosineSum coefficients = window_hamming;
+    switch (window_type) {
+        case Window::None:
+            window = nullptr;
+            coefficients = {1.0, 0.0, 0.0, 0.0, 0.0};
+            break;
+
+        case Window::Hann:
+            window = &spectrum_window_hann;
+            coefficients = window_hann;
+            break;
+
+        case Window::BlackmanHarris:
+            window = &spectrum_window_blackman_harris;
+            coefficients = window_blackman_harris;
+            break;
+
+        case Window::FlatTop:
+            window = &spectrum_window_flat_top;
+            coefficients = window_flat_top;
+            break;
+
+        default:
+        case Window::Hamming:
+            window = &spectrum_window_hamming;
+            break;
+    }
+    window_gain = window_hamming.a0 / coefficients.a0;
+}
+
+void SpectrumCollector::set_averaging(const SpectrumStreamingConfigMessage::Averaging mode, const size_t count) {
+    averaging = mode;
+    averaging_count = (mode == SpectrumStreamingConfigMessage::Averaging::None) ? 1 : std::max<size_t>(count, 1);
+    averaged_frames = 0;
+}
+
 void SpectrumCollector::start() {
     streaming = true;
     ChannelSpectrumConfigMessage message{&fifo};
@@ -79,10 +133,15 @@ void SpectrumCollector::feed(
     const int32_t filter_high_frequency,
     const int32_t filter_transition) {
     // Called from baseband processing thread.
+    BasebandProfiler::Probe probe{BasebandProfiler::Stage::Spectrum};
     channel_filter_low_frequency = filter_low_frequency;
     channel_filter_high_frequency = filter_high_frequency;
     channel_filter_transition = filter_transition;
 
+    if (!continuous) {
+        segment_halves = 0;
+    }
+
     channel_spectrum_decimator.feed(
         channel,
         [this](const buffer_c16_t& data) {
@@ -92,62 +151,119 @@ void SpectrumCollector::feed(
 
 void SpectrumCollector::post_message(const buffer_c16_t& data) {
     // Called from baseband processing thread.
-    if (streaming && !channel_spectrum_request_update) {
-        fft_swap(data, channel_spectrum);
+    if (!streaming) return;
+
+    std::copy(segment.begin() + data.count, segment.end(), segment.begin());
+    std::copy(data.p, data.p + data.count, segment.end() - data.count);
+
+    /* Overlap only helps an average, and across a gap in the feed it would
+     * mix in data from before it. */
+    const bool overlap = continuous && (averaging != SpectrumStreamingConfigMessage::Averaging::None);
+    if (++segment_halves < (overlap ? 1 : 2)) {
+        return;
+    }
+    segment_halves = 0;
+
+    /* The FFT runs on the idle thread. A segment completing while it is
+     * still busy with the last one is skipped. */
+    if (!channel_spectrum_request_update) {
+        const buffer_c16_t segment_buffer{segment.data(), segment.size(), data.sampling_rate};
+        if (window) {
+            fft_swap(segment_buffer, channel_spectrum, *window);
+        } else {
+            fft_swap(segment_buffer, channel_spectrum);
+        }
         channel_spectrum_sampling_rate = data.sampling_rate;
         channel_spectrum_request_update = true;
         EventDispatcher::events_flag(EVT_MASK_SPECTRUM);
     }
 }
 
-template <typename T>
-static typename T::value_type spectrum_window_none(const T& s, const size_t i) {
-    constexpr size_t length = sizeof(s) / sizeof(s[0]);
-    static_assert(power_of_two(length), "Array length must be power of 2");
-    return s[i];
-};
-
-template <typename T>
-static typename T::value_type spectrum_window_hamming_3(const T& s, const size_t i) {
-    constexpr size_t length = sizeof(s) / sizeof(s[0]);
-    static_assert((length), "Array length must be power of 2");
-    constexpr size_t mask = length - 1;
-    // Three point Hamming window.
-    return s[i] * 0.54f + (s[(i - 1) & mask] + s[(i + 1) & mask]) * -0.23f;
-};
-
-template <typename T>
-static typename T::value_type spectrum_window_blackman_3(const T& s, const size_t i) {
-    constexpr size_t length = sizeof(s) / sizeof(s[0]);
-    static_assert(power_of_two(length), "Array length must be power of 2");
-    constexpr size_t mask = length - 1;
-    // Three term Blackman window.
-    constexpr float alpha = 0.42f;
-    constexpr float beta = 0.5f * 0.5f;
-    constexpr float gamma = 0.08f * 0.05f;
-    return s[i] * alpha - (s[(i - 1) & mask] + s[(i + 1) & mask]) * beta + (s[(i - 2) & mask] + s[(i + 2) & mask]) * gamma;
-};
+template <size_t N>
+static int spectrum_fft(std::array<complex16_t, N>& data) {
+    return fft_c_preswapped_q15(data);
+}
+
+template <size_t N>
+static int spectrum_fft(std::array<std::complex<float>, N>& data) {
+    fft_c_preswapped_radix4(data);
+    return 0;
+}
+
+void SpectrumCollector::accumulate(const size_t bin, const float mag2) {
+    using Averaging = SpectrumStreamingConfigMessage::Averaging;
+
+    if (averaged_frames == 0) {
+        accumulator[bin] = mag2;
+        return;
+    }
+
+    switch (averaging) {
+        case Averaging::Mean:
+            accumulator[bin] += mag2;
+            break;
+
+        case Averaging::MaxHold:
+            accumulator[bin] = std::max(accumulator[bin], mag2);
+            break;
+
+        case Averaging::MinHold:
+            accumulator[bin] = std::min(accumulator[bin], mag2);
+            break;
+
+        default:
+        case Averaging::None:
+            accumulator[bin] = mag2;
+            break;
+    }
+}
+
+void SpectrumCollector::accumulate_segment() {
+    const int exponent = spectrum_fft(channel_spectrum);
+
+    constexpr size_t fold = fft_size / std::tuple_size<decltype(ChannelSpectrum::db)>::value;
+    static_assert(fold >= 1, "FFT size must be at least the ChannelSpectrum bin count");
+    // Keep levels independent of the FFT size, window and block exponent.
+    const float sample_scale = window_gain * std::ldexp(1.0f, exponent) / (32768.0f * fold);
+
+    for (size_t i = 0; i < accumulator.size(); i++) {
+        float mag2 = 0.0f;
+        for (size_t n = i * fold; n < (i + 1) * fold; n++) {
+            const std::complex<float> sample = channel_spectrum[n];
+            mag2 = std::max(mag2, magnitude_squared(sample * sample_scale));
+        }
+        accumulate(i, mag2);
+    }
+    averaged_frames++;
+}
+
+/* Only a finished average/hold goes to the application. */
+void SpectrumCollector::publish() {
+    ChannelSpectrum spectrum;
+    spectrum.sampling_rate = channel_spectrum_sampling_rate;
+    spectrum.channel_filter_low_frequency = channel_filter_low_frequency;
+    spectrum.channel_filter_high_frequency = channel_filter_high_frequency;
+    spectrum.channel_filter_transition = channel_filter_transition;
+
+    const float mag2_scale = (averaging == SpectrumStreamingConfigMessage::Averaging::Mean) ? (1.0f / averaged_frames) : 1.0f;
+    for (size_t i = 0; i < spectrum.db.size(); i++) {
+        const float db = mag2_to_dbv_norm(accumulator[i] * mag2_scale);
+        constexpr float mag_scale = 5.0f;
+        const unsigned int v = (db * mag_scale) + 255.0f;
+        spectrum.db[i] = std::max(0U, std::min(255U, v));
+    }
+    fifo.in(spectrum);
+    averaged_frames = 0;
+}
 
 void SpectrumCollector::update() {
     // Called from idle thread (after EVT_MASK_SPECTRUM is flagged)
     if (streaming && channel_spectrum_request_update) {
         /* Decimated buffer is full. Compute spectrum. */
-        fft_c_preswapped(channel_spectrum, 0, 8);
-
-        ChannelSpectrum spectrum;
-        spectrum.sampling_rate = channel_spectrum_sampling_rate;
-        spectrum.channel_filter_low_frequency = channel_filter_low_frequency;
-        spectrum.channel_filter_high_frequency = channel_filter_high_frequency;
-        spectrum.channel_filter_transition = channel_filter_transition;
-        for (size_t i = 0; i < spectrum.db.size(); i++) {
-            const auto corrected_sample = spectrum_window_hamming_3(channel_spectrum, i);
-            const auto mag2 = magnitude_squared(corrected_sample * (1.0f / 32768.0f));
-            const float db = mag2_to_dbv_norm(mag2);
-            constexpr float mag_scale = 5.0f;
-            const unsigned int v = (db * mag_scale) + 255.0f;
-            spectrum.db[i] = std::max(0U, std::min(255U, v));
+        accumulate_segment();
+        if (averaged_frames >= averaging_count) {
+            publish();
         }
-        fifo.in(spectrum);
     }
 
     channel_spectrum_request_update = false;
@@ -29,6 +29,7 @@
 #include "complex.hpp"
 
 #include "block_decimator.hpp"
+#include "dsp_window.hpp"
 
 #include <cstdint>
 #include <array>
@@ -41,20 +42,51 @@ class SpectrumCollector {
 
     void set_decimation_factor(const size_t decimation_factor);
 
+    /* For processors whose feeds are not one continuous stream, such as
+     * a wideband sweep retuning between them. Segments then neither
+     * overlap nor span two feeds. */
+    void set_continuous(const bool new_continuous) {
+        continuous = new_continuous;
+    }
+
     void feed(
         const buffer_c16_t& channel,
         const int32_t filter_low_frequency,
         const int32_t filter_high_frequency,
         const int32_t filter_transition);
 
+    /* Any power of two from 256 to fft_max_size. Sizes above the
+     * ChannelSpectrum bin count are peak-folded down to it, trading RAM
+     * for a lower per-bin noise floor.
+     */
+    static constexpr size_t fft_size = 256;
+
+    /* complex16_t selects the block floating point Q15 FFT, at half the RAM
+     * of std::complex<float>, which selects the float radix-4 FFT.
+     */
+    using fft_sample_t = complex16_t;
+
    private:
-    BlockDecimator<complex16_t, 256> channel_spectrum_decimator{1};
+    /* While averaging, frames overlap by half: each half-block completes a
+     * segment with the half-block before it. Otherwise a segment takes
+     * two fresh half-blocks. */
+    BlockDecimator<complex16_t, fft_size / 2> channel_spectrum_decimator{1};
+    std::array<complex16_t, fft_size> segment{};
+    size_t segment_halves{0};
+    bool continuous{true};
     ChannelSpectrum fifo_data[1 << ChannelSpectrumConfigMessage::fifo_k]{};
     ChannelSpectrumFIFO fifo{fifo_data, ChannelSpectrumConfigMessage::fifo_k};
 
     volatile bool channel_spectrum_request_update{false};
     bool streaming{false};
-    std::array<std::complex<float>, 256> channel_spectrum{};
+    std::array<fft_sample_t, fft_size> channel_spectrum{};
+    const window_half_t<fft_size>* window{nullptr};
+    float window_gain{1.0f};
+
+    SpectrumStreamingConfigMessage::Averaging averaging{SpectrumStreamingConfigMessage::Averaging::None};
+    size_t averaging_count{1};
+    size_t averaged_frames{0};
+    std::array<float, std::tuple_size<decltype(ChannelSpectrum::db)>::value> accumulator{};
     uint32_t channel_spectrum_sampling_rate{0};
     int32_t channel_filter_low_frequency{0};
     int32_t channel_filter_high_frequency{0};
@@ -63,6 +95,12 @@ class SpectrumCollector {
     void post_message(const buffer_c16_t& data);
 
     void set_state(const SpectrumStreamingConfigMessage& message);
+    void set_window(const SpectrumStreamingConfigMessage::Window window_type);
+    void set_averaging(const SpectrumStreamingConfigMessage::Averaging mode, const size_t count);
+
+    void accumulate(const size_t bin, const float mag2);
+    void accumulate_segment();
+    void publish();
     void start();
     void stop();
 
@@ -55,16 +55,11 @@ size_t StreamInput::write(const void* const data, const size_t length) {
         written += active_buffer->write(&p[written], remaining);
 
         if (active_buffer->is_full()) {
-            if (!fifo_buffers_full.in(active_buffer)) {
-                // FIFO is full of buffers, there's no place for this one.
+            if (!submit_active_buffer()) {
                 // Bail out of the loop, and try submitting the buffer in the
                 // next pass.
-                // This should never happen if the number of buffers is less
-                // than the capacity of the FIFO.
                 break;
             }
-            active_buffer = nullptr;
-            creg::m4txevent::assert_event();
         }
     }
 
@@ -73,3 +68,46 @@ size_t StreamInput::write(const void* const data, const size_t length) {
 
     return written;
 }
+
+bool StreamInput::write_whole(const void* const data, const size_t length) {
+    // The M0 only ever adds empty buffers, so the room can only grow.
+    const size_t space = (active_buffer ? active_buffer->space() : 0) + fifo_buffers_empty.len() * config->write_size;
+    if (space < length) {
+        config->baseband_bytes_received += length;
+        config->baseband_bytes_dropped += length;
+        return false;
+    }
+    return write(data, length) == length;
+}
+
+void* StreamInput::reserve(const size_t length) {
+    if (!active_buffer && !fifo_buffers_empty.out(active_buffer)) {
+        return nullptr;
+    }
+    if (active_buffer->space() < length) {
+        return nullptr;
+    }
+    return active_buffer->tail();
+}
+
+void StreamInput::commit(const size_t length) {
+    active_buffer->commit(length);
+    config->baseband_bytes_received += length;
+
+    if (active_buffer->is_full()) {
+        // A full buffer that can't be submitted now goes on the next write.
+        submit_active_buffer();
+    }
+}
+
+bool StreamInput::submit_active_buffer() {
+    if (!fifo_buffers_full.in(active_buffer)) {
+        // FIFO is full of buffers, there's no place for this one.
+        // This should never happen if the number of buffers is less
+        // than the capacity of the FIFO.
+        return false;
+    }
+    active_buffer = nullptr;
+    creg::m4txevent::assert_event();
+    return true;
+}
@@ -41,6 +41,16 @@ class StreamInput {
 
     size_t write(const void* const data, const size_t length);
 
+    /* Writes all of length bytes, or drops all of them if the free buffers
+     * can't take them, so blocks never reach the stream cut short. */
+    bool write_whole(const void* const data, const size_t length);
+
+    /* Room for length bytes in the buffer being filled, so they can be
+     * produced in place instead of copied in by write(). nullptr if the
+     * buffer has less room left or no buffer is free. */
+    void* reserve(const size_t length);
+    void commit(const size_t length);
+
    private:
     static constexpr size_t buffer_count_max_log2 = 3;
     static constexpr size_t buffer_count_max = 1U << buffer_count_max_log2;
@@ -53,6 +63,8 @@ class StreamInput {
     StreamBuffer* active_buffer{nullptr};
     CaptureConfig* const config{nullptr};
     std::unique_ptr<uint8_t[]> data{};
+
+    bool submit_active_buffer();
 };
 
 #endif /*__STREAM_INPUT_H__*/
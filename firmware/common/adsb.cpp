@@ -185,36 +185,197 @@ void encode_frame_squawk(ADSBFrame& frame, const uint16_t squawk) {
     frame.make_CRC();
 }
 
-float cpr_mod(float a, float b) {
-    return a - (b * floor(a / b));
+bool has_address_parity(const uint8_t df) {
+    switch (df) {
+        case DF_SHORT_AIR_AIR:
+        case DF_SURV_ALT:
+        case DF_SURV_ID:
+        case DF_LONG_AIR_AIR:
+        case DF_COMMB_ALT:
+        case DF_EHS_SQUAWK:
+            return true;
+        default:
+            return df >= 24;  // Comm-D
+    }
 }
 
-int cpr_NL_precise(float lat) {
-    return (int)floor(2 * PI / acos(1 - ((1 - cos(PI / (2 * NZ))) / pow(cos(PI * lat / 180), 2))));
+uint32_t checked_ICAO_address(ADSBFrame& frame) {
+    const uint8_t df = frame.get_DF();
+    const uint32_t syndrome = frame.syndrome();
+
+    if ((df == DF_ADSB) || (df == DF_TISB)) {
+        return (syndrome == 0) ? frame.get_ICAO_address() : 0;
+    } else if (df == DF_ALL_CALL) {
+        // Interrogator identifier may be overlaid on the low 7 bits
+        return (syndrome < 0x80) ? frame.get_ICAO_address() : 0;
+    }
+    return 0;
 }
 
-int cpr_NL_approx(float lat) {
-    if (lat < 0)
-        lat = -lat;  // Symmetry
+// Gillham (Mode C) code, as the ABCD octal digits of a Mode A code, to
+// hundreds of feet. Same method as dump1090.
+static bool gillham_to_altitude(const uint16_t mode_a, int32_t& altitude) {
+    int32_t five_hundreds = 0;
+    int32_t one_hundreds = 0;
+
+    // D1 is never used for altitude, C bits must not all be zero
+    if ((mode_a & 0x8889) || ((mode_a & 0x00F0) == 0))
+        return false;
+
+    if (mode_a & 0x0010) one_hundreds ^= 0x007;  // C1
+    if (mode_a & 0x0020) one_hundreds ^= 0x003;  // C2
+    if (mode_a & 0x0040) one_hundreds ^= 0x001;  // C4
+
+    // Remove 7s from one_hundreds (make 7->5, and 5->7)
+    if ((one_hundreds & 5) == 5)
+        one_hundreds ^= 2;
+
+    // Check for invalid codes, only 1 to 5 are valid
+    if (one_hundreds > 5)
+        return false;
+
+    if (mode_a & 0x0002) five_hundreds ^= 0x0FF;  // D2
+    if (mode_a & 0x0004) five_hundreds ^= 0x07F;  // D4
+    if (mode_a & 0x1000) five_hundreds ^= 0x03F;  // A1
+    if (mode_a & 0x2000) five_hundreds ^= 0x01F;  // A2
+    if (mode_a & 0x4000) five_hundreds ^= 0x00F;  // A4
+    if (mode_a & 0x0100) five_hundreds ^= 0x007;  // B1
+    if (mode_a & 0x0200) five_hundreds ^= 0x003;  // B2
+    if (mode_a & 0x0400) five_hundreds ^= 0x001;  // B4
+
+    // Correct order of one_hundreds
+    if (five_hundreds & 1)
+        one_hundreds = 6 - one_hundreds;
+
+    const int32_t hundreds = (five_hundreds * 5) + one_hundreds - 13;
+    if (hundreds < -12)
+        return false;
+
+    altitude = hundreds * 100;
+    return true;
+}
+
+// C1 A1 C2 A2 C4 A4 X B1 D1 B2 D2 B4 D4 to xAAAxBBBxCCCxDDD
+static uint16_t id13_to_mode_a(const uint16_t id13) {
+    return ((id13 & 0x1000) ? 0x0010 : 0) |  // C1
+           ((id13 & 0x0800) ? 0x1000 : 0) |  // A1
+           ((id13 & 0x0400) ? 0x0020 : 0) |  // C2
+           ((id13 & 0x0200) ? 0x2000 : 0) |  // A2
+           ((id13 & 0x0100) ? 0x0040 : 0) |  // C4
+           ((id13 & 0x0080) ? 0x4000 : 0) |  // A4
+           ((id13 & 0x0020) ? 0x0100 : 0) |  // B1
+           ((id13 & 0x0010) ? 0x0001 : 0) |  // D1
+           ((id13 & 0x0008) ? 0x0200 : 0) |  // B2
+           ((id13 & 0x0004) ? 0x0002 : 0) |  // D2
+           ((id13 & 0x0002) ? 0x0400 : 0) |  // B4
+           ((id13 & 0x0001) ? 0x0004 : 0);   // D4
+}
+
+static uint16_t frame_field_13(ADSBFrame& frame) {
+    // Frame bits 20-32
+    const uint8_t* raw_data = frame.get_raw_data();
+    return ((raw_data[2] & 0x1F) << 8) | raw_data[3];
+}
+
+bool decode_frame_altitude(ADSBFrame& frame, int32_t& altitude) {
+    uint16_t ac13 = frame_field_13(frame);
+
+    const uint8_t df = frame.get_DF();
+    if ((df == DF_ADSB) || (df == DF_TISB)) {
+        // 12 bit code of airborne positions, the M bit left out
+        const uint8_t* raw_data = frame.get_raw_data();
+        const uint16_t ac12 = (raw_data[5] << 4) | (raw_data[6] >> 4);
+        ac13 = ((ac12 & 0x0FC0) << 1) | (ac12 & 0x003F);
+    }
+
+    if (!ac13 || (ac13 & 0x0040))  // Not available, or metric (M bit)
+        return false;
+
+    if (ac13 & 0x0010) {  // Q bit: 25ft increments
+        const int32_t n = ((ac13 & 0x1F80) >> 2) | ((ac13 & 0x0020) >> 1) | (ac13 & 0x000F);
+        altitude = (n * 25) - 1000;
+        return true;
+    }
+
+    return gillham_to_altitude(id13_to_mode_a(ac13), altitude);
+}
 
-    for (size_t c = 0; c < 58; c++) {
-        if (lat < adsb_lat_lut[c])
-            return 59 - c;
+uint16_t decode_frame_squawk(ADSBFrame& frame) {
+    const uint16_t mode_a = id13_to_mode_a(frame_field_13(frame));
+
+    // xAAAxBBBxCCCxDDD to AAABBBCCCDDD
+    return ((mode_a >> 3) & 0xE00) | ((mode_a >> 2) & 0x1C0) | ((mode_a >> 1) & 0x038) | (mode_a & 0x007);
+}
+
+void ICAOAddressSet::insert(const uint32_t address, const uint32_t now) {
+    if (!address)
+        return;
+
+    const size_t start = hash(address);
+    size_t victim = start;
+    uint32_t victim_age = 0;
+
+    for (size_t i = 0; i < probe_limit; i++) {
+        Slot& slot = slots[(start + i) & (capacity - 1)];
+        if (slot.address == address) {
+            slot.last_seen = now;
+            return;
+        }
+        if (!slot.address) {
+            // Nothing was ever stored further along
+            victim = (start + i) & (capacity - 1);
+            break;
+        }
+        const uint32_t age = now - slot.last_seen;
+        if (age >= victim_age) {
+            victim = (start + i) & (capacity - 1);
+            victim_age = age;
+        }
+    }
+
+    slots[victim] = {address, now};
+}
+
+bool ICAOAddressSet::contains(const uint32_t address, const uint32_t now) const {
+    if (!address)
+        return false;
+
+    const size_t start = hash(address);
+    for (size_t i = 0; i < probe_limit; i++) {
+        const Slot& slot = slots[(start + i) & (capacity - 1)];
+        if (slot.address == address)
+            return (now - slot.last_seen) <= max_age;
+        if (!slot.address)
+            break;
     }
+    return false;
+}
 
-    return 1;
+void ICAOAddressSet::clear() {
+    slots.fill({0, 0});
+}
+
+float cpr_mod(float a, float b) {
+    return a - (b * floor(a / b));
 }
 
 int cpr_NL(float lat) {
-    // TODO prove that the approximate function is good
-    // enough for the precision we need. Uncomment if
-    // that is true. No performance penalty was noticed
-    // from testing, but if you find it might be an issue,
-    // switch to cpr_NL_approx() instead:
+    // Zone boundaries are tabulated, a binary search replaces the
+    // acos/cos of the closed form.
+    if (lat < 0)
+        lat = -lat;  // Symmetry
 
-    // return cpr_NL_approx(lat);
+    size_t lo = 0;
+    size_t hi = 58;
+    while (lo < hi) {
+        const size_t mid = (lo + hi) / 2;
+        if (lat < adsb_lat_lut[mid])
+            hi = mid;
+        else
+            lo = mid + 1;
+    }
 
-    return cpr_NL_precise(lat);
+    return 59 - lo;
 }
 
 int cpr_N(float lat, int is_odd) {
@@ -276,85 +437,124 @@ void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32
     frame.make_CRC();
 }
 
-// Decoding method from dump1090
-adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd) {
-    uint8_t* raw_data;
-    uint32_t latcprE, latcprO, loncprE, loncprO;
-    float latE, latO, m, Dlon, cpr_lon_odd, cpr_lon_even, cpr_lat_odd, cpr_lat_even;
-    int ni;
-    adsb_pos position{false, 0, 0, 0};
-
-    uint32_t time_even = frame_even.get_rx_timestamp();
-    uint32_t time_odd = frame_odd.get_rx_timestamp();
-    uint8_t* frame_data_even = frame_even.get_raw_data();
-    uint8_t* frame_data_odd = frame_odd.get_raw_data();
-
-    // Return most recent altitude
-    if (time_even > time_odd)
-        raw_data = frame_data_even;
-    else
-        raw_data = frame_data_odd;
-
-    // Q-bit must be present
-    if (raw_data[5] & 1)
-        position.altitude = ((((raw_data[5] & 0xFE) << 3) | ((raw_data[6] & 0xF0) >> 4)) * 25) - 1000;
+CPRPosition decode_frame_cpr(ADSBFrame& frame) {
+    const uint8_t* raw_data = frame.get_raw_data();
+    return {
+        static_cast<uint32_t>(((raw_data[6] & 3) << 15) | (raw_data[7] << 7) | (raw_data[8] >> 1)),
+        static_cast<uint32_t>(((raw_data[8] & 1) << 16) | (raw_data[9] << 8) | raw_data[10]),
+        (raw_data[6] & 4) != 0};
+}
 
-    // Position
-    latcprE = ((frame_data_even[6] & 3) << 15) | (frame_data_even[7] << 7) | (frame_data_even[8] >> 1);
-    loncprE = ((frame_data_even[8] & 1) << 16) | (frame_data_even[9] << 8) | frame_data_even[10];
+// Floor division and modulo for possibly negative zone indexes.
+static int32_t cpr_floor_div(const int32_t a, const int32_t b) {
+    return (a >= 0) ? (a / b) : -((-a + b - 1) / b);
+}
 
-    latcprO = ((frame_data_odd[6] & 3) << 15) | (frame_data_odd[7] << 7) | (frame_data_odd[8] >> 1);
-    loncprO = ((frame_data_odd[8] & 1) << 16) | (frame_data_odd[9] << 8) | frame_data_odd[10];
+static int32_t cpr_int_mod(const int32_t a, const int32_t b) {
+    return a - (b * cpr_floor_div(a, b));
+}
 
-    // Calculate the coefficients
-    cpr_lon_even = loncprE / CPR_MAX_VALUE;
-    cpr_lon_odd = loncprO / CPR_MAX_VALUE;
+static float cpr_wrap_longitude(float lon) {
+    if (lon >= 180) lon -= 360;
+    if (lon < -180) lon += 360;
+    return lon;
+}
 
-    cpr_lat_odd = latcprO / CPR_MAX_VALUE;
-    cpr_lat_even = latcprE / CPR_MAX_VALUE;
+// Decoding method from dump1090, with the zone indexes worked out on the
+// raw 17 bit values. All products stay below 2^24, exact in a float.
+bool cpr_decode_global(const CPRPosition& even, const CPRPosition& odd, const bool use_odd, float& latitude, float& longitude) {
+    constexpr int32_t cpr_max = 131072;
 
     // Compute latitude index
-    float j = floor(((59.0 * cpr_lat_even) - (60.0 * cpr_lat_odd)) + 0.5);
-    latE = (360.0 / 60.0) * (cpr_mod(j, 60) + cpr_lat_even);
-    latO = (360.0 / 59.0) * (cpr_mod(j, 59) + cpr_lat_odd);
+    const int32_t j = cpr_floor_div(59 * static_cast<int32_t>(even.lat) - 60 * static_cast<int32_t>(odd.lat) + cpr_max / 2, cpr_max);
+    float latE = (cpr_int_mod(j, 60) * cpr_max + even.lat) * (360.0f / 60 / cpr_max);
+    float latO = (cpr_int_mod(j, 59) * cpr_max + odd.lat) * (360.0f / 59 / cpr_max);
 
     if (latE >= 270) latE -= 360;
     if (latO >= 270) latO -= 360;
 
+    if ((latE > 90) || (latE < -90) || (latO > 90) || (latO < -90))
+        return false;
+
     // Both frames must be in the same latitude zone
-    if (cpr_NL(latE) != cpr_NL(latO))
-        return position;
+    const int nl = cpr_NL(latE);
+    if (nl != cpr_NL(latO))
+        return false;
 
     // Compute longitude
-    if (time_even > time_odd) {
-        // Use even frame2
-        ni = cpr_N(latE, 0);
-        Dlon = 360.0 / ni;
+    const CPRPosition& newest = use_odd ? odd : even;
+    const int32_t ni = cpr_N(use_odd ? latO : latE, use_odd);
+    const int32_t m = cpr_floor_div(static_cast<int32_t>(even.lon) * (nl - 1) - static_cast<int32_t>(odd.lon) * nl + cpr_max / 2, cpr_max);
 
-        m = floor((cpr_lon_even * (cpr_NL(latE) - 1)) - (cpr_lon_odd * cpr_NL(latE)) + 0.5);
-
-        position.longitude = Dlon * (cpr_mod(m, ni) + cpr_lon_even);
+    latitude = use_odd ? latO : latE;
+    longitude = cpr_wrap_longitude((cpr_int_mod(m, ni) * cpr_max + newest.lon) * (360.0f / cpr_max / ni));
+    return true;
+}
 
-        position.latitude = latE;
-    } else {
-        // Use odd frame
-        ni = cpr_N(latO, 1);
-        Dlon = 360.0 / ni;
+// Single frame decoding relative to a reference position less than half a
+// zone away (~180NM for airborne positions).
+bool cpr_decode_local(const CPRPosition& cpr, const float ref_latitude, const float ref_longitude, float& latitude, float& longitude) {
+    const float cpr_lat = cpr.lat / CPR_MAX_VALUE;
+    const float cpr_lon = cpr.lon / CPR_MAX_VALUE;
 
-        m = floor((cpr_lon_even * (cpr_NL(latO) - 1)) - (cpr_lon_odd * cpr_NL(latO)) + 0.5);
+    const float dlat = 360.0f / ((4 * NZ) - cpr.odd);
+    const float j = floor(ref_latitude / dlat) + floor(0.5f + (cpr_mod(ref_latitude, dlat) / dlat) - cpr_lat);
+    const float lat = dlat * (j + cpr_lat);
+    if ((lat > 90) || (lat < -90))
+        return false;
 
-        position.longitude = Dlon * (cpr_mod(m, ni) + cpr_lon_odd);
+    const float dlon = 360.0f / cpr_N(lat, cpr.odd);
+    const float m = floor(ref_longitude / dlon) + floor(0.5f + (cpr_mod(ref_longitude, dlon) / dlon) - cpr_lon);
 
-        position.latitude = latO;
-    }
+    latitude = lat;
+    longitude = cpr_wrap_longitude(dlon * (m + cpr_lon));
+    return true;
+}
 
-    if (position.longitude >= 180) position.longitude -= 360;
+adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd) {
+    adsb_pos position{false, 0, 0, 0};
 
-    position.valid = true;
+    // Return most recent altitude
+    const bool use_odd = frame_odd.get_rx_timestamp() >= frame_even.get_rx_timestamp();
+    int32_t altitude;
+    if (decode_frame_altitude(use_odd ? frame_odd : frame_even, altitude))
+        position.altitude = altitude;
 
+    position.valid = cpr_decode_global(decode_frame_cpr(frame_even), decode_frame_cpr(frame_odd), use_odd,
+                                       position.latitude, position.longitude);
     return position;
 }
 
+bool CPRTracker::update(const CPRPosition& cpr, const uint32_t now) {
+    const size_t parity = cpr.odd ? 1 : 0;
+    last[parity] = cpr;
+    last_time[parity] = now;
+    have[parity] = true;
+
+    float lat, lon;
+    bool decoded = false;
+    if (have[parity ^ 1] && ((now - last_time[parity ^ 1]) <= pair_timeout)) {
+        decoded = cpr_decode_global(last[0], last[1], cpr.odd, lat, lon);
+    }
+    if (!decoded && fix && ((now - fix_time) <= reference_timeout)) {
+        decoded = cpr_decode_local(cpr, fix_latitude, fix_longitude, lat, lon);
+    }
+    if (!decoded)
+        return false;
+
+    fix = true;
+    fix_time = now;
+    fix_latitude = lat;
+    fix_longitude = lon;
+    return true;
+}
+
+void CPRTracker::reset() {
+    have[0] = false;
+    have[1] = false;
+    fix = false;
+}
+
 // An ADS-B frame is 112 bits long. Civil aircraft ADS-B message starts with the Downlink Format ,DF=17.
 // Msg structure  consists of five main parts :|DF=17 (5 bits)|CA (3 bits)|ICAO (24 bits)|ME (56 bits)|CRC (24 bits)
 // Airborne velocities are all transmitted with Type Code 19 ( TC=19 ) inside ME (56 bits)
@@ -28,11 +28,19 @@
 
 #include <cstring>
 #include <string>
+#include <array>
 
 namespace adsb {
 
 enum downlink_format {
+    DF_SHORT_AIR_AIR = 0,
+    DF_SURV_ALT = 4,
+    DF_SURV_ID = 5,
+    DF_ALL_CALL = 11,
+    DF_LONG_AIR_AIR = 16,
     DF_ADSB = 17,
+    DF_TISB = 18,
+    DF_COMMB_ALT = 20,
     DF_EHS_SQUAWK = 21,  // DF 21: Comm-B with identity reply . Mode S enhanced surveillance of squawk + (MB_field = Track and turn report (BDS 5,0)).
                          // Confirmed that it is Detected correctly by dump1090. and sdrangel.
 };
@@ -96,6 +104,24 @@ void encode_frame_pos(ADSBFrame& frame, const uint32_t ICAO_address, const int32
 
 adsb_pos decode_frame_pos(ADSBFrame& frame_even, ADSBFrame& frame_odd);
 
+// Raw 17 bit CPR coordinates of an airborne position squitter.
+struct CPRPosition {
+    uint32_t lat;
+    uint32_t lon;
+    bool odd;
+};
+
+CPRPosition decode_frame_cpr(ADSBFrame& frame);
+
+// Number of longitude zones at a latitude, looked up in adsb_lat_lut.
+int cpr_NL(float lat);
+
+// Position from an even/odd pair, using the frame given by use_odd.
+bool cpr_decode_global(const CPRPosition& even, const CPRPosition& odd, const bool use_odd, float& latitude, float& longitude);
+
+// Position from a single frame, given a reference less than half a zone away.
+bool cpr_decode_local(const CPRPosition& cpr, const float ref_latitude, const float ref_longitude, float& latitude, float& longitude);
+
 void encode_frame_velo(ADSBFrame& frame, const uint32_t ICAO_address, const uint32_t speed, const float angle, const int32_t v_rate);
 
 adsb_vel decode_frame_velo(ADSBFrame& frame);
@@ -104,6 +130,82 @@ adsb_vel decode_frame_velo(ADSBFrame& frame);
 
 void encode_frame_squawk(ADSBFrame& frame, const uint16_t squawk);
 
+// True for formats whose parity is overlaid with the sender's address (AP).
+bool has_address_parity(const uint8_t df);
+
+// Address of a frame sent with plain parity (DF11/17/18), 0 if it fails.
+uint32_t checked_ICAO_address(ADSBFrame& frame);
+
+// 13-bit altitude code of DF0/4/16/20 frames, or 12-bit code of DF17/18
+// airborne positions, in feet. False if not available.
+bool decode_frame_altitude(ADSBFrame& frame, int32_t& altitude);
+
+// 13-bit identity of DF5/21 frames, as 4 packed octal digits (see encode_frame_squawk).
+uint16_t decode_frame_squawk(ADSBFrame& frame);
+
+/* Recently seen aircraft addresses, used to recover the sender of AP
+ * frames: their syndrome is the address, so it is only believed if that
+ * address was recently heard with plain parity. Open addressing with a
+ * short probe window, so both operations take at most probe_limit
+ * compares. Expired slots are recycled in place, never emptied. */
+class ICAOAddressSet {
+   public:
+    static constexpr size_t capacity = 256;
+    static constexpr size_t probe_limit = 16;
+    static constexpr uint32_t max_age = 60;  // Seconds
+
+    void insert(const uint32_t address, const uint32_t now);
+    bool contains(const uint32_t address, const uint32_t now) const;
+    void clear();
+
+   private:
+    struct Slot {
+        uint32_t address;
+        uint32_t last_seen;
+    };
+
+    std::array<Slot, capacity> slots{};
+
+    static size_t hash(const uint32_t address) {
+        return static_cast<uint32_t>(address * 2654435761U) >> 24;
+    }
+};
+
+/* Airborne position of one aircraft, kept across its position squitters.
+ * An even/odd pair heard within pair_timeout gives a global fix. After
+ * that, frames without a fresh partner are decoded on their own against
+ * the last fix, as long as it is no older than reference_timeout, so one
+ * lost frame no longer costs a position update. Times are in seconds. */
+class CPRTracker {
+   public:
+    static constexpr uint32_t pair_timeout = 10;
+    static constexpr uint32_t reference_timeout = 60;
+
+    // True if the frame gave a new position.
+    bool update(const CPRPosition& cpr, const uint32_t now);
+    void reset();
+
+    bool valid() const {
+        return fix;
+    }
+    float latitude() const {
+        return fix_latitude;
+    }
+    float longitude() const {
+        return fix_longitude;
+    }
+
+   private:
+    CPRPosition last[2]{};
+    uint32_t last_time[2]{};
+    bool have[2]{false, false};
+
+    bool fix{false};
+    uint32_t fix_time{0};
+    float fix_latitude{0};
+    float fix_longitude{0};
+};
+
 } /* namespace adsb */
 
 #endif /*__ADSB_H__*/
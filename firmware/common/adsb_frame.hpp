@@ -23,11 +23,39 @@
 #ifndef __ADSB_FRAME_H__
 #define __ADSB_FRAME_H__
 
+#include <cstdint>
+#include <cstddef>
 #include <cstring>
 #include <string>
+#include <array>
 
 namespace adsb {
 
+/* Mode S parity: CRC-24, generator 0x1FFF409, zero initial value. */
+constexpr uint32_t crc_generator = 0xFFF409;
+
+constexpr std::array<uint32_t, 256> make_crc_table() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i << 16;
+        for (size_t b = 0; b < 8; b++) {
+            crc = (crc & 0x800000) ? ((crc << 1) ^ crc_generator) : (crc << 1);
+        }
+        table[i] = crc & 0xFFFFFF;
+    }
+    return table;
+}
+
+inline constexpr std::array<uint32_t, 256> crc_table = make_crc_table();
+
+constexpr uint32_t compute_crc(const uint8_t* const data, const size_t length) {
+    uint32_t crc = 0;
+    for (size_t i = 0; i < length; i++) {
+        crc = ((crc << 8) ^ crc_table[((crc >> 16) ^ data[i]) & 0xFF]) & 0xFFFFFF;
+    }
+    return crc;
+}
+
 alignas(4) const uint8_t adsb_preamble[16] = {1, 0, 1, 0, 0, 0, 0, 1, 0, 1, 0, 0, 0, 0, 0, 0};
 alignas(4) const char icao_id_lut[65] = "#ABCDEFGHIJKLMNOPQRSTUVWXYZ##### ###############0123456789######";
 
@@ -72,23 +100,37 @@ class ADSBFrame {
         return (uint8_t*)raw_data;
     }
 
+    // DFs 16 or greater are long 112. DFs 15 or less are short 56.
+    size_t length_bits() {
+        return (raw_data[0] & 0x80) ? 112 : 56;
+    }
+
     void make_CRC() {
         uint32_t computed_CRC = compute_CRC();
+        const size_t parity_index = length_bits() / 8 - 3;
 
         // Insert CRC in frame
-        raw_data[11] = (computed_CRC >> 16) & 0xFF;
-        raw_data[12] = (computed_CRC >> 8) & 0xFF;
-        raw_data[13] = computed_CRC & 0xFF;
+        raw_data[parity_index] = (computed_CRC >> 16) & 0xFF;
+        raw_data[parity_index + 1] = (computed_CRC >> 8) & 0xFF;
+        raw_data[parity_index + 2] = computed_CRC & 0xFF;
     }
 
     bool check_CRC() {
-        uint32_t computed_CRC = compute_CRC();
+        return syndrome() == 0;
+    }
 
-        if ((raw_data[11] != ((computed_CRC >> 16) & 0xFF)) ||
-            (raw_data[12] != ((computed_CRC >> 8) & 0xFF)) ||
-            (raw_data[13] != (computed_CRC & 0xFF))) return false;
+    // Computed CRC XOR transmitted parity, zero for an intact frame.
+    // Flipping any single bit changes it by a fixed, position-dependent value.
+    // In formats with address/parity (AP) it is the sender's address instead.
+    uint32_t syndrome() {
+        const size_t parity_index = length_bits() / 8 - 3;
+        const uint32_t parity = (raw_data[parity_index] << 16) + (raw_data[parity_index + 1] << 8) + raw_data[parity_index + 2];
+        return compute_CRC() ^ parity;
+    }
 
-        return true;
+    void flip_bit(const size_t bit) {
+        if (bit < 112)
+            raw_data[bit >> 3] ^= (0x80 >> (bit & 7));
     }
 
     bool empty() {
@@ -103,26 +145,7 @@ class ADSBFrame {
     uint32_t rx_timestamp{};
 
     uint32_t compute_CRC() {
-        uint8_t adsb_crc[14] = {0};  // Temp buffer
-        uint8_t b, c, s, bitn;
-        const uint32_t crc_poly = 0x1205FFF;
-
-        // Copy frame data
-        memcpy(adsb_crc, raw_data, 11);
-
-        // Compute CRC
-        for (c = 0; c < 11; c++) {
-            for (b = 0; b < 8; b++) {
-                if ((adsb_crc[c] << b) & 0x80) {
-                    for (s = 0; s < 25; s++) {
-                        bitn = (c * 8) + b + s;
-                        if ((crc_poly >> s) & 1) adsb_crc[bitn >> 3] ^= (0x80 >> (bitn & 7));
-                    }
-                }
-            }
-        }
-
-        return (adsb_crc[11] << 16) + (adsb_crc[12] << 8) + adsb_crc[13];
+        return compute_crc(raw_data, length_bits() / 8 - 3);
     }
 };
 
@@ -32,6 +32,9 @@
 namespace baseband {
 namespace ais {
 
+// Both channels are received at once, tuned halfway between them.
+constexpr uint32_t channel_offset = 25000;
+
 // Translate+Rectangular window filter
 // sample=38.4k, deviation=2400, symbol=9600
 // Length: 4 taps, 1 symbol, 1/4 cycle of sinusoid
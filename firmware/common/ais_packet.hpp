@@ -94,6 +94,12 @@ using TrueHeading = uint16_t;
 
 using MMSI = uint32_t;
 
+/* AIS alternates between two channels, 50 kHz apart. */
+enum class Channel : uint8_t {
+    A = 0, /* 87B, 161.975 MHz */
+    B = 1, /* 88B, 162.025 MHz */
+};
+
 class Packet {
    public:
     constexpr Packet(
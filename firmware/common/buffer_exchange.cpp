@@ -22,6 +22,8 @@
 #include "buffer_exchange.hpp"
 
 BufferExchange* BufferExchange::obj{nullptr};
+BufferExchange::Statistics BufferExchange::capture_statistics{};
+BufferExchange::Statistics BufferExchange::replay_statistics{};
 
 BufferExchange::BufferExchange(
     CaptureConfig* const config)  // : config_capture { config }
@@ -30,6 +32,8 @@ BufferExchange::BufferExchange(
     // In capture mode, baseband wants empty buffers, app waits for full buffers
     fifo_buffers_for_baseband = config->fifo_buffers_empty;
     fifo_buffers_for_application = config->fifo_buffers_full;
+    buffer_count = config->buffer_count;
+    direction = CAPTURE;
 }
 
 BufferExchange::BufferExchange(
@@ -39,9 +43,25 @@ BufferExchange::BufferExchange(
     // In replay mode, baseband wants full buffers, app waits for empty buffers
     fifo_buffers_for_baseband = config->fifo_buffers_full;
     fifo_buffers_for_application = config->fifo_buffers_empty;
+    buffer_count = config->buffer_count;
+    direction = REPLAY;
 }
 
 BufferExchange::~BufferExchange() {
+    // The baseband still owns the FIFOs until the stream is stopped.
+    const auto fifo_full = (direction == CAPTURE) ? fifo_buffers_for_application : fifo_buffers_for_baseband;
+    const auto fifo_empty = (direction == CAPTURE) ? fifo_buffers_for_baseband : fifo_buffers_for_application;
+    if (fifo_full && fifo_empty) {
+        auto& statistics = (direction == CAPTURE) ? capture_statistics : replay_statistics;
+        statistics = {
+            buffer_count,
+            fifo_full->high_water(),
+            fifo_full->drops(),
+            fifo_empty->high_water(),
+            fifo_empty->drops(),
+        };
+    }
+
     obj = nullptr;
     fifo_buffers_for_baseband = nullptr;
     fifo_buffers_for_application = nullptr;
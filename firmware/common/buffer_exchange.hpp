@@ -29,6 +29,19 @@
 
 class BufferExchange {
    public:
+    /* How the stream buffer FIFOs fared, taken as the exchange ends. */
+    struct Statistics {
+        size_t buffer_count{0};
+        size_t full_high_water{0};
+        size_t full_drops{0};
+        size_t empty_high_water{0};
+        size_t empty_drops{0};
+    };
+
+    // Of the last capture and the last replay.
+    static Statistics capture_statistics;
+    static Statistics replay_statistics;
+
     BufferExchange(CaptureConfig* const config);
     BufferExchange(ReplayConfig* const config);
     ~BufferExchange();
@@ -85,6 +98,7 @@ class BufferExchange {
     // ReplayConfig* const config_replay;
     FIFO<StreamBuffer*>* fifo_buffers_for_baseband{nullptr};
     FIFO<StreamBuffer*>* fifo_buffers_for_application{nullptr};
+    size_t buffer_count{0};
     Thread* thread{nullptr};
     static BufferExchange* obj;
 
@@ -0,0 +1,134 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __CAPTURE_FORMAT_H__
+#define __CAPTURE_FORMAT_H__
+
+#include <cstdint>
+#include <cstddef>
+
+#include "complex.hpp"
+
+/* How the baseband stores captured samples in the stream buffers. */
+enum class CaptureFormat : uint8_t {
+    C16 = 0,   // complex16_t as decimated
+    C16Z = 1,  // complex16_t, iq_codec compressed blocks
+    C8 = 2,    // complex8_t, top 8 bits of each component
+    C12 = 3,   // Top 12 bits of I and Q packed into 3 bytes
+};
+
+/* Bytes per complex sample on the card, 0 for the variable rate C16Z. */
+constexpr size_t capture_sample_size(const CaptureFormat format) {
+    switch (format) {
+        case CaptureFormat::C16:
+            return 4;
+        case CaptureFormat::C8:
+            return 2;
+        case CaptureFormat::C12:
+            return 3;
+        default:
+            return 0;
+    }
+}
+
+/* Conversions between the decimated complex16_t samples and the narrower
+ * sample formats. Packing keeps the most significant bits, rounded to
+ * nearest and saturated; unpacking shifts them back into place, so a
+ * packed capture replays at the level it was recorded.
+ *
+ * C12 packs one sample as I[7:0], Q[3:0]I[11:8], Q[11:4].
+ */
+namespace capture_format {
+
+constexpr int32_t round_shift_saturate(const int32_t v, const size_t shift, const int32_t limit) {
+    const int32_t r = (v + (1 << (shift - 1))) >> shift;
+    return (r > limit) ? limit : ((r < -limit - 1) ? (-limit - 1) : r);
+}
+
+inline void pack_c8(const complex16_t* const src, const size_t count, uint8_t* const dst) {
+    for (size_t n = 0; n < count; n++) {
+        dst[n * 2 + 0] = round_shift_saturate(src[n].real(), 8, 127);
+        dst[n * 2 + 1] = round_shift_saturate(src[n].imag(), 8, 127);
+    }
+}
+
+inline void unpack_c8(const uint8_t* const src, const size_t count, complex16_t* const dst) {
+    for (size_t n = 0; n < count; n++) {
+        const int16_t i = static_cast<int8_t>(src[n * 2 + 0]);
+        const int16_t q = static_cast<int8_t>(src[n * 2 + 1]);
+        dst[n] = {static_cast<int16_t>(i * 256), static_cast<int16_t>(q * 256)};
+    }
+}
+
+inline void pack_c12(const complex16_t* const src, const size_t count, uint8_t* const dst) {
+    for (size_t n = 0; n < count; n++) {
+        const uint32_t i = round_shift_saturate(src[n].real(), 4, 2047) & 0xfff;
+        const uint32_t q = round_shift_saturate(src[n].imag(), 4, 2047) & 0xfff;
+        dst[n * 3 + 0] = i;
+        dst[n * 3 + 1] = (i >> 8) | (q << 4);
+        dst[n * 3 + 2] = q >> 4;
+    }
+}
+
+inline void unpack_c12(const uint8_t* const src, const size_t count, complex16_t* const dst) {
+    for (size_t n = 0; n < count; n++) {
+        const uint32_t b0 = src[n * 3 + 0];
+        const uint32_t b1 = src[n * 3 + 1];
+        const uint32_t b2 = src[n * 3 + 2];
+        // Put each 12 bit value in the top of 16 bits, sign and scale come for free
+        const int16_t i = static_cast<int16_t>(((b1 & 0x0f) << 12) | (b0 << 4));
+        const int16_t q = static_cast<int16_t>((b2 << 8) | (b1 & 0xf0));
+        dst[n] = {i, q};
+    }
+}
+
+/* Packs count samples into dst, which must hold count * capture_sample_size
+ * bytes. Returns the bytes written, 0 for the formats not packed here. */
+inline size_t pack(const CaptureFormat format, const complex16_t* const src, const size_t count, uint8_t* const dst) {
+    switch (format) {
+        case CaptureFormat::C8:
+            pack_c8(src, count, dst);
+            break;
+        case CaptureFormat::C12:
+            pack_c12(src, count, dst);
+            break;
+        default:
+            return 0;
+    }
+    return count * capture_sample_size(format);
+}
+
+inline void unpack(const CaptureFormat format, const uint8_t* const src, const size_t count, complex16_t* const dst) {
+    switch (format) {
+        case CaptureFormat::C8:
+            unpack_c8(src, count, dst);
+            break;
+        case CaptureFormat::C12:
+            unpack_c12(src, count, dst);
+            break;
+        default:
+            break;
+    }
+}
+
+} /* namespace capture_format */
+
+#endif /*__CAPTURE_FORMAT_H__*/
@@ -34,6 +34,7 @@
 #include "hal.h"
 #include "utility.hpp"
 #include "sine_table_int8.hpp"
+#include "simd.hpp"
 
 namespace std {
 /* https://github.com/AE9RB/fftbench/blob/master/cxlr.hpp
@@ -61,6 +62,23 @@ void fft_swap(const buffer_c16_t src, std::array<T, N>& dst) {
     }
 }
 
+/* Windowed variant. The window is periodic and symmetric about N/2, given
+ * as its first N/2 + 1 coefficients in Q15.
+ */
+template <typename T, size_t N>
+void fft_swap(const buffer_c16_t src, std::array<T, N>& dst, const std::array<int16_t, N / 2 + 1>& window) {
+    static_assert(power_of_two(N), "only defined for N == power of two");
+
+    for (size_t i = 0; i < N; i++) {
+        const size_t i_rev = __RBIT(i) >> (32 - log_2(N));
+        const int32_t w = window[(i <= N / 2) ? i : (N - i)];
+        const auto s = src.p[i];
+        dst[i_rev] = {
+            static_cast<typename T::value_type>((s.real() * w) >> 15),
+            static_cast<typename T::value_type>((s.imag() * w) >> 15)};
+    }
+}
+
 template <typename T, size_t N>
 void fft_swap(const std::array<complex16_t, N>& src, std::array<T, N>& dst) {
     static_assert(power_of_two(N), "only defined for N == power of two");
@@ -133,6 +151,240 @@ void fft_c_preswapped(std::array<T, N>& data, const size_t from, const size_t to
     }
 }
 
+/* Twiddle factors for the radix-4 engine, generated at compile time.
+ * Only one quarter wave of sine is stored, for the largest supported FFT
+ * size. Smaller FFTs stride through the same table.
+ */
+
+constexpr size_t fft_max_size = 2048;
+
+constexpr double fft_sine_taylor(const double x) {
+    // Good to double precision for 0 <= x <= pi/2.
+    double term = x;
+    double sum = x;
+    for (size_t n = 1; n < 14; n++) {
+        term *= -x * x / static_cast<double>((2 * n) * (2 * n + 1));
+        sum += term;
+    }
+    return sum;
+}
+
+template <size_t Q>
+constexpr std::array<float, Q + 1> fft_make_quarter_sine_table() {
+    std::array<float, Q + 1> table{};
+    for (size_t i = 0; i <= Q; i++) {
+        table[i] = static_cast<float>(fft_sine_taylor(1.5707963267948966192 * i / Q));
+    }
+    return table;
+}
+
+inline constexpr std::array<float, fft_max_size / 4 + 1> fft_quarter_sine_table =
+    fft_make_quarter_sine_table<fft_max_size / 4>();
+
+/* Returns exp(-2*pi*i * t / N), for 0 <= t < N. */
+template <size_t N>
+inline std::complex<float> fft_twiddle(const size_t t) {
+    static_assert(power_of_two(N) && (N <= fft_max_size), "No FFT twiddle factors for this N");
+    constexpr size_t Q = fft_max_size / 4;
+    const size_t index = t * (fft_max_size / N);
+    const size_t r = index & (Q - 1);
+    const float s = fft_quarter_sine_table[r];
+    const float c = fft_quarter_sine_table[Q - r];
+    switch (index / Q) {
+        default:
+        case 0:
+            return {c, -s};
+        case 1:
+            return {-s, -c};
+        case 2:
+            return {-c, s};
+        case 3:
+            return {s, c};
+    }
+}
+
+/* Radix-4 (radix-2^2) decimation-in-time FFT. Takes the same radix-2
+ * bit-reversed input as fft_c_preswapped(), so the bit reversal stays fused
+ * into fft_swap(), which already reorders while converting from complex16_t.
+ * Each pass merges two radix-2 stages, needing three twiddle multiplies per
+ * four points instead of four, and half as many passes over the data.
+ * A single trivial radix-2 pass runs first when log2(N) is odd.
+ */
+template <typename T, size_t N>
+void fft_c_preswapped_radix4(std::array<T, N>& data) {
+    static_assert(power_of_two(N), "only defined for N == power of two");
+    static_assert((N >= 4) && (N <= fft_max_size), "only defined for 4 <= N <= fft_max_size");
+    constexpr auto K = log_2(N);
+
+    size_t k = 0;
+    if (K & 1) {
+        for (size_t i = 0; i < N; i += 2) {
+            const T a = data[i];
+            const T b = data[i + 1];
+            data[i] = a + b;
+            data[i + 1] = a - b;
+        }
+        k = 1;
+    }
+
+    for (; k < K; k += 2) {
+        const size_t m = 1 << k;
+        const size_t stride = N / (4 * m);
+
+        for (size_t j = 0; j < m; j++) {
+            const T w1 = fft_twiddle<N>(j * stride);
+            const T w2 = fft_twiddle<N>(2 * j * stride);
+            const T w3 = fft_twiddle<N>(3 * j * stride);
+
+            /* Bit-reversed order: data[i + m] holds the sub-transform of the
+             * inputs = 2 (mod 4), data[i + 2m] those = 1 (mod 4). */
+            for (size_t i = j; i < N; i += 4 * m) {
+                const T a = data[i];
+                const T b = w2 * data[i + m];
+                const T c = w1 * data[i + 2 * m];
+                const T d = w3 * data[i + 3 * m];
+
+                const T apb = a + b;
+                const T amb = a - b;
+                const T cpd = c + d;
+                const T cmd = c - d;
+                const T jcmd{cmd.imag(), -cmd.real()};  // -i * (c - d)
+
+                data[i] = apb + cpd;
+                data[i + m] = amb + jcmd;
+                data[i + 2 * m] = apb - cpd;
+                data[i + 3 * m] = amb - jcmd;
+            }
+        }
+    }
+}
+
+#if defined(LPC43XX_M4)
+
+/* Fixed-point Q15 FFT on complex16_t, built on the dual 16-bit SIMD
+ * instructions. Uses block floating point: weak input is normalized up
+ * first, then each stage is scaled down by 0, 1 or 2 bits depending on the
+ * peak the previous stage produced, so small signals keep their precision
+ * and large ones never wrap. Returns the block exponent (may be negative);
+ * the true spectrum is the output scaled by 2^exponent.
+ */
+
+template <size_t Q>
+constexpr std::array<int16_t, Q + 1> fft_make_quarter_sine_table_q15() {
+    std::array<int16_t, Q + 1> table{};
+    for (size_t i = 0; i <= Q; i++) {
+        table[i] = static_cast<int16_t>(fft_sine_taylor(1.5707963267948966192 * i / Q) * 32767.0 + 0.5);
+    }
+    return table;
+}
+
+inline constexpr std::array<int16_t, fft_max_size / 4 + 1> fft_quarter_sine_table_q15 =
+    fft_make_quarter_sine_table_q15<fft_max_size / 4>();
+
+/* Returns exp(-2*pi*i * t / N) in Q15, for 0 <= t < N. */
+template <size_t N>
+inline vec2_s16 fft_twiddle_q15(const size_t t) {
+    static_assert(power_of_two(N) && (N <= fft_max_size), "No FFT twiddle factors for this N");
+    constexpr size_t Q = fft_max_size / 4;
+    const size_t index = t * (fft_max_size / N);
+    const size_t r = index & (Q - 1);
+    const int16_t s = fft_quarter_sine_table_q15[r];
+    const int16_t c = fft_quarter_sine_table_q15[Q - r];
+    switch (index / Q) {
+        default:
+        case 0:
+            return {c, static_cast<int16_t>(-s)};
+        case 1:
+            return {static_cast<int16_t>(-s), static_cast<int16_t>(-c)};
+        case 2:
+            return {static_cast<int16_t>(-c), s};
+        case 3:
+            return {s, c};
+    }
+}
+
+/* Bitwise OR of the magnitudes (one's complement for negatives) of both
+ * lanes. Cheap to accumulate, and its top bit bounds the block peak. */
+inline uint32_t fft_q15_magnitude_bits(const vec2_s16 v) {
+    const int32_t re = v.v[0];
+    const int32_t im = v.v[1];
+    return static_cast<uint32_t>((re ^ (re >> 31)) | (im ^ (im >> 31)));
+}
+
+template <size_t N>
+int fft_c_preswapped_q15(std::array<complex16_t, N>& data) {
+    static_assert(power_of_two(N), "only defined for N == power of two");
+    static_assert((N >= 2) && (N <= fft_max_size), "only defined for 2 <= N <= fft_max_size");
+    static_assert(sizeof(complex16_t) == sizeof(vec2_s16), "complex16_t and vec2_s16 must share layout");
+    constexpr auto K = log_2(N);
+
+    /* A butterfly grows a component by at most 1 + sqrt(2). Stage inputs
+     * below 2^13 are left alone, below 2^14 the outputs are halved, and
+     * anything larger is quartered. Every stage output then stays below
+     * 2^13 * (1 + sqrt(2)), and the twiddle product always fits 16 bits. */
+    vec2_s16* const d = reinterpret_cast<vec2_s16*>(data.data());
+    const vec2_s16 zero{};
+
+    uint32_t bits = 0;
+    for (size_t i = 0; i < N; i++) {
+        bits |= fft_q15_magnitude_bits(d[i]);
+    }
+
+    /* Normalize weak input up into the top of the headroom first, so
+     * rounding in the early stages does not swamp it. */
+    int exponent = 0;
+    if (bits != 0) {
+        while (bits < (1U << 12)) {
+            bits <<= 1;
+            exponent--;
+        }
+    }
+    if (exponent < 0) {
+        for (size_t i = 0; i < N; i++) {
+            d[i] = {
+                static_cast<int16_t>(d[i].v[0] * (1 << -exponent)),
+                static_cast<int16_t>(d[i].v[1] * (1 << -exponent))};
+        }
+    }
+
+    for (size_t k = 0; k < K; k++) {
+        const size_t mmax = 1 << k;
+        const size_t stride = N / (2 * mmax);
+        const int shift = (bits < (1U << 13)) ? 0 : ((bits < (1U << 14)) ? 1 : 2);
+        const int product_shift = (shift == 2) ? 16 : 15;
+        const int32_t round = 1 << (product_shift - 1);
+        bits = 0;
+
+        for (size_t m = 0; m < mmax; m++) {
+            const vec2_s16 w = fft_twiddle_q15<N>(m * stride);
+            for (size_t i = m; i < N; i += mmax * 2) {
+                const size_t j = i + mmax;
+                const vec2_s16 b = d[j];
+                const vec2_s16 t{
+                    static_cast<int16_t>(smlsd(w, b, round) >> product_shift),
+                    static_cast<int16_t>(smladx(w, b, round) >> product_shift)};
+
+                vec2_s16 a = d[i];
+                if (shift == 0) {
+                    d[i] = qadd16(a, t);
+                    d[j] = qsub16(a, t);
+                } else {
+                    if (shift == 2) a = shadd16(a, zero);
+                    d[i] = shadd16(a, t);
+                    d[j] = shsub16(a, t);
+                }
+                bits |= fft_q15_magnitude_bits(d[i]) | fft_q15_magnitude_bits(d[j]);
+            }
+        }
+
+        exponent += shift;
+    }
+
+    return exponent;
+}
+
+#endif /* defined(LPC43XX_M4) */
+
 /*
    ifft(v,N):
    [0] If N==1 then return.
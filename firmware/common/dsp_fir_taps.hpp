@@ -1264,4 +1264,27 @@ static constexpr fir_taps_real<16> taps_200k_decim_1 = {
     }},
 };
 
+// Halfband decimation by 2 //////////////////////////////////////////////
+
+// Halfband filter: fs=1, pass=0.1 (-0.01dB), stop=0.4 (-60dB), decim=2, least squares.
+// Every other tap but the centre is zero, DC gain of exactly 1.
+constexpr fir_taps_real<11> taps_halfband_decim = {
+    .low_frequency_normalized = -0.1f,
+    .high_frequency_normalized = 0.1f,
+    .transition_normalized = 0.3f,
+    .taps = {{
+        302,
+        0,
+        -1873,
+        0,
+        9763,
+        16384,
+        9763,
+        0,
+        -1873,
+        0,
+        302,
+    }},
+};
+
 #endif /*__DSP_FIR_TAPS_H__*/
@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __DSP_WINDOW_H__
+#define __DSP_WINDOW_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <array>
+
+#include "dsp_fft.hpp"
+
+/* Periodic time-domain windows for an N-point FFT, in Q15. Windows are
+ * symmetric about N/2, so only coefficients 0..N/2 are stored. The windowed
+ * fft_swap() applies them while bit-reversing the input.
+ */
+
+template <size_t N>
+using window_half_t = std::array<int16_t, N / 2 + 1>;
+
+struct WindowCosineSum {
+    double a0;
+    double a1;
+    double a2;
+    double a3;
+    double a4;
+};
+
+constexpr WindowCosineSum window_hamming{0.54, 0.46, 0.0, 0.0, 0.0};
+constexpr WindowCosineSum window_hann{0.5, 0.5, 0.0, 0.0, 0.0};
+constexpr WindowCosineSum window_blackman_harris{0.35875, 0.48829, 0.14128, 0.01168, 0.0};
+constexpr WindowCosineSum window_flat_top{0.21557895, 0.41663158, 0.277263158, 0.083578947, 0.006947368};
+
+/* cos(2*pi * k / N) */
+constexpr double window_cos_2pi(const size_t k, const size_t N) {
+    // cos(2x) = 1 - 2 sin^2(x), folded so the sine argument is in [0, pi/2].
+    const size_t m = k % N;
+    const size_t folded = (m <= N / 2) ? m : (N - m);
+    const double s = fft_sine_taylor(3.14159265358979323846 * folded / N);
+    return 1.0 - 2.0 * s * s;
+}
+
+template <size_t N>
+constexpr window_half_t<N> window_make_cosine_sum(const WindowCosineSum& a) {
+    static_assert(power_of_two(N), "only defined for N == power of two");
+    window_half_t<N> table{};
+    for (size_t n = 0; n <= N / 2; n++) {
+        const double w = a.a0 - a.a1 * window_cos_2pi(n, N) + a.a2 * window_cos_2pi(2 * n, N) - a.a3 * window_cos_2pi(3 * n, N) + a.a4 * window_cos_2pi(4 * n, N);
+        const double q = w * 32767.0;
+        table[n] = static_cast<int16_t>((q < 0.0) ? (q - 0.5) : (q + 0.5));
+    }
+    return table;
+}
+
+#endif /*__DSP_WINDOW_H__*/
@@ -29,7 +29,11 @@
 
 #include <hal.h>
 
-/* FIFO implementation inspired by Linux kfifo. */
+/* FIFO implementation inspired by Linux kfifo.
+ *
+ * Counts, on the producing side, the most elements it ever held and the
+ * elements (or records, for in_r) it had no room for.
+ */
 
 template <typename T>
 class FIFO {
@@ -40,7 +44,9 @@ class FIFO {
         : _data{data},
           _size{1U << k},
           _in{0},
-          _out{0} {
+          _out{0},
+          _high_water{0},
+          _drops{0} {
     }
 
     void reset() {
@@ -71,14 +77,24 @@ class FIFO {
         return unused() == 0;
     }
 
+    size_t high_water() const {
+        return _high_water;
+    }
+
+    size_t drops() const {
+        return _drops;
+    }
+
     bool in(const T& val) {
         if (is_full()) {
+            _drops += 1;
             return false;
         }
 
         _data[_in & mask()] = val;
         smp_wmb();
         _in += 1;
+        note_high_water();
 
         return true;
     }
@@ -86,22 +102,26 @@ class FIFO {
     size_t in(const T* const buf, size_t len) {
         const size_t l = unused();
         if (len > l) {
+            _drops += len - l;
             len = l;
         }
 
         copy_in(buf, len, _in);
         _in += len;
+        note_high_water();
         return len;
     }
 
     size_t in_r(const void* const buf, const size_t len) {
         if ((len + recsize()) > unused()) {
+            _drops += 1;
             return 0;
         }
 
         poke_n(len);
         copy_in((const T*)buf, len, _in + recsize());
         _in += len + recsize();
+        note_high_water();
         return len;
     }
 
@@ -175,6 +195,10 @@ class FIFO {
         __DMB();
     }
 
+    void note_high_water() {
+        _high_water = std::max(_high_water, len());
+    }
+
     size_t peek_n() {
         size_t l = _data[_out & mask()];
         if (recsize() > 1) {
@@ -233,6 +257,8 @@ class FIFO {
     const size_t _size;
     volatile size_t _in;
     volatile size_t _out;
+    size_t _high_water;
+    size_t _drops;
 };
 
 #endif /*__FIFO_H__*/
@@ -0,0 +1,311 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "iq_codec.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace iq_codec {
+
+namespace {
+
+/* Quotients this long or longer are sent as an escape run followed by the
+ * value in full. A difference of two int16_t zigzags to at most 17 bits. */
+constexpr uint32_t escape_length = 24;
+constexpr uint32_t escape_value_bits = 17;
+constexpr uint32_t k_max = 16;
+
+uint32_t zigzag(const int32_t v) {
+    return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31);
+}
+
+int32_t unzigzag(const uint32_t u) {
+    return static_cast<int32_t>(u >> 1) ^ -static_cast<int32_t>(u & 1);
+}
+
+/* Rice parameter close to log2 of the mean value. */
+uint8_t choose_k(const uint32_t sum, const size_t count) {
+    uint8_t k = 0;
+    while ((k < k_max) && ((static_cast<uint64_t>(count) << (k + 1)) <= sum)) {
+        k++;
+    }
+    return k;
+}
+
+/* MSB first into 32 bit words, stored in native byte order. */
+class BitWriter {
+   public:
+    BitWriter(uint8_t* const p, uint8_t* const end)
+        : p{p}, end{end} {
+    }
+
+    void put(const uint32_t value, const uint32_t length) {
+        acc = (acc << length) | value;
+        bits += length;
+        if (bits >= 32) {
+            bits -= 32;
+            store(static_cast<uint32_t>(acc >> bits));
+        }
+    }
+
+    void put_rice(const uint32_t u, const uint32_t k) {
+        const uint32_t q = u >> k;
+        if (q < escape_length) {
+            put((1UL << (q + 1)) - 2, q + 1);
+            if (k) put(u & ((1UL << k) - 1), k);
+        } else {
+            put((1UL << escape_length) - 1, escape_length);
+            put(u, escape_value_bits);
+        }
+    }
+
+    void flush() {
+        if (bits) {
+            store(static_cast<uint32_t>(acc << (32 - bits)));
+            bits = 0;
+        }
+    }
+
+    bool overflow() const {
+        return p > end;
+    }
+
+    uint8_t* position() const {
+        return p;
+    }
+
+   private:
+    uint8_t* p;
+    uint8_t* const end;
+    uint64_t acc{0};
+    uint32_t bits{0};
+
+    void store(const uint32_t word) {
+        if (p + sizeof(word) <= end) {
+            memcpy(p, &word, sizeof(word));
+        }
+        p += sizeof(word);
+    }
+};
+
+class BitReader {
+   public:
+    BitReader(const uint8_t* const p, const uint8_t* const end)
+        : p{p}, end{end} {
+        refill();
+    }
+
+    uint32_t get(const uint32_t length) {
+        refill();
+        if (length > bits) {
+            overrun = true;
+            return 0;
+        }
+        const uint32_t value = length ? static_cast<uint32_t>(acc >> (64 - length)) : 0;
+        acc <<= length;
+        bits -= length;
+        return value;
+    }
+
+    uint32_t get_rice(const uint32_t k) {
+        refill();
+        const uint64_t inverted = ~acc;
+        uint32_t q = inverted ? __builtin_clzll(inverted) : 64;
+        if (q >= escape_length) {
+            get(escape_length);
+            return get(escape_value_bits);
+        }
+        get(q + 1);
+        return (q << k) | get(k);
+    }
+
+    bool overrun{false};
+
+   private:
+    const uint8_t* p;
+    const uint8_t* const end;
+    uint64_t acc{0};
+    uint32_t bits{0};
+
+    void refill() {
+        if ((bits <= 32) && (p + 4 <= end)) {
+            uint32_t word;
+            memcpy(&word, p, sizeof(word));
+            p += sizeof(word);
+            acc |= static_cast<uint64_t>(word) << (32 - bits);
+            bits += 32;
+        }
+    }
+};
+
+size_t encode_raw(const complex16_t* const src, const size_t count, uint8_t* const dst) {
+    const BlockHeader header{block_sync, static_cast<uint16_t>(count), static_cast<uint16_t>(count * sizeof(complex16_t)), k_raw, k_raw};
+    memcpy(dst, &header, sizeof(header));
+    memcpy(dst + sizeof(header), src, count * sizeof(complex16_t));
+    return sizeof(header) + count * sizeof(complex16_t);
+}
+
+} /* namespace */
+
+FileHeader make_file_header() {
+    FileHeader header{};
+    memcpy(header.magic, file_magic, sizeof(header.magic));
+    header.version = file_version;
+    return header;
+}
+
+bool check_file_header(const FileHeader& header) {
+    return (memcmp(header.magic, file_magic, sizeof(header.magic)) == 0) && (header.version == file_version);
+}
+
+size_t encode_block(const complex16_t* const src, const size_t count, uint8_t* const dst) {
+    if ((count < 2) || (count > block_samples_max)) {
+        return encode_raw(src, count, dst);
+    }
+
+    uint32_t sum_i = 0;
+    uint32_t sum_q = 0;
+    for (size_t n = 1; n < count; n++) {
+        sum_i += zigzag(src[n].real() - src[n - 1].real());
+        sum_q += zigzag(src[n].imag() - src[n - 1].imag());
+    }
+    const uint8_t k_i = choose_k(sum_i, count - 1);
+    const uint8_t k_q = choose_k(sum_q, count - 1);
+
+    // Compressed output must come in under the raw payload
+    uint8_t* const payload = dst + sizeof(BlockHeader);
+    uint8_t* const end = payload + count * sizeof(complex16_t);
+    memcpy(payload, &src[0], sizeof(complex16_t));
+
+    BitWriter writer{payload + sizeof(complex16_t), end};
+    for (size_t n = 1; n < count; n++) {
+        writer.put_rice(zigzag(src[n].real() - src[n - 1].real()), k_i);
+        writer.put_rice(zigzag(src[n].imag() - src[n - 1].imag()), k_q);
+        if (writer.overflow()) {
+            return encode_raw(src, count, dst);
+        }
+    }
+    writer.flush();
+    if (writer.overflow() || (writer.position() >= end)) {
+        return encode_raw(src, count, dst);
+    }
+
+    const size_t payload_size = writer.position() - payload;
+    const BlockHeader header{block_sync, static_cast<uint16_t>(count), static_cast<uint16_t>(payload_size), k_i, k_q};
+    memcpy(dst, &header, sizeof(header));
+    return sizeof(header) + payload_size;
+}
+
+bool check_block_header(const BlockHeader& header) {
+    if ((header.sync != block_sync) || (header.sample_count > block_samples_max))
+        return false;
+    if (header.k_i == k_raw)
+        return header.payload_size == header.sample_count * sizeof(complex16_t);
+    return (header.k_i <= k_max) && (header.k_q <= k_max) &&
+           (header.payload_size >= sizeof(complex16_t)) &&
+           (header.payload_size < header.sample_count * sizeof(complex16_t));
+}
+
+bool decode_block(const BlockHeader& header, const uint8_t* const payload, complex16_t* const dst) {
+    if (!check_block_header(header))
+        return false;
+
+    const size_t count = header.sample_count;
+    if (header.k_i == k_raw) {
+        memcpy(dst, payload, count * sizeof(complex16_t));
+        return true;
+    }
+
+    memcpy(&dst[0], payload, sizeof(complex16_t));
+    int32_t i = dst[0].real();
+    int32_t q = dst[0].imag();
+
+    BitReader reader{payload + sizeof(complex16_t), payload + header.payload_size};
+    for (size_t n = 1; n < count; n++) {
+        i += unzigzag(reader.get_rice(header.k_i));
+        q += unzigzag(reader.get_rice(header.k_q));
+        dst[n] = {static_cast<int16_t>(i), static_cast<int16_t>(q)};
+    }
+
+    return !reader.overrun;
+}
+
+size_t BlockParser::push(const uint8_t* const data, const size_t length) {
+    if (start) {
+        memmove(window.data(), &window[start], fill - start);
+        fill -= start;
+        last -= std::min(last, start);
+        start = 0;
+    }
+
+    const size_t taken = std::min(window.size() - fill, length);
+    memcpy(&window[fill], data, taken);
+    fill += taken;
+    return taken;
+}
+
+const uint8_t* BlockParser::next(BlockHeader& header, const bool end) {
+    while (fill - start >= sizeof(header)) {
+        memcpy(&header, &window[start], sizeof(header));
+        if (!check_block_header(header)) {
+            start++;
+            continue;
+        }
+
+        const size_t size = sizeof(header) + header.payload_size;
+        const size_t available = fill - start;
+        if (available < size + sizeof(block_sync)) {
+            if (!end) {
+                return nullptr;
+            }
+            if (available < size) {
+                // Cut short at the end of the stream
+                start++;
+                continue;
+            }
+        } else {
+            uint16_t sync;
+            memcpy(&sync, &window[start + size], sizeof(sync));
+            if (sync != block_sync) {
+                // The next header is not where this one says, so this
+                // block lost data
+                start++;
+                continue;
+            }
+        }
+
+        last = start;
+        start += size;
+        return &window[last + sizeof(header)];
+    }
+
+    if (end) {
+        start = fill;
+    }
+    return nullptr;
+}
+
+void BlockParser::reject() {
+    start = last + 1;
+}
+
+} /* namespace iq_codec */
@@ -0,0 +1,115 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __IQ_CODEC_H__
+#define __IQ_CODEC_H__
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+
+#include "complex.hpp"
+
+/* Lossless compression of complex16_t captures (.C16Z).
+ *
+ * A .C16Z file is a file_header followed by independent blocks. Each block
+ * stores its first sample as is, then the sample to sample difference of I
+ * and Q, zigzag mapped and Rice coded with one parameter per block and
+ * component. Oversampled, band limited captures change slowly from sample
+ * to sample, so the differences need far fewer than 16 bits. A block that
+ * would not shrink is stored raw instead, so nothing ever grows by more
+ * than the header.
+ */
+namespace iq_codec {
+
+constexpr uint8_t file_magic[4] = {'C', '1', '6', 'Z'};
+constexpr uint16_t file_version = 1;
+
+struct FileHeader {
+    uint8_t magic[4];
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t sample_count;  // Filled in when the capture is closed, 0 until then
+};
+
+constexpr uint16_t block_sync = 0x5A43;
+constexpr uint8_t k_raw = 0xff;
+
+struct BlockHeader {
+    uint16_t sync;
+    uint16_t sample_count;
+    uint16_t payload_size;  // Bytes following the header
+    uint8_t k_i;
+    uint8_t k_q;
+};
+
+static_assert(sizeof(FileHeader) == 16, "FileHeader must be packed");
+static_assert(sizeof(BlockHeader) == 8, "BlockHeader must be packed");
+
+constexpr size_t block_samples_max = 512;
+
+constexpr size_t max_encoded_size(const size_t sample_count) {
+    return sizeof(BlockHeader) + sample_count * sizeof(complex16_t);
+}
+
+FileHeader make_file_header();
+bool check_file_header(const FileHeader& header);
+
+/* Encodes up to block_samples_max samples into dst, which must hold
+ * max_encoded_size(count) bytes. Returns the bytes written. */
+size_t encode_block(const complex16_t* const src, const size_t count, uint8_t* const dst);
+
+/* True if the header is sane, so that payload_size bytes can be read. */
+bool check_block_header(const BlockHeader& header);
+
+/* Decodes a block payload into dst, which must hold header.sample_count
+ * samples. False if the payload is corrupt. */
+bool decode_block(const BlockHeader& header, const uint8_t* const payload, complex16_t* const dst);
+
+/* Splits a .C16Z stream back into whole blocks. A block is only handed out
+ * once the sync word of the one after it has been seen, or the stream has
+ * ended, so a block cut short by dropped data is passed over. Anything
+ * that is not a whole block is skipped by scanning ahead for block_sync
+ * and a header that passes check_block_header(). */
+class BlockParser {
+   public:
+    /* Takes up to length bytes of the stream, returns how many it took. */
+    size_t push(const uint8_t* const data, const size_t length);
+
+    /* The payload of the next whole block, its header in header. nullptr if
+     * more of the stream is needed first, or with end set, if none is left.
+     * The payload stays valid until the next push(). */
+    const uint8_t* next(BlockHeader& header, const bool end = false);
+
+    /* Gives back the block just taken by next(), which turned out to be
+     * corrupt, and resumes the scan one byte past its header. */
+    void reject();
+
+   private:
+    std::array<uint8_t, max_encoded_size(block_samples_max) + sizeof(BlockHeader)> window{};
+    size_t start{0};
+    size_t fill{0};
+    size_t last{0};
+};
+
+} /* namespace iq_codec */
+
+#endif /*__IQ_CODEC_H__*/
@@ -33,6 +33,7 @@
 #include "baseband_packet.hpp"
 
 #include "acars_packet.hpp"
+#include "ais_packet.hpp"
 #include "adsb_frame.hpp"
 #include "ert_packet.hpp"
 #include "pocsag_packet.hpp"
@@ -42,6 +43,7 @@
 #include "jammer.hpp"
 #include "dsp_fir_taps.hpp"
 #include "dsp_iir.hpp"
+#include "capture_format.hpp"
 #include "fifo.hpp"
 
 #include "utility.hpp"
@@ -111,6 +113,9 @@ class Message {
         APRSRxConfigure = 54,
         SpectrumPainterBufferRequestConfigure = 55,
         SpectrumPainterBufferResponseConfigure = 56,
+        MultiChannelStatistics = 57,
+        ReplayRateConfig = 58,
+        BasebandProfile = 59,
         MAX
     };
 
@@ -159,6 +164,39 @@ class BasebandStatisticsMessage : public Message {
     BasebandStatistics statistics;
 };
 
+/* Cycles the baseband thread spent in execute() over a report interval,
+ * also split by the stage of processing they went to. */
+struct BasebandProfile {
+    enum Stage {
+        Other,
+        Decimate,
+        Demodulate,
+        Audio,
+        Spectrum,
+        StageCount
+    };
+
+    uint32_t budget_cycles{0};  // Per buffer, the DMA period
+    uint32_t executes{0};
+    uint32_t deadline_misses{0};
+    uint32_t min_cycles{0};
+    uint32_t avg_cycles{0};
+    uint32_t p99_cycles{0};
+    uint32_t max_cycles{0};
+    std::array<uint32_t, StageCount> stage_cycles{};  // Average per execute()
+};
+
+class BasebandProfileMessage : public Message {
+   public:
+    constexpr BasebandProfileMessage(
+        const BasebandProfile& profile)
+        : Message{ID::BasebandProfile},
+          profile{profile} {
+    }
+
+    BasebandProfile profile;
+};
+
 struct ChannelStatistics {
     int32_t max_db;
     size_t count;
@@ -182,6 +220,18 @@ class ChannelStatisticsMessage : public Message {
     ChannelStatistics statistics;
 };
 
+/* Peak level of each channel of a channelizer, in dB. */
+class MultiChannelStatisticsMessage : public Message {
+   public:
+    static constexpr size_t channel_count = 8;
+
+    constexpr MultiChannelStatisticsMessage()
+        : Message{ID::MultiChannelStatistics} {
+    }
+
+    std::array<int32_t, channel_count> max_db{};
+};
+
 class DisplayFrameSyncMessage : public Message {
    public:
     constexpr DisplayFrameSyncMessage()
@@ -242,13 +292,41 @@ class SpectrumStreamingConfigMessage : public Message {
         Running = 1,
     };
 
+    /* Time-domain window applied before the FFT. */
+    enum class Window : uint32_t {
+        Hamming = 0,
+        None = 1,
+        Hann = 2,
+        BlackmanHarris = 3,
+        FlatTop = 4,
+    };
+
+    /* How successive (half-overlapped) FFT frames are combined on the
+     * baseband before one ChannelSpectrum is sent every averaging_count
+     * frames. */
+    enum class Averaging : uint32_t {
+        None = 0,
+        Mean = 1,  // Welch
+        MaxHold = 2,
+        MinHold = 3,
+    };
+
     constexpr SpectrumStreamingConfigMessage(
-        Mode mode)
+        Mode mode,
+        Window window = Window::Hamming,
+        Averaging averaging = Averaging::None,
+        uint32_t averaging_count = 1)
         : Message{ID::SpectrumStreamingConfig},
-          mode{mode} {
+          mode{mode},
+          window{window},
+          averaging{averaging},
+          averaging_count{averaging_count} {
     }
 
     Mode mode{Mode::Stopped};
+    Window window{Window::Hamming};
+    Averaging averaging{Averaging::None};
+    uint32_t averaging_count{1};
 };
 
 class WidebandSpectrumConfigMessage : public Message {
@@ -307,12 +385,15 @@ class ChannelSpectrumConfigMessage : public Message {
 class AISPacketMessage : public Message {
    public:
     constexpr AISPacketMessage(
-        const baseband::Packet& packet)
+        const baseband::Packet& packet,
+        const ais::Channel channel)
         : Message{ID::AISPacket},
-          packet{packet} {
+          packet{packet},
+          channel{channel} {
     }
 
     baseband::Packet packet;
+    ais::Channel channel;
 };
 
 class TPMSPacketMessage : public Message {
@@ -587,6 +668,19 @@ class StreamBuffer {
         used_ = value;
     }
 
+    // Room after the data so far, to be filled in place and committed.
+    void* tail() const {
+        return &data_[used_];
+    }
+
+    size_t space() const {
+        return capacity_ - used_;
+    }
+
+    void commit(const size_t count) {
+        used_ += count;
+    }
+
     void empty() {
         used_ = 0;
     }
@@ -595,6 +689,7 @@ class StreamBuffer {
 struct CaptureConfig {
     const size_t write_size;
     const size_t buffer_count;
+    const CaptureFormat format;
     uint64_t baseband_bytes_received;
     uint64_t baseband_bytes_dropped;
     FIFO<StreamBuffer*>* fifo_buffers_empty;
@@ -602,9 +697,11 @@ struct CaptureConfig {
 
     constexpr CaptureConfig(
         const size_t write_size,
-        const size_t buffer_count)
+        const size_t buffer_count,
+        const CaptureFormat format = CaptureFormat::C16)
         : write_size{write_size},
           buffer_count{buffer_count},
+          format{format},
           baseband_bytes_received{0},
           baseband_bytes_dropped{0},
           fifo_buffers_empty{nullptr},
@@ -616,7 +713,7 @@ struct CaptureConfig {
             return 0;
         } else {
             const size_t percent = baseband_bytes_dropped * 100U / baseband_bytes_received;
-            return std::max(1U, percent);
+            return std::max<size_t>(1, percent);
         }
     }
 };
@@ -661,6 +758,24 @@ class ReplayConfigMessage : public Message {
     ReplayConfig* const config;
 };
 
+/* Replay resamples the capture by interpolation / decimation to reach the
+ * baseband rate. */
+class ReplayRateConfigMessage : public Message {
+   public:
+    static constexpr uint32_t interpolation_max = 16;
+
+    constexpr ReplayRateConfigMessage(
+        const uint32_t interpolation,
+        const uint32_t decimation)
+        : Message{ID::ReplayRateConfig},
+          interpolation{interpolation},
+          decimation{decimation} {
+    }
+
+    const uint32_t interpolation;
+    const uint32_t decimation;
+};
+
 class TXProgressMessage : public Message {
    public:
     constexpr TXProgressMessage()
@@ -668,6 +783,7 @@ class TXProgressMessage : public Message {
     }
 
     uint32_t progress = 0;
+    uint32_t underruns = 0;  // Times the stream ran dry, where counted
     bool done = false;
 };
 
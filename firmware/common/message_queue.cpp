@@ -24,6 +24,16 @@
 #include "lpc43xx_cpp.hpp"
 using namespace lpc43xx;
 
+/* Timer 3 is started free running by the M0 HAL, clocked like both cores.
+ * The M4 HAL counter is its own cycle counter, so read the timer here. */
+uint32_t MessageQueue::timestamp() {
+    return LPC_TIMER3->TC;
+}
+
+uint32_t MessageQueue::timestamp_frequency() {
+    return halLPCGetSystemClock();
+}
+
 #if defined(LPC43XX_M0)
 void MessageQueue::signal() {
     creg::m0apptxevent::assert_event();
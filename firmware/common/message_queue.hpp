@@ -23,23 +23,75 @@
 #define __MESSAGE_QUEUE_H__
 
 #include <cstdint>
+#include <cstring>
+#include <array>
+#include <algorithm>
 
 #include "message.hpp"
-#include "fifo.hpp"
 
 #include <ch.h>
 
+/* Ring of variable length message records passed from one core to the
+ * other. The producing core writes records and advances in, the consuming
+ * core reads them and advances out, so the two cores never lock each
+ * other out. Threads on the producing core are serialized by a short
+ * critical section around the copy.
+ *
+ * Records are word aligned and never wrap around the end of the ring
+ * (the producer pads to the end instead), so the consumer hands out
+ * messages where they lie rather than copying them out.
+ *
+ * The consumer is woken when a push makes the queue non-empty, not on
+ * every push. set_wakeup() can hold that back further, until enough bytes
+ * are waiting or the oldest waiting message is old enough; producers
+ * that use it call flush() regularly to honour the timeout.
+ *
+ * Each record carries the time it was pushed, read from a counter both
+ * cores share, so the consumer can tell how long it waited. Producer and
+ * consumer each keep their own statistics and never write the other's.
+ */
 class MessageQueue {
    public:
+    /* Bucket n counts messages that waited from 2^(n-1) up to 2^n - 1
+     * timestamp ticks, the last bucket everything longer. */
+    static constexpr size_t latency_buckets = 28;
+
+    struct Statistics {
+        // Producer side
+        uint32_t messages{0};
+        uint32_t wakeups{0};
+        uint32_t drops{0};
+        uint32_t high_water{0};  // Bytes
+
+        // Consumer side
+        uint32_t handled{0};
+        uint32_t latency_max{0};  // Ticks
+        std::array<uint32_t, latency_buckets> latency{};
+    };
+
+    struct IDStatistics {
+        uint32_t messages{0};
+        uint32_t drops{0};
+        uint32_t latency_max{0};  // Ticks
+    };
+
+    /* Free running counter both cores read, see timestamp_frequency(). */
+    static uint32_t timestamp();
+    static uint32_t timestamp_frequency();
+
     MessageQueue() = delete;
     MessageQueue(const MessageQueue&) = delete;
     MessageQueue(MessageQueue&&) = delete;
 
+    /* data must be word aligned. Without wakes_other_core the consumer is
+     * on the same core and is woken by the producer itself. */
     MessageQueue(
         uint8_t* const data,
-        size_t k)
-        : fifo{data, k} {
-        chMtxInit(&mutex_write);
+        size_t k,
+        const bool wakes_other_core = true)
+        : data{data},
+          size{1U << k},
+          wakes_other_core{wakes_other_core} {
     }
 
     template <typename T>
@@ -50,68 +102,183 @@ class MessageQueue {
         return push(&message, sizeof(message));
     }
 
-    template <typename T>
-    bool push_and_wait(const T& message) {
-        const bool result = push(message);
-        if (result) {
-            // TODO: More graceful method of waiting for empty? Maybe sleep for a bit?
-            while (!is_empty())
-                ;
-        }
-        return result;
-    }
-
     template <typename HandlerFn>
     void handle(HandlerFn handler) {
-        std::array<uint8_t, Message::MAX_SIZE> message_buffer;
-        while (Message* const message = peek(message_buffer)) {
+        while (!is_empty()) {
+            __DMB();
+            const size_t offset = out & mask();
+            const uint32_t length = header(offset);
+            if (length == padding) {
+                out += size - offset;
+                continue;
+            }
+
+            Message* const message = reinterpret_cast<Message*>(&data[offset + header_size]);
+            record_latency(message->id, timestamp() - header(offset + sizeof(uint32_t)));
             handler(message);
-            skip();
+
+            // The handler may have reset the queue.
+            if (!is_empty()) {
+                __DMB();
+                out += record_size(length);
+            }
         }
     }
 
     bool is_empty() const {
-        return fifo.is_empty();
+        return in == out;
     }
 
     void reset() {
-        fifo.reset();
+        in = out = 0;
+        waiting = false;
+        wakeup_threshold = 0;
+        wakeup_timeout = 0;
     }
 
-   private:
-    FIFO<uint8_t> fifo;
-    Mutex mutex_write{};
+    /* Wake the consumer once threshold bytes are waiting, or timeout ticks
+     * after the first unsignalled push. Called on the producing core. */
+    void set_wakeup(const size_t threshold, const systime_t timeout) {
+        chSysLock();
+        wakeup_threshold = threshold;
+        wakeup_timeout = timeout;
+        chSysUnlock();
+    }
+
+    /* Wakes the consumer if a held back wakeup has timed out. */
+    void flush() {
+        chSysLock();
+        if (waiting && (chTimeNow() - waiting_since >= wakeup_timeout)) {
+            wake();
+        }
+        chSysUnlock();
+    }
+
+    Statistics statistics() const {
+        return stats;
+    }
 
-    Message* peek(std::array<uint8_t, Message::MAX_SIZE>& buf) {
-        Message* const p = reinterpret_cast<Message*>(buf.data());
-        return fifo.peek_r(buf.data(), buf.size()) ? p : nullptr;
+    IDStatistics statistics(const Message::ID id) const {
+        const size_t index = toUType(id);
+        return (index < id_stats.size()) ? id_stats[index] : IDStatistics{};
     }
 
-    bool skip() {
-        return fifo.skip();
+    /* Not synchronized with the other core, a count it is updating at the
+     * time may survive. */
+    void clear_statistics() {
+        stats = {};
+        id_stats.fill({});
     }
 
-    Message* pop(std::array<uint8_t, Message::MAX_SIZE>& buf) {
-        Message* const p = reinterpret_cast<Message*>(buf.data());
-        return fifo.out_r(buf.data(), buf.size()) ? p : nullptr;
+    size_t capacity() const {
+        return size;
     }
 
     size_t len() const {
-        return fifo.len();
+        return in - out;
+    }
+
+   private:
+    // Length, then timestamp
+    static constexpr size_t header_size = sizeof(uint32_t) * 2;
+    static constexpr uint32_t padding = 0xffffffff;
+
+    uint8_t* const data;
+    const size_t size;
+    const bool wakes_other_core;
+    volatile size_t in{0};
+    volatile size_t out{0};
+
+    // Producer side wakeup state
+    bool waiting{false};
+    systime_t waiting_since{0};
+    size_t wakeup_threshold{0};
+    systime_t wakeup_timeout{0};
+
+    Statistics stats{};
+    std::array<IDStatistics, toUType(Message::ID::MAX)> id_stats{};
+
+    size_t mask() const {
+        return size - 1;
+    }
+
+    static constexpr size_t record_size(const size_t length) {
+        return header_size + ((length + 3) & ~size_t(3));
+    }
+
+    volatile uint32_t& header(const size_t offset) {
+        return *reinterpret_cast<volatile uint32_t*>(&data[offset]);
+    }
+
+    IDStatistics* id_statistics(const Message::ID id) {
+        const size_t index = toUType(id);
+        return (index < id_stats.size()) ? &id_stats[index] : nullptr;
+    }
+
+    void record_latency(const Message::ID id, const uint32_t ticks) {
+        const size_t bucket = ticks ? (32 - __builtin_clz(ticks)) : 0;
+        stats.latency[std::min(bucket, latency_buckets - 1)]++;
+        stats.latency_max = std::max(stats.latency_max, ticks);
+        stats.handled++;
+        if (auto* const s = id_statistics(id)) {
+            s->latency_max = std::max(s->latency_max, ticks);
+        }
     }
 
     bool push(const void* const buf, const size_t len) {
-        chMtxLock(&mutex_write);
-        const auto result = fifo.in_r(buf, len);
-        chMtxUnlock();
+        const size_t footprint = record_size(len);
+        const auto id = reinterpret_cast<const Message*>(buf)->id;
+        auto* const s = id_statistics(id);
+        bool success = false;
 
-        const bool success = (result == len);
-        if (success) {
-            signal();
+        chSysLock();
+        const size_t start = in;
+        const size_t offset = start & mask();
+        const size_t skip = (footprint > size - offset) ? (size - offset) : 0;
+
+        if (skip + footprint <= size - (start - out)) {
+            if (skip) {
+                header(offset) = padding;
+            }
+            const size_t record = (start + skip) & mask();
+            header(record) = len;
+            header(record + sizeof(uint32_t)) = timestamp();
+            memcpy(&data[record + header_size], buf, len);
+            __DMB();
+            in = start + skip + footprint;
+            __DMB();
+
+            stats.messages++;
+            if (s) s->messages++;
+            stats.high_water = std::max<uint32_t>(stats.high_water, in - out);
+
+            // Only the first message into an empty queue needs a wakeup,
+            // the consumer drains everything before it goes idle again.
+            if (out == start) {
+                waiting = true;
+                waiting_since = chTimeNow();
+            }
+            if (waiting && ((in - out >= wakeup_threshold) || (chTimeNow() - waiting_since >= wakeup_timeout))) {
+                wake();
+            }
+            success = true;
+        } else {
+            stats.drops++;
+            if (s) s->drops++;
         }
+        chSysUnlock();
+
         return success;
     }
 
+    void wake() {
+        waiting = false;
+        stats.wakeups++;
+        if (wakes_other_core) {
+            signal();
+        }
+    }
+
     void signal();
 };
 
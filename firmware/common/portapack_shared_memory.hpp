@@ -51,11 +51,11 @@ struct SharedMemory {
     static constexpr size_t application_queue_k = 11;
     static constexpr size_t app_local_queue_k = 11;
 
-    uint8_t application_queue_data[1 << application_queue_k]{0};
-    uint8_t app_local_queue_data[1 << app_local_queue_k]{0};
+    alignas(4) uint8_t application_queue_data[1 << application_queue_k]{0};
+    alignas(4) uint8_t app_local_queue_data[1 << app_local_queue_k]{0};
     const Message* volatile baseband_message{nullptr};
     MessageQueue application_queue{application_queue_data, application_queue_k};
-    MessageQueue app_local_queue{app_local_queue_data, app_local_queue_k};
+    MessageQueue app_local_queue{app_local_queue_data, app_local_queue_k, false};
 
     char m4_panic_msg[32]{0};
 
@@ -65,6 +65,8 @@ struct SharedMemory {
         uint8_t data[512];
     } bb_data{{{{0, 0}}, 0, {0}}};
 
+    // 1 to fill in the m4_* figures below, 2 to also profile the baseband
+    static constexpr uint8_t m4_performance_counter_profile = 2;
     uint8_t volatile request_m4_performance_counter{0};
     uint8_t volatile m4_cpu_usage{0};
     uint16_t volatile m4_stack_usage{0};
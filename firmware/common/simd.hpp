@@ -28,6 +28,63 @@
 
 #include <cstdint>
 
+/* On the host there is no Cortex-M4, so the wrappers below fall back to
+ * bit-exact C implementations. This lets M4 kernels be unit tested and
+ * benchmarked off target.
+ */
+#if defined(__ARM_FEATURE_DSP)
+#define SIMD_OP(cmsis, portable_fn) cmsis
+#else
+#include "simd_portable.hpp"
+#define SIMD_OP(cmsis, portable_fn) portable::portable_fn
+
+/* Kernels that use the CMSIS and LPC43xx M4 intrinsics by name get the same
+ * treatment: their inline assembly is still declared above, so send calls
+ * made from here on to the portable versions instead. */
+#undef __SSAT
+#undef __USAT
+#undef __PKHBT
+#undef __PKHTB
+#undef __SMLALD
+#undef __SMLALDX
+#undef __SMLSLD
+#define __REV16(...) portable::rev16(__VA_ARGS__)
+#define __RBIT(...) portable::rbit(__VA_ARGS__)
+#define __SSAT(...) portable::ssat(__VA_ARGS__)
+#define __USAT(...) portable::usat(__VA_ARGS__)
+#define __QADD(...) portable::qadd(__VA_ARGS__)
+#define __QSUB(...) portable::qsub(__VA_ARGS__)
+#define __PKHBT(...) portable::pkhbt(__VA_ARGS__)
+#define __PKHTB(...) portable::pkhtb(__VA_ARGS__)
+#define __SXTB16(...) portable::sxtb16(__VA_ARGS__)
+#define __SXTH(...) portable::sxth(__VA_ARGS__)
+#define __SXTAH(...) portable::sxtah(__VA_ARGS__)
+#define __BFI(...) portable::bfi(__VA_ARGS__)
+#define __QADD16(...) portable::qadd16(__VA_ARGS__)
+#define __QSUB16(...) portable::qsub16(__VA_ARGS__)
+#define __SHADD16(...) portable::shadd16(__VA_ARGS__)
+#define __SHSUB16(...) portable::shsub16(__VA_ARGS__)
+#define __SMUAD(...) portable::smuad(__VA_ARGS__)
+#define __SMUADX(...) portable::smuadx(__VA_ARGS__)
+#define __SMUSD(...) portable::smusd(__VA_ARGS__)
+#define __SMUSDX(...) portable::smusdx(__VA_ARGS__)
+#define __SMLAD(...) portable::smlad(__VA_ARGS__)
+#define __SMLADX(...) portable::smladx(__VA_ARGS__)
+#define __SMLSD(...) portable::smlsd(__VA_ARGS__)
+#define __SMLSDX(...) portable::smlsdx(__VA_ARGS__)
+#define __SMULBB(...) portable::smulbb(__VA_ARGS__)
+#define __SMULBT(...) portable::smulbt(__VA_ARGS__)
+#define __SMULTB(...) portable::smultb(__VA_ARGS__)
+#define __SMULTT(...) portable::smultt(__VA_ARGS__)
+#define __SMLABB(...) portable::smlabb(__VA_ARGS__)
+#define __SMLATB(...) portable::smlatb(__VA_ARGS__)
+#define __SMULL(...) portable::smull(__VA_ARGS__)
+#define __SMLALD(...) portable::smlald(__VA_ARGS__)
+#define __SMLALDX(...) portable::smlaldx(__VA_ARGS__)
+#define __SMLSLD(...) portable::smlsld(__VA_ARGS__)
+#define __SMMULR(...) portable::smmulr(__VA_ARGS__)
+#endif
+
 struct vec4_s8 {
     union {
         int8_t v[4];
@@ -69,40 +126,73 @@ struct vec2_s16 {
 
 static inline vec4_s8 rev16(const vec4_s8 v) {
     vec4_s8 result;
-    result.w = __REV16(v.w);
+    result.w = SIMD_OP(__REV16, rev16)(v.w);
     return result;
 }
 
 static inline vec4_s8 pkhbt(const vec4_s8 v1, const vec4_s8 v2, const size_t sh = 0) {
     vec4_s8 result;
-    result.w = __PKHBT(v1.w, v2.w, sh);
+    result.w = SIMD_OP(__PKHBT, pkhbt)(v1.w, v2.w, sh);
     return result;
 }
 
 static inline vec2_s16 pkhbt(const vec2_s16 v1, const vec2_s16 v2, const size_t sh = 0) {
     vec2_s16 result;
-    result.w = __PKHBT(v1.w, v2.w, sh);
+    result.w = SIMD_OP(__PKHBT, pkhbt)(v1.w, v2.w, sh);
     return result;
 }
 
 static inline vec2_s16 pkhtb(const vec2_s16 v1, const vec2_s16 v2, const size_t sh = 0) {
     vec2_s16 result;
-    result.w = __PKHTB(v1.w, v2.w, sh);
+    result.w = SIMD_OP(__PKHTB, pkhtb)(v1.w, v2.w, sh);
     return result;
 }
 
 static inline vec2_s16 sxtb16(const vec4_s8 v, const size_t sh = 0) {
     vec2_s16 result;
-    result.w = __SXTB16(v.w, sh);
+    result.w = SIMD_OP(__SXTB16, sxtb16)(v.w, sh);
     return result;
 }
 
 static inline int32_t smlsd(const vec2_s16 v1, const vec2_s16 v2, const int32_t accum) {
-    return __SMLSD(v1.w, v2.w, accum);
+    return SIMD_OP(__SMLSD, smlsd)(v1.w, v2.w, accum);
 }
 
 static inline int32_t smlad(const vec2_s16 v1, const vec2_s16 v2, const int32_t accum) {
-    return __SMLAD(v1.w, v2.w, accum);
+    return SIMD_OP(__SMLAD, smlad)(v1.w, v2.w, accum);
+}
+
+static inline int32_t smladx(const vec2_s16 v1, const vec2_s16 v2, const int32_t accum) {
+    return SIMD_OP(__SMLADX, smladx)(v1.w, v2.w, accum);
+}
+
+static inline int32_t smlsdx(const vec2_s16 v1, const vec2_s16 v2, const int32_t accum) {
+    return SIMD_OP(__SMLSDX, smlsdx)(v1.w, v2.w, accum);
+}
+
+static inline vec2_s16 qadd16(const vec2_s16 v1, const vec2_s16 v2) {
+    vec2_s16 result;
+    result.w = SIMD_OP(__QADD16, qadd16)(v1.w, v2.w);
+    return result;
+}
+
+static inline vec2_s16 qsub16(const vec2_s16 v1, const vec2_s16 v2) {
+    vec2_s16 result;
+    result.w = SIMD_OP(__QSUB16, qsub16)(v1.w, v2.w);
+    return result;
+}
+
+/* Halving add/subtract: ((a + b) >> 1) per lane, never overflows. */
+static inline vec2_s16 shadd16(const vec2_s16 v1, const vec2_s16 v2) {
+    vec2_s16 result;
+    result.w = SIMD_OP(__SHADD16, shadd16)(v1.w, v2.w);
+    return result;
+}
+
+static inline vec2_s16 shsub16(const vec2_s16 v1, const vec2_s16 v2) {
+    vec2_s16 result;
+    result.w = SIMD_OP(__SHSUB16, shsub16)(v1.w, v2.w);
+    return result;
 }
 
 #endif /* defined(LPC43XX_M4) */
@@ -0,0 +1,225 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#ifndef __SIMD_PORTABLE_H__
+#define __SIMD_PORTABLE_H__
+
+/* Plain C++ versions of the Cortex-M4 DSP instructions, bit-exact with the
+ * ARMv7E-M definitions. Used when building for the host, where the CMSIS
+ * inline assembly is not available.
+ */
+
+#include <cstdint>
+
+namespace portable {
+
+constexpr int16_t lo(const uint32_t x) {
+    return static_cast<int16_t>(x & 0xffff);
+}
+
+constexpr int16_t hi(const uint32_t x) {
+    return static_cast<int16_t>(x >> 16);
+}
+
+constexpr uint32_t pack16(const int32_t lo, const int32_t hi) {
+    return (static_cast<uint32_t>(lo) & 0xffff) | (static_cast<uint32_t>(hi) << 16);
+}
+
+constexpr int32_t sat16(const int32_t x) {
+    return (x > 32767) ? 32767 : ((x < -32768) ? -32768 : x);
+}
+
+constexpr int64_t ssat64(const int64_t x) {
+    return (x > INT32_MAX) ? INT32_MAX : ((x < INT32_MIN) ? INT32_MIN : x);
+}
+
+constexpr uint32_t rev16(const uint32_t x) {
+    return ((x & 0x00ff00ff) << 8) | ((x & 0xff00ff00) >> 8);
+}
+
+constexpr uint32_t rbit(uint32_t x) {
+    uint32_t result = 0;
+    for (int i = 0; i < 32; i++) {
+        result = (result << 1) | (x & 1);
+        x >>= 1;
+    }
+    return result;
+}
+
+constexpr uint32_t pkhbt(const uint32_t x, const uint32_t y, const uint32_t sh) {
+    return (x & 0x0000ffff) | ((y << sh) & 0xffff0000);
+}
+
+constexpr uint32_t pkhtb(const uint32_t x, const uint32_t y, const uint32_t sh) {
+    return (x & 0xffff0000) | ((static_cast<uint32_t>(static_cast<int32_t>(y) >> sh)) & 0x0000ffff);
+}
+
+constexpr uint32_t sxtb16(const uint32_t x, const uint32_t sh = 0) {
+    const uint32_t r = (sh == 0) ? x : ((x >> sh) | (x << (32 - sh)));
+    return pack16(static_cast<int8_t>(r & 0xff), static_cast<int8_t>((r >> 16) & 0xff));
+}
+
+constexpr uint32_t qadd16(const uint32_t x, const uint32_t y) {
+    return pack16(sat16(lo(x) + lo(y)), sat16(hi(x) + hi(y)));
+}
+
+constexpr uint32_t qsub16(const uint32_t x, const uint32_t y) {
+    return pack16(sat16(lo(x) - lo(y)), sat16(hi(x) - hi(y)));
+}
+
+constexpr uint32_t shadd16(const uint32_t x, const uint32_t y) {
+    return pack16((lo(x) + lo(y)) >> 1, (hi(x) + hi(y)) >> 1);
+}
+
+constexpr uint32_t shsub16(const uint32_t x, const uint32_t y) {
+    return pack16((lo(x) - lo(y)) >> 1, (hi(x) - hi(y)) >> 1);
+}
+
+/* The Q flag is not modelled; accumulations wrap exactly as on the M4. */
+
+constexpr int32_t wrap32(const int64_t x) {
+    return static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(x)));
+}
+
+constexpr int32_t smlad(const uint32_t x, const uint32_t y, const int32_t acc) {
+    return wrap32(static_cast<int64_t>(lo(x)) * lo(y) + static_cast<int64_t>(hi(x)) * hi(y) + acc);
+}
+
+constexpr int32_t smladx(const uint32_t x, const uint32_t y, const int32_t acc) {
+    return wrap32(static_cast<int64_t>(lo(x)) * hi(y) + static_cast<int64_t>(hi(x)) * lo(y) + acc);
+}
+
+constexpr int32_t smlsd(const uint32_t x, const uint32_t y, const int32_t acc) {
+    return wrap32(static_cast<int64_t>(lo(x)) * lo(y) - static_cast<int64_t>(hi(x)) * hi(y) + acc);
+}
+
+constexpr int32_t smlsdx(const uint32_t x, const uint32_t y, const int32_t acc) {
+    return wrap32(static_cast<int64_t>(lo(x)) * hi(y) - static_cast<int64_t>(hi(x)) * lo(y) + acc);
+}
+
+constexpr int32_t smuad(const uint32_t x, const uint32_t y) {
+    return smlad(x, y, 0);
+}
+
+constexpr int32_t smuadx(const uint32_t x, const uint32_t y) {
+    return smladx(x, y, 0);
+}
+
+constexpr int32_t smusd(const uint32_t x, const uint32_t y) {
+    return smlsd(x, y, 0);
+}
+
+constexpr int32_t smusdx(const uint32_t x, const uint32_t y) {
+    return smlsdx(x, y, 0);
+}
+
+/* Halfword multiplies, b picking the bottom and t the top halfword. */
+
+constexpr int32_t smulbb(const uint32_t x, const uint32_t y) {
+    return lo(x) * lo(y);
+}
+
+constexpr int32_t smulbt(const uint32_t x, const uint32_t y) {
+    return lo(x) * hi(y);
+}
+
+constexpr int32_t smultb(const uint32_t x, const uint32_t y) {
+    return hi(x) * lo(y);
+}
+
+constexpr int32_t smultt(const uint32_t x, const uint32_t y) {
+    return hi(x) * hi(y);
+}
+
+constexpr int32_t smlabb(const uint32_t x, const uint32_t y, const int32_t acc) {
+    return wrap32(static_cast<int64_t>(smulbb(x, y)) + acc);
+}
+
+constexpr int32_t smlatb(const uint32_t x, const uint32_t y, const int32_t acc) {
+    return wrap32(static_cast<int64_t>(smultb(x, y)) + acc);
+}
+
+constexpr int64_t smull(const int32_t x, const int32_t y) {
+    return static_cast<int64_t>(x) * y;
+}
+
+/* 64-bit accumulations wrap, as on the M4. */
+
+constexpr int64_t wrap64(const int64_t acc, const int64_t x) {
+    return static_cast<int64_t>(static_cast<uint64_t>(acc) + static_cast<uint64_t>(x));
+}
+
+constexpr int64_t smlald(const uint32_t x, const uint32_t y, const int64_t acc) {
+    return wrap64(acc, static_cast<int64_t>(lo(x)) * lo(y) + static_cast<int64_t>(hi(x)) * hi(y));
+}
+
+constexpr int64_t smlaldx(const uint32_t x, const uint32_t y, const int64_t acc) {
+    return wrap64(acc, static_cast<int64_t>(lo(x)) * hi(y) + static_cast<int64_t>(hi(x)) * lo(y));
+}
+
+constexpr int64_t smlsld(const uint32_t x, const uint32_t y, const int64_t acc) {
+    return wrap64(acc, static_cast<int64_t>(lo(x)) * lo(y) - static_cast<int64_t>(hi(x)) * hi(y));
+}
+
+/* Most significant word of the product, rounded. */
+constexpr int32_t smmulr(const int32_t x, const int32_t y) {
+    return static_cast<int32_t>((static_cast<int64_t>(x) * y + 0x80000000LL) >> 32);
+}
+
+constexpr int32_t ssat(const int32_t x, const uint32_t bits) {
+    const int32_t max = (1L << (bits - 1)) - 1;
+    return (x > max) ? max : ((x < -max - 1) ? (-max - 1) : x);
+}
+
+constexpr uint32_t usat(const int32_t x, const uint32_t bits) {
+    const int32_t max = (1L << bits) - 1;
+    return (x > max) ? max : ((x < 0) ? 0 : x);
+}
+
+constexpr int32_t qadd(const int32_t x, const int32_t y) {
+    return static_cast<int32_t>(ssat64(static_cast<int64_t>(x) + y));
+}
+
+constexpr int32_t qsub(const int32_t x, const int32_t y) {
+    return static_cast<int32_t>(ssat64(static_cast<int64_t>(x) - y));
+}
+
+constexpr uint32_t ror(const uint32_t x, const uint32_t sh) {
+    return (sh == 0) ? x : ((x >> sh) | (x << (32 - sh)));
+}
+
+constexpr int32_t sxth(const uint32_t x, const uint32_t sh = 0) {
+    return static_cast<int16_t>(ror(x, sh) & 0xffff);
+}
+
+constexpr int32_t sxtah(const uint32_t acc, const uint32_t x, const uint32_t sh = 0) {
+    return static_cast<int32_t>(acc + static_cast<uint32_t>(sxth(x, sh)));
+}
+
+/* Bits [lsb, lsb + width) of x replaced by the bottom bits of y. */
+constexpr uint32_t bfi(const uint32_t x, const uint32_t y, const uint32_t lsb, const uint32_t width) {
+    const uint32_t mask = ((width >= 32) ? 0xffffffff : ((1UL << width) - 1)) << lsb;
+    return (x & ~mask) | ((y << lsb) & mask);
+}
+
+} /* namespace portable */
+
+#endif /*__SIMD_PORTABLE_H__*/
@@ -25,6 +25,7 @@
 #if defined(LPC43XX_M4)
 
 #include <hal.h>
+#include "simd.hpp"
 
 static inline complex32_t multiply_conjugate_s16_s32(const complex16_t::rep_type a, const complex16_t::rep_type b) {
     // conjugate: conj(a + bj) = a - bj
@@ -0,0 +1,282 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "adsb.hpp"
+
+#include <cmath>
+#include <string>
+#include <vector>
+
+using namespace adsb;
+
+namespace {
+
+ADSBFrame make_frame(std::initializer_list<uint8_t> data) {
+    ADSBFrame frame{};
+    for (auto b : data) frame.push_byte(b);
+    return frame;
+}
+
+/* Appends parity to a short or long frame, XORed with overlay. */
+void append_parity(ADSBFrame& frame, std::initializer_list<uint8_t> data, const uint32_t overlay) {
+    std::vector<uint8_t> bytes{data};
+    const uint32_t parity = compute_crc(bytes.data(), bytes.size()) ^ overlay;
+    frame.push_byte(parity >> 16);
+    frame.push_byte(parity >> 8);
+    frame.push_byte(parity);
+}
+
+ADSBFrame frame_from_hex(const std::string& hex, const uint32_t timestamp = 0) {
+    ADSBFrame frame{};
+    for (size_t i = 0; i + 1 < hex.size(); i += 2) {
+        frame.push_byte(std::stoul(hex.substr(i, 2), nullptr, 16));
+    }
+    frame.set_rx_timestamp(timestamp);
+    return frame;
+}
+
+/* NL from its closed form, as in the specification. */
+int closed_form_NL(const double lat) {
+    const double pi = 3.14159265358979323846;
+    if (std::fabs(lat) >= 87.0) return (std::fabs(lat) > 87.0) ? 1 : 2;
+    return static_cast<int>(std::floor(2 * pi / std::acos(1 - (1 - std::cos(pi / 30)) / std::pow(std::cos(pi * lat / 180), 2))));
+}
+
+/* Airborne position pair from "The 1090MHz Riddle", even frame newest. */
+const std::string cpr_even = "8D40621D58C382D690C8AC2863A7";
+const std::string cpr_odd = "8D40621D58C386435CC412692AD6";
+
+}  // namespace
+
+TEST_SUITE_BEGIN("ADS-B Mode S");
+
+TEST_CASE("Extended squitter address is returned only when parity checks.") {
+    auto frame = make_frame({0x8D, 0x48, 0x40, 0xD6, 0x20, 0x2C, 0xC3, 0x71, 0xC3, 0x2C, 0xE0, 0x57, 0x60, 0x98});
+    CHECK(frame.length_bits() == 112);
+    CHECK(checked_ICAO_address(frame) == 0x4840D6);
+
+    frame.flip_bit(60);
+    CHECK(checked_ICAO_address(frame) == 0);
+}
+
+TEST_CASE("All-call reply tolerates an interrogator identifier.") {
+    std::initializer_list<uint8_t> data{0x5D, 0x48, 0x40, 0xD6};
+    auto frame = make_frame(data);
+    append_parity(frame, data, 0x15);
+    CHECK(frame.length_bits() == 56);
+    CHECK(checked_ICAO_address(frame) == 0x4840D6);
+}
+
+TEST_CASE("Address/parity frame syndrome is the sender's address.") {
+    std::initializer_list<uint8_t> data{0x20, 0x00, 0x0B, 0x18};
+    auto frame = make_frame(data);
+    append_parity(frame, data, 0x4840D6);
+
+    CHECK(has_address_parity(frame.get_DF()));
+    CHECK_FALSE(frame.check_CRC());
+    CHECK(frame.syndrome() == 0x4840D6);
+    CHECK(checked_ICAO_address(frame) == 0);
+}
+
+TEST_CASE("Altitude code with Q bit decodes in 25ft steps.") {
+    const uint32_t n = (38000 + 1000) / 25;
+    const uint16_t ac13 = ((n >> 5) << 7) | (((n >> 4) & 1) << 5) | 0x10 | (n & 0xF);
+    auto frame = make_frame({0x20, 0x00, static_cast<uint8_t>(ac13 >> 8), static_cast<uint8_t>(ac13)});
+
+    int32_t altitude = 0;
+    CHECK(decode_frame_altitude(frame, altitude));
+    CHECK(altitude == 38000);
+}
+
+TEST_CASE("Gillham altitude code decodes in 100ft steps.") {
+    // C2 alone is the lowest code, -1000ft
+    auto frame = make_frame({0x20, 0x00, 0x04, 0x00});
+    int32_t altitude = 0;
+    CHECK(decode_frame_altitude(frame, altitude));
+    CHECK(altitude == -1000);
+
+    // Metric and empty codes are not reported
+    auto metric = make_frame({0x20, 0x00, 0x04, 0x40});
+    CHECK_FALSE(decode_frame_altitude(metric, altitude));
+    auto empty = make_frame({0x20, 0x00, 0x00, 0x00});
+    CHECK_FALSE(decode_frame_altitude(empty, altitude));
+}
+
+TEST_CASE("Squawk decoding inverts encode_frame_squawk.") {
+    for (const uint16_t squawk : {00000, 07421, 07700, 01234, 07777}) {
+        ADSBFrame frame{};
+        encode_frame_squawk(frame, squawk);
+        CHECK(decode_frame_squawk(frame) == squawk);
+    }
+}
+
+TEST_CASE("Address set finds recent addresses and forgets old ones.") {
+    ICAOAddressSet set{};
+    CHECK_FALSE(set.contains(0x4840D6, 0));
+
+    set.insert(0x4840D6, 10);
+    CHECK(set.contains(0x4840D6, 10));
+    CHECK(set.contains(0x4840D6, 10 + ICAOAddressSet::max_age));
+    CHECK_FALSE(set.contains(0x4840D6, 11 + ICAOAddressSet::max_age));
+    CHECK_FALSE(set.contains(0x4840D7, 10));
+
+    // Refreshing keeps it alive
+    set.insert(0x4840D6, 100);
+    CHECK(set.contains(0x4840D6, 120));
+
+    // Zero is never an address
+    set.insert(0, 120);
+    CHECK_FALSE(set.contains(0, 120));
+}
+
+TEST_CASE("Address set holds a busy sky and recycles expired slots.") {
+    ICAOAddressSet set{};
+    uint32_t address = 0x400000;
+    for (uint32_t now = 0; now < 1000; now++) {
+        for (size_t i = 0; i < 2; i++) {
+            set.insert(address + (now * 2 + i) * 7919, now);
+        }
+    }
+    // The last max_age seconds' worth of 2 per second all fit.
+    for (uint32_t now = 1000 - ICAOAddressSet::max_age; now < 1000; now++) {
+        for (size_t i = 0; i < 2; i++) {
+            CHECK(set.contains(address + (now * 2 + i) * 7919, 999));
+        }
+    }
+    CHECK_FALSE(set.contains(address, 999));
+}
+
+TEST_CASE("Longitude zone table matches the closed form.") {
+    CHECK(cpr_NL(0.0f) == 59);
+    CHECK(cpr_NL(52.2572f) == 36);
+    CHECK(cpr_NL(-52.2572f) == 36);
+    CHECK(cpr_NL(86.9f) == 2);
+    CHECK(cpr_NL(87.1f) == 1);
+    CHECK(cpr_NL(-90.0f) == 1);
+
+    for (int i = -8999; i <= 8999; i++) {
+        const float lat = i * 0.01f + 0.003f;
+        CHECK(cpr_NL(lat) == closed_form_NL(lat));
+    }
+}
+
+TEST_CASE("Known CPR pair decodes globally.") {
+    auto even = frame_from_hex(cpr_even, 2);
+    auto odd = frame_from_hex(cpr_odd, 0);
+
+    const auto cpr = decode_frame_cpr(even);
+    CHECK(cpr.lat == 93000);
+    CHECK(cpr.lon == 51372);
+    CHECK_FALSE(cpr.odd);
+    CHECK(decode_frame_cpr(odd).lat == 74158);
+    CHECK(decode_frame_cpr(odd).lon == 50194);
+    CHECK(decode_frame_cpr(odd).odd);
+
+    const auto pos = decode_frame_pos(even, odd);
+    REQUIRE(pos.valid);
+    CHECK(pos.latitude == doctest::Approx(52.25720).epsilon(1e-6));
+    CHECK(pos.longitude == doctest::Approx(3.91937).epsilon(1e-5));
+    CHECK(pos.altitude == 38000);
+}
+
+TEST_CASE("Known CPR frame decodes locally against a reference.") {
+    auto even = frame_from_hex(cpr_even);
+    float lat, lon;
+    REQUIRE(cpr_decode_local(decode_frame_cpr(even), 52.258f, 3.918f, lat, lon));
+    CHECK(lat == doctest::Approx(52.25720).epsilon(1e-6));
+    CHECK(lon == doctest::Approx(3.91937).epsilon(1e-5));
+}
+
+TEST_CASE("Encoded positions decode back in every quadrant.") {
+    const float places[][2] = {
+        {52.2572f, 3.91937f},
+        {-33.9461f, 151.1772f},
+        {40.6413f, -73.7781f},
+        {-22.8089f, -43.2436f},
+        {0.01f, 179.99f},
+        {71.2906f, -156.7886f},
+        {-77.8463f, 166.6682f},
+    };
+
+    for (const auto& place : places) {
+        ADSBFrame even{}, odd{};
+        encode_frame_pos(even, 0x4840D6, 12000, place[0], place[1], 0);
+        encode_frame_pos(odd, 0x4840D6, 12000, place[0], place[1], 1);
+
+        for (const bool use_odd : {false, true}) {
+            float lat, lon;
+            REQUIRE(cpr_decode_global(decode_frame_cpr(even), decode_frame_cpr(odd), use_odd, lat, lon));
+            CHECK(lat == doctest::Approx(place[0]).epsilon(1e-4));
+            CHECK(lon == doctest::Approx(place[1]).epsilon(1e-4));
+
+            // A reference 1 degree off still lands in the right zone
+            REQUIRE(cpr_decode_local(decode_frame_cpr(use_odd ? odd : even), place[0] + 1.0f, place[1] - 1.0f, lat, lon));
+            CHECK(lat == doctest::Approx(place[0]).epsilon(1e-4));
+            CHECK(lon == doctest::Approx(place[1]).epsilon(1e-4));
+        }
+
+        int32_t altitude;
+        REQUIRE(decode_frame_altitude(even, altitude));
+        CHECK(altitude == 12000);
+    }
+}
+
+TEST_CASE("Tracker decodes single frames once it has a fix.") {
+    CPRTracker tracker{};
+    float lat = 48.0f;
+    float lon = 11.0f;
+    auto frame_at = [&lat, &lon](const uint32_t parity) {
+        ADSBFrame frame{};
+        encode_frame_pos(frame, 0x3C6586, 35000, lat, lon, parity);
+        return decode_frame_cpr(frame);
+    };
+
+    // One parity alone gives nothing
+    CHECK_FALSE(tracker.update(frame_at(0), 0));
+    CHECK_FALSE(tracker.valid());
+
+    // A partner heard too late gives nothing either
+    CHECK_FALSE(tracker.update(frame_at(1), CPRTracker::pair_timeout + 1));
+
+    // A fresh pair gives a fix
+    CHECK(tracker.update(frame_at(0), CPRTracker::pair_timeout + 2));
+    REQUIRE(tracker.valid());
+    CHECK(tracker.latitude() == doctest::Approx(lat).epsilon(1e-4));
+
+    // From then on only even frames arrive, each one gives a position
+    uint32_t now = CPRTracker::pair_timeout * 3;
+    for (size_t n = 0; n < 30; n++, now += 2) {
+        lat += 0.01f;
+        lon += 0.02f;
+        CHECK(tracker.update(frame_at(0), now));
+        CHECK(tracker.latitude() == doctest::Approx(lat).epsilon(1e-4));
+        CHECK(tracker.longitude() == doctest::Approx(lon).epsilon(1e-4));
+    }
+
+    // Until the last fix is too old to trust
+    CHECK_FALSE(tracker.update(frame_at(0), now + CPRTracker::reference_timeout + 1));
+
+    tracker.reset();
+    CHECK_FALSE(tracker.valid());
+}
+
+TEST_SUITE_END();
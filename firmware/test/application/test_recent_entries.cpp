@@ -0,0 +1,211 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "recent_entries_container.hpp"
+
+#include <chrono>
+#include <list>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct TestEntry {
+    using Key = uint32_t;
+    static constexpr Key invalid_key = 0xffffffff;
+
+    uint32_t id;
+    uint32_t hits{0};
+    std::string name{};
+
+    TestEntry(const uint32_t id)
+        : id{id} {
+    }
+
+    Key key() const {
+        return id;
+    }
+};
+
+struct PairEntry {
+    using Key = std::pair<uint8_t, uint32_t>;
+
+    Key k;
+
+    PairEntry(const Key& k)
+        : k{k} {
+    }
+
+    Key key() const {
+        return k;
+    }
+};
+
+template <typename Container>
+std::vector<uint32_t> keys_of(const Container& entries) {
+    std::vector<uint32_t> keys;
+    for (const auto& e : entries) keys.push_back(e.key());
+    return keys;
+}
+
+struct LCG {
+    uint32_t state{1};
+    uint32_t next() {
+        state = state * 1664525 + 1013904223;
+        return state >> 8;
+    }
+};
+
+/* The behaviour being replaced: std::list with linear find. */
+TestEntry& list_on_packet(std::list<TestEntry>& entries, const uint32_t key, const size_t max) {
+    auto it = std::find_if(entries.begin(), entries.end(), [key](const TestEntry& e) { return e.key() == key; });
+    if (it != entries.end()) {
+        entries.push_front(*it);
+        entries.erase(it);
+    } else {
+        entries.emplace_front(key);
+        while (entries.size() > max) entries.pop_back();
+    }
+    return entries.front();
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("RecentEntries");
+
+TEST_CASE("New and updated entries move to the front.") {
+    RecentEntries<TestEntry, 8> entries{};
+    CHECK(entries.empty());
+
+    on_packet(entries, 1u).hits++;
+    on_packet(entries, 2u).hits++;
+    on_packet(entries, 3u).hits++;
+    CHECK(keys_of(entries) == std::vector<uint32_t>{3, 2, 1});
+
+    auto& e = on_packet(entries, 1u);
+    e.hits++;
+    CHECK(keys_of(entries) == std::vector<uint32_t>{1, 3, 2});
+    CHECK(find(entries, 1u)->hits == 2);
+    CHECK(entries.front().key() == 1);
+    CHECK(entries.back().key() == 2);
+    CHECK(find(entries, 4u) == std::end(entries));
+}
+
+TEST_CASE("Inserting into a full container evicts the least recent entry.") {
+    RecentEntries<TestEntry, 4> entries{};
+    for (uint32_t k = 0; k < 10; k++) {
+        on_packet(entries, k);
+    }
+    CHECK(entries.size() == 4);
+    CHECK(keys_of(entries) == std::vector<uint32_t>{9, 8, 7, 6});
+    CHECK(find(entries, 5u) == std::end(entries));
+}
+
+TEST_CASE("Matches std::list under a random packet stream.") {
+    RecentEntries<TestEntry, 64> entries{};
+    std::list<TestEntry> reference{};
+    LCG rng{};
+
+    for (size_t n = 0; n < 20000; n++) {
+        const uint32_t key = rng.next() % 100;
+        on_packet(entries, key).hits++;
+        list_on_packet(reference, key, 64).hits++;
+
+        if ((n % 97) == 0) {
+            truncate_entries(entries, 40);
+            while (reference.size() > 40) reference.pop_back();
+        }
+    }
+
+    REQUIRE(entries.size() == reference.size());
+    auto it = reference.begin();
+    for (const auto& e : entries) {
+        CHECK(e.key() == it->key());
+        CHECK(e.hits == it->hits);
+        ++it;
+    }
+    for (uint32_t key = 0; key < 100; key++) {
+        const bool in_reference = std::any_of(reference.begin(), reference.end(), [key](const TestEntry& e) { return e.key() == key; });
+        CHECK((find(entries, key) != std::end(entries)) == in_reference);
+    }
+}
+
+TEST_CASE("Erasing through reverse iterators and sorting keep the index valid.") {
+    RecentEntries<TestEntry, 16> entries{};
+    for (uint32_t k = 0; k < 16; k++) {
+        on_packet(entries, k * 1000);
+    }
+
+    // Remove odd ones from the back, as the ADS-B view ages entries out.
+    auto it = entries.rbegin();
+    while (it != entries.rend()) {
+        if ((it->key() / 1000) & 1) {
+            std::advance(it, 1);
+            entries.erase(it.base());
+        } else {
+            ++it;
+        }
+    }
+    CHECK(keys_of(entries) == std::vector<uint32_t>{14000, 12000, 10000, 8000, 6000, 4000, 2000, 0});
+
+    entries.sort([](const TestEntry& a, const TestEntry& b) { return (a.key() % 3000) < (b.key() % 3000); });
+    CHECK(keys_of(entries) == std::vector<uint32_t>{12000, 6000, 0, 10000, 4000, 14000, 8000, 2000});
+
+    for (uint32_t k = 0; k < 16; k++) {
+        CHECK((find(entries, k * 1000) != std::end(entries)) == !(k & 1));
+    }
+    CHECK(std::prev(std::end(entries))->key() == 2000);
+}
+
+TEST_CASE("Pair keys hash through both members.") {
+    RecentEntries<PairEntry, 8> entries{};
+    on_packet(entries, PairEntry::Key{1, 5});
+    on_packet(entries, PairEntry::Key{2, 5});
+    CHECK(entries.size() == 2);
+    CHECK(find(entries, PairEntry::Key{1, 5}) != std::end(entries));
+    CHECK(find(entries, PairEntry::Key{3, 5}) == std::end(entries));
+}
+
+TEST_CASE("Benchmark lookups against std::list.") {
+    for (const size_t count : {16, 64, 256}) {
+        constexpr size_t packets = 100000;
+        LCG rng{};
+        std::vector<uint32_t> keys(packets);
+        for (auto& k : keys) k = 0x400000 + rng.next() % count;
+
+        std::list<TestEntry> reference{};
+        auto start = std::chrono::steady_clock::now();
+        for (const auto k : keys) list_on_packet(reference, k, 1024).hits++;
+        const double list_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / packets;
+
+        static RecentEntries<TestEntry, 1024> entries{};
+        entries.clear();
+        start = std::chrono::steady_clock::now();
+        for (const auto k : keys) on_packet(entries, k).hits++;
+        const double table_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / packets;
+
+        CHECK(entries.size() == reference.size());
+        MESSAGE("RecentEntries with " << count << " live entries: " << table_ns << " ns/packet, std::list " << list_ns << " ns/packet");
+    }
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,131 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "doctest.h"
+#include "capture_format.hpp"
+
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+
+using namespace capture_format;
+
+namespace {
+
+struct LCG {
+    uint32_t state{4242};
+    uint32_t next() {
+        state = state * 1664525 + 1013904223;
+        return state;
+    }
+};
+
+std::vector<complex16_t> random_samples(const size_t count) {
+    LCG rng{};
+    std::vector<complex16_t> samples(count);
+    for (auto& s : samples) {
+        const uint32_t r = rng.next();
+        s = {static_cast<int16_t>(r), static_cast<int16_t>(r >> 16)};
+    }
+    return samples;
+}
+
+/* Largest difference between the original and the packed and unpacked
+ * samples, counting saturation of the top values as no error. */
+int max_error(const CaptureFormat format, const std::vector<complex16_t>& samples) {
+    std::vector<uint8_t> packed(samples.size() * capture_sample_size(format));
+    std::vector<complex16_t> unpacked(samples.size());
+    REQUIRE(pack(format, samples.data(), samples.size(), packed.data()) == packed.size());
+    unpack(format, packed.data(), samples.size(), unpacked.data());
+
+    const int top = 32768 - (format == CaptureFormat::C8 ? 256 : 16);
+    int error = 0;
+    for (size_t n = 0; n < samples.size(); n++) {
+        const int i = samples[n].real(), q = samples[n].imag();
+        if ((i < top) && (q < top)) {
+            error = std::max(error, std::abs(i - unpacked[n].real()));
+            error = std::max(error, std::abs(q - unpacked[n].imag()));
+        }
+    }
+    return error;
+}
+
+}  // namespace
+
+TEST_CASE("Packed capture formats are 25% and 50% smaller than C16.") {
+    CHECK(capture_sample_size(CaptureFormat::C16) == sizeof(complex16_t));
+    CHECK(capture_sample_size(CaptureFormat::C12) * 4 == sizeof(complex16_t) * 3);
+    CHECK(capture_sample_size(CaptureFormat::C8) * 2 == sizeof(complex16_t));
+}
+
+TEST_CASE("C12 keeps the top 12 bits, rounded.") {
+    const auto samples = random_samples(4096);
+    CHECK(max_error(CaptureFormat::C12, samples) <= 8);
+
+    // Values on the 12 bit grid come back exactly, including the extremes.
+    const std::vector<complex16_t> grid{{-32768, 32752}, {16, -16}, {0, 0}, {-2048 * 16, 2047 * 16}};
+    uint8_t packed[12];
+    complex16_t unpacked[4];
+    pack_c12(grid.data(), grid.size(), packed);
+    unpack_c12(packed, grid.size(), unpacked);
+    for (size_t n = 0; n < grid.size(); n++) {
+        CHECK(unpacked[n].real() == grid[n].real());
+        CHECK(unpacked[n].imag() == grid[n].imag());
+    }
+}
+
+TEST_CASE("C8 keeps the top 8 bits, rounded and saturated.") {
+    const auto samples = random_samples(4096);
+    CHECK(max_error(CaptureFormat::C8, samples) <= 128);
+
+    const complex16_t extremes[2] = {{32767, -32768}, {127, -129}};
+    uint8_t packed[4];
+    pack_c8(extremes, 2, packed);
+    CHECK(static_cast<int8_t>(packed[0]) == 127);
+    CHECK(static_cast<int8_t>(packed[1]) == -128);
+    CHECK(static_cast<int8_t>(packed[2]) == 0);
+    CHECK(static_cast<int8_t>(packed[3]) == -1);
+}
+
+TEST_CASE("Packed samples expand in place from the end of the buffer.") {
+    for (const auto format : {CaptureFormat::C8, CaptureFormat::C12}) {
+        const size_t count = 512;
+        const size_t sample_size = capture_sample_size(format);
+        const auto samples = random_samples(count);
+
+        std::vector<complex16_t> expected(count);
+        std::vector<uint8_t> packed(count * sample_size);
+        pack(format, samples.data(), count, packed.data());
+        unpack(format, packed.data(), count, expected.data());
+
+        std::vector<complex16_t> buffer(count);
+        auto bytes = reinterpret_cast<uint8_t*>(buffer.data());
+        auto tail = bytes + count * sizeof(complex16_t) - packed.size();
+        std::copy(packed.begin(), packed.end(), tail);
+        unpack(format, tail, count, buffer.data());
+
+        for (size_t n = 0; n < count; n++) {
+            CHECK(buffer[n].real() == expected[n].real());
+            CHECK(buffer[n].imag() == expected[n].imag());
+        }
+    }
+}
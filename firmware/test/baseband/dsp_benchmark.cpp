@@ -0,0 +1,624 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Runs the baseband kernels over synthetic IQ, and over a capture when
+ * DSP_C8_FILE names one, checking each against the float models in
+ * dsp_reference.hpp and reporting host time per input sample.
+ *
+ * The fixed point kernels must land on the reference rounded the way they
+ * round, so any change to one that alters its output fails here. */
+
+#include "doctest.h"
+#include "dsp_reference.hpp"
+
+#include "channel_decimator.hpp"
+#include "dsp_decimate.hpp"
+#include "dsp_demodulate.hpp"
+#include "dsp_fir_taps.hpp"
+#include "matched_filter.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace dsp::reference;
+using namespace dsp::decimate;
+
+namespace {
+
+constexpr size_t block_size = 2048;
+constexpr size_t iterations = 500;
+
+struct LCG {
+    uint32_t state{12345};
+    uint32_t next() {
+        state = state * 1664525 + 1013904223;
+        return state;
+    }
+    double noise() {
+        return ((next() >> 8) * (1.0 / 16777216.0)) - 0.5;
+    }
+};
+
+/* A few tones spread over the band plus noise, scaled to amplitude. */
+std::vector<complex_t> make_signal(const size_t length, const double amplitude) {
+    constexpr double tones[]{0.0012, -0.031, 0.117, -0.26, 0.43};
+    LCG rng{};
+    std::vector<complex_t> x(length);
+    for (size_t n = 0; n < length; n++) {
+        complex_t sum{rng.noise(), rng.noise()};
+        for (const auto f : tones) {
+            sum += std::polar(1.0, 2.0 * M_PI * f * n);
+        }
+        x[n] = sum * (amplitude / 6.0);
+    }
+    return x;
+}
+
+/* Constant envelope, frequency swinging by up to deviation_max of fs. */
+std::vector<complex_t> make_fm(const size_t length, const double amplitude, const double deviation_max) {
+    constexpr double tones[]{0.0021, 0.0143, 0.0377};
+    std::vector<complex_t> x(length);
+    double phase = 0.0;
+    for (size_t n = 0; n < length; n++) {
+        double f = 0.0;
+        for (const auto t : tones) {
+            f += std::sin(2.0 * M_PI * t * n);
+        }
+        phase += 2.0 * M_PI * deviation_max * f / 3.0;
+        x[n] = std::polar(amplitude, phase);
+    }
+    return x;
+}
+
+template <typename T>
+std::vector<std::complex<T>> quantize(const std::vector<complex_t>& x) {
+    std::vector<std::complex<T>> result(x.size());
+    for (size_t n = 0; n < x.size(); n++) {
+        result[n] = {static_cast<T>(std::lround(x[n].real())), static_cast<T>(std::lround(x[n].imag()))};
+    }
+    return result;
+}
+
+/* Runs a block-wise kernel over all of src, in blocks of block_size. */
+template <typename Out, typename In, typename Kernel>
+std::vector<Out> run_blocks(Kernel& kernel, std::vector<In>& src, const size_t ratio) {
+    std::vector<Out> dst(src.size() / ratio);
+    for (size_t offset = 0; offset + block_size <= src.size(); offset += block_size) {
+        kernel.execute({&src[offset], block_size, 0}, {&dst[offset / ratio], block_size / ratio, 0});
+    }
+    return dst;
+}
+
+template <typename Out, typename In, typename Kernel>
+double time_blocks(Kernel& kernel, std::vector<In>& src, const size_t ratio) {
+    std::vector<Out> dst(block_size / ratio);
+    return ns_per_sample(block_size, iterations, [&]() {
+        kernel.execute({src.data(), block_size, 0}, {dst.data(), block_size / ratio, 0});
+    });
+}
+
+/* Reference scaled the way SMMULR and the 16 bit pack see it. */
+constexpr double smmulr_scale(const int32_t scale) {
+    return 4294967296.0 / scale;
+}
+
+std::vector<complex8_t> read_c8(const char* const path) {
+    std::ifstream in{path, std::ios::binary};
+    std::vector<char> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+    std::vector<complex8_t> samples(bytes.size() / sizeof(complex8_t));
+    memcpy(samples.data(), bytes.data(), samples.size() * sizeof(complex8_t));
+    return samples;
+}
+
+}  // namespace
+
+TEST_CASE("FIRC8xR16x24FS4Decim8 matches the shifted FIR to the LSB.") {
+    auto x = quantize<int8_t>(make_signal(block_size * 8, 100.0));
+    const auto& taps = taps_16k0_decim_0.taps;
+
+    for (const auto shift : {FIRC8xR16x24FS4Decim8::Shift::Down, FIRC8xR16x24FS4Decim8::Shift::Up}) {
+        FIRC8xR16x24FS4Decim8 decim{};
+        decim.configure(taps, 33554432, shift);
+        const auto y = run_blocks<complex16_t>(decim, x, 8);
+        const auto expected = fir_decimate(to_complex(x), fs4_shifted_taps(taps, shift == FIRC8xR16x24FS4Decim8::Shift::Down), 8);
+        CHECK(max_error(y, expected, smmulr_scale(33554432)) <= 0.5);
+    }
+
+    FIRC8xR16x24FS4Decim8 decim{};
+    decim.configure(taps, 33554432);
+    MESSAGE("FIRC8xR16x24FS4Decim8: " << time_blocks<complex16_t>(decim, x, 8) << " ns per input sample");
+}
+
+TEST_CASE("FIRC8xR16x24FS4Decim4 matches the shifted FIR to the LSB.") {
+    auto x = quantize<int8_t>(make_signal(block_size * 8, 100.0));
+    const auto& taps = taps_200k_wfm_decim_0.taps;
+
+    FIRC8xR16x24FS4Decim4 decim{};
+    decim.configure(taps, 33554432);
+    const auto y = run_blocks<complex16_t>(decim, x, 4);
+    const auto expected = fir_decimate(to_complex(x), fs4_shifted_taps(taps, true), 4);
+    CHECK(max_error(y, expected, smmulr_scale(33554432)) <= 0.5);
+    MESSAGE("FIRC8xR16x24FS4Decim4: " << time_blocks<complex16_t>(decim, x, 4) << " ns per input sample");
+}
+
+TEST_CASE("FIRC16xR16x32Decim8 matches the FIR to the LSB.") {
+    auto x = quantize<int16_t>(make_signal(block_size * 8, 8000.0));
+    const auto& taps = taps_16k0_decim_1.taps;
+
+    FIRC16xR16x32Decim8 decim{};
+    decim.configure(taps, 131072);
+    const auto y = run_blocks<complex16_t>(decim, x, 8);
+    const auto expected = fir_decimate(to_complex(x), oldest_first_taps(taps), 8);
+    CHECK(max_error(y, expected, smmulr_scale(131072)) <= 0.5);
+    MESSAGE("FIRC16xR16x32Decim8: " << time_blocks<complex16_t>(decim, x, 8) << " ns per input sample");
+}
+
+TEST_CASE("FIRC16xR16x16Decim2 matches the FIR to the LSB.") {
+    auto x = quantize<int16_t>(make_signal(block_size * 8, 8000.0));
+    const auto& taps = taps_200k_wfm_decim_1.taps;
+
+    FIRC16xR16x16Decim2 decim{};
+    decim.configure(taps, 131072);
+    const auto y = run_blocks<complex16_t>(decim, x, 2);
+    const auto expected = fir_decimate(to_complex(x), oldest_first_taps(taps), 2);
+    CHECK(max_error(y, expected, smmulr_scale(131072)) <= 0.5);
+    MESSAGE("FIRC16xR16x16Decim2: " << time_blocks<complex16_t>(decim, x, 2) << " ns per input sample");
+}
+
+TEST_CASE("FIRDecimator takes other shapes from the taps alone.") {
+    SUBCASE("complex8, 32 taps, by 8, no shift") {
+        auto x = quantize<int8_t>(make_signal(block_size * 8, 100.0));
+        const auto& taps = taps_16k0_decim_1.taps;
+        FIRDecimator<complex8_t, 32, 8, false> decim{};
+        decim.configure(taps, 33554432);
+        const auto y = run_blocks<complex16_t>(decim, x, 8);
+        CHECK(max_error(y, fir_decimate(to_complex(x), oldest_first_taps(taps), 8), smmulr_scale(33554432)) <= 0.5);
+    }
+
+    SUBCASE("complex16, 24 taps, by 4, shifted") {
+        auto x = quantize<int16_t>(make_signal(block_size * 8, 8000.0));
+        const auto& taps = taps_200k_wfm_decim_0.taps;
+        using Decimator = FIRDecimator<complex16_t, 24, 4, true>;
+        for (const auto shift : {Decimator::Shift::Down, Decimator::Shift::Up}) {
+            Decimator decim{};
+            decim.configure(taps, 131072, shift);
+            const auto y = run_blocks<complex16_t>(decim, x, 4);
+            const auto expected = fir_decimate(to_complex(x), fs4_shifted_taps(taps, shift == Decimator::Shift::Down), 4);
+            CHECK(max_error(y, expected, smmulr_scale(131072)) <= 0.5);
+        }
+    }
+}
+
+TEST_CASE("Decimation taps are symmetric, as FIRDecimator needs.") {
+    const auto symmetric = [](const auto& taps) {
+        return std::equal(taps.cbegin(), taps.cend(), taps.crbegin());
+    };
+    CHECK(symmetric(taps_16k0_decim_0.taps));
+    CHECK(symmetric(taps_16k0_decim_1.taps));
+    CHECK(symmetric(taps_11k0_decim_0.taps));
+    CHECK(symmetric(taps_11k0_decim_1.taps));
+    CHECK(symmetric(taps_4k25_decim_0.taps));
+    CHECK(symmetric(taps_4k25_decim_1.taps));
+    CHECK(symmetric(taps_6k0_decim_0.taps));
+    CHECK(symmetric(taps_6k0_decim_1.taps));
+    CHECK(symmetric(taps_200k_wfm_decim_0.taps));
+    CHECK(symmetric(taps_200k_wfm_decim_1.taps));
+    CHECK(symmetric(taps_180k_wfm_decim_0.taps));
+    CHECK(symmetric(taps_180k_wfm_decim_1.taps));
+    CHECK(symmetric(taps_40k_wfm_decim_0.taps));
+    CHECK(symmetric(taps_40k_wfm_decim_1.taps));
+    CHECK(symmetric(taps_200k_decim_0.taps));
+    CHECK(symmetric(taps_200k_decim_1.taps));
+}
+
+TEST_CASE("FIRAndDecimateComplex matches the FIR, truncated.") {
+    auto x = quantize<int16_t>(make_signal(block_size * 8, 8000.0));
+
+    SUBCASE("Real taps") {
+        const auto& taps = taps_16k0_channel.taps;
+        FIRAndDecimateComplex filter{};
+        filter.configure(taps, 2);
+        const auto y = run_blocks<complex16_t>(filter, x, 2);
+        CHECK(max_error(y, fir_decimate(to_complex(x), taps_of(taps), 2), 65536.0) < 1.0);
+        MESSAGE("FIRAndDecimateComplex, 32 real taps: " << time_blocks<complex16_t>(filter, x, 2) << " ns per input sample");
+    }
+
+    SUBCASE("Complex taps") {
+        const auto& taps = taps_2k8_usb_channel.taps;
+        FIRAndDecimateComplex filter{};
+        filter.configure(taps, 4);
+        const auto y = run_blocks<complex16_t>(filter, x, 4);
+        CHECK(max_error(y, fir_decimate(to_complex(x), taps_of(taps), 4), 65536.0) < 1.0);
+        MESSAGE("FIRAndDecimateComplex, 64 complex taps: " << time_blocks<complex16_t>(filter, x, 4) << " ns per input sample");
+    }
+}
+
+TEST_CASE("CIC decimators match the 1, 3, 3, 1 filter.") {
+    SUBCASE("Complex8DecimateBy2CIC3") {
+        auto x = quantize<int8_t>(make_signal(block_size * 4, 100.0));
+        Complex8DecimateBy2CIC3 cic{};
+        const auto y = run_blocks<complex16_t>(cic, x, 2);
+        CHECK(max_error(y, cic3_decimate_by_2(to_complex(x)), 1.0 / 32.0) == 0.0);
+        MESSAGE("Complex8DecimateBy2CIC3: " << time_blocks<complex16_t>(cic, x, 2) << " ns per input sample");
+    }
+
+    SUBCASE("TranslateByFSOver4AndDecimateBy2CIC3") {
+        auto x = quantize<int8_t>(make_signal(block_size * 4, 100.0));
+        auto translated = to_complex(x);
+        const complex_t rotation[4]{{1.0, 0.0}, {0.0, -1.0}, {-1.0, 0.0}, {0.0, 1.0}};
+        for (size_t n = 0; n < translated.size(); n++) {
+            translated[n] *= rotation[n & 3];
+        }
+        TranslateByFSOver4AndDecimateBy2CIC3 cic{};
+        const auto y = run_blocks<complex16_t>(cic, x, 2);
+        CHECK(max_error(y, cic3_decimate_by_2(translated), 1.0 / 32.0) == 0.0);
+        MESSAGE("TranslateByFSOver4AndDecimateBy2CIC3: " << time_blocks<complex16_t>(cic, x, 2) << " ns per input sample");
+    }
+
+    SUBCASE("DecimateBy2CIC3") {
+        auto x = quantize<int16_t>(make_signal(block_size * 4, 8000.0));
+        DecimateBy2CIC3 cic{};
+        const auto y = run_blocks<complex16_t>(cic, x, 2);
+        CHECK(max_error(y, cic3_decimate_by_2(to_complex(x)), 8.0) < 1.0);
+        MESSAGE("DecimateBy2CIC3: " << time_blocks<complex16_t>(cic, x, 2) << " ns per input sample");
+    }
+}
+
+namespace {
+
+std::vector<complex_t> make_tone(const size_t length, const double amplitude, const double frequency) {
+    std::vector<complex_t> x(length);
+    for (size_t n = 0; n < length; n++) {
+        x[n] = std::polar(amplitude, 2.0 * M_PI * frequency * n);
+    }
+    return x;
+}
+
+/* Level of the tone at frequency (of the output rate) in y, from first. */
+double tone_db(const std::vector<complex16_t>& y, const double frequency, const double amplitude, const size_t first) {
+    complex_t sum{};
+    for (size_t n = first; n < y.size(); n++) {
+        sum += complex_t(y[n].real(), y[n].imag()) * std::polar(1.0, -2.0 * M_PI * frequency * n);
+    }
+    return 20.0 * std::log10(std::abs(sum) / (y.size() - first) / amplitude + 1e-12);
+}
+
+/* Gain of a decimate by 2 stage to a tone at frequency of its input rate,
+ * seen wherever it lands in the output band. */
+template <typename Kernel>
+double stage_gain_db(Kernel& kernel, const double frequency) {
+    constexpr double amplitude = 8000.0;
+    auto x = quantize<int16_t>(make_tone(block_size * 4, amplitude, frequency));
+    const auto y = run_blocks<complex16_t>(kernel, x, 2);
+    return tone_db(y, frequency * 2.0, amplitude, 64);
+}
+
+template <typename Kernel>
+double worst_alias_db(Kernel& kernel) {
+    double worst = -200.0;
+    for (double f = 0.4; f <= 0.5; f += 0.005) {
+        worst = std::max(worst, stage_gain_db(kernel, f));
+    }
+    return worst;
+}
+
+}  // namespace
+
+TEST_CASE("DecimateBy2Halfband matches the halfband FIR to the LSB.") {
+    const auto& taps = taps_halfband_decim.taps;
+    auto x = quantize<int16_t>(make_signal(block_size * 8, 8000.0));
+    const auto expected = fir_decimate(to_complex(x), taps_of(taps), 2);
+
+    DecimateBy2Halfband halfband{taps};
+    const auto y = run_blocks<complex16_t>(halfband, x, 2);
+    CHECK(max_error(y, expected, 32768.0) <= 0.5);
+
+    // In place, as ChannelDecimator runs it
+    DecimateBy2Halfband in_place{taps};
+    for (size_t offset = 0; offset + block_size <= x.size(); offset += block_size) {
+        in_place.execute({&x[offset], block_size, 0}, {&x[offset], block_size / 2, 0});
+        CHECK(std::equal(&y[offset / 2], &y[offset / 2 + block_size / 2], &x[offset]));
+    }
+
+    MESSAGE("DecimateBy2Halfband: " << time_blocks<complex16_t>(halfband, x, 2) << " ns per input sample");
+}
+
+TEST_CASE("Halfband stages keep the passband flat and aliases out, unlike the CIC.") {
+    DecimateBy2Halfband halfband{taps_halfband_decim.taps};
+    DecimateBy2CIC3 cic{};
+
+    const double halfband_droop = stage_gain_db(halfband, 0.1);
+    const double cic_droop = stage_gain_db(cic, 0.1);
+    const double halfband_alias = worst_alias_db(halfband);
+    const double cic_alias = worst_alias_db(cic);
+
+    MESSAGE("Decimate by 2 stage, gain at 0.1 fs: halfband " << halfband_droop << " dB, CIC " << cic_droop << " dB");
+    MESSAGE("Decimate by 2 stage, worst alias from 0.4 to 0.5 fs: halfband " << halfband_alias << " dB, CIC " << cic_alias << " dB");
+    CHECK(halfband_droop > -0.05);
+    CHECK(cic_droop < -1.0);
+    CHECK(halfband_alias < -55.0);
+    CHECK(cic_alias > -35.0);
+}
+
+/* Tones at 1kHz and 0.2 of the 96kHz output rate above the centre for
+ * droop, and tones a multiple of the output rate from 10kHz that alias
+ * onto it. */
+template <typename Decimator>
+void compare_cascade(const std::string& name, const bool check) {
+    constexpr double fs = 3072000.0;
+    constexpr double fs_out = fs / 32;
+    constexpr double amplitude = 120.0;
+    constexpr size_t blocks = 64;
+
+    const auto level_db = [&](const double tone, const double offset) {
+        Decimator decimator{ChannelDecimationFactor::By32};
+        auto x = quantize<int8_t>(make_tone(block_size * blocks, amplitude, (fs / 4 + tone + offset) / fs));
+        std::vector<complex16_t> y;
+        for (size_t b = 0; b < blocks; b++) {
+            const auto out = decimator.execute({&x[b * block_size], block_size, static_cast<uint32_t>(fs)});
+            y.insert(y.end(), out.p, out.p + out.count);
+        }
+        return tone_db(y, tone / fs_out, 1.0, 64);
+    };
+
+    const double droop = level_db(0.2 * fs_out, 0.0) - level_db(1000.0, 0.0);
+    const double wanted = level_db(10000.0, 0.0);
+    double worst = -200.0;
+    for (const int k : {-4, -3, -2, -1, 1, 2, 3, 4}) {
+        worst = std::max(worst, level_db(10000.0, k * fs_out) - wanted);
+    }
+
+    Decimator decimator{ChannelDecimationFactor::By32};
+    auto x = quantize<int8_t>(make_signal(block_size, 100.0));
+    const double ns = ns_per_sample(block_size, iterations, [&]() {
+        decimator.execute({x.data(), block_size, static_cast<uint32_t>(fs)});
+    });
+    MESSAGE(name << " By32: " << droop << " dB at 0.2 fs out, worst alias onto 10kHz "
+                 << worst << " dBc, " << ns * block_size << " ns per 2048 sample block");
+    if (check) {
+        CHECK(droop > -0.1);
+        CHECK(worst < -50.0);
+    }
+}
+
+TEST_CASE("ChannelDecimator cascades compared over 32:1.") {
+    compare_cascade<ChannelDecimator>("ChannelDecimator", false);
+    compare_cascade<HalfbandChannelDecimator>("HalfbandChannelDecimator", true);
+}
+
+TEST_CASE("Real decimators match their filters, truncated.") {
+    const auto signal = make_signal(block_size * 4, 8000.0);
+    std::vector<int16_t> x(signal.size());
+    std::vector<double> reference_x(signal.size());
+    for (size_t n = 0; n < x.size(); n++) {
+        x[n] = std::lround(signal[n].real());
+        reference_x[n] = x[n];
+    }
+
+    SUBCASE("FIR64AndDecimateBy2Real") {
+        FIR64AndDecimateBy2Real fir{};
+        fir.configure(taps_64_lp_025_025.taps);
+        const auto y = run_blocks<int16_t>(fir, x, 2);
+        const auto h = taps_of(taps_64_lp_025_025.taps);
+        CHECK(max_error(y, real_fir_decimate(reference_x, {h.crbegin(), h.crend()}, 2), 65536.0) < 1.0);
+        MESSAGE("FIR64AndDecimateBy2Real: " << time_blocks<int16_t>(fir, x, 2) << " ns per input sample");
+    }
+
+    SUBCASE("DecimateBy2CIC4Real") {
+        DecimateBy2CIC4Real cic{};
+        const auto y = run_blocks<int16_t>(cic, x, 2);
+        CHECK(max_error(y, real_fir_decimate(reference_x, {1.0, 4.0, 6.0, 4.0, 1.0}, 2), 16.0) < 1.0);
+        MESSAGE("DecimateBy2CIC4Real: " << time_blocks<int16_t>(cic, x, 2) << " ns per input sample");
+    }
+}
+
+TEST_CASE("AM demodulator matches the magnitude.") {
+    auto x = quantize<int16_t>(make_signal(block_size * 4, 8000.0));
+    dsp::demodulate::AM am{};
+    const auto y = run_blocks<float>(am, x, 1);
+    CHECK(max_error(y, am_demodulate(to_complex(x)), 32768.0) < 1e-6);
+    MESSAGE("AM: " << time_blocks<float>(am, x, 1) << " ns per input sample");
+}
+
+TEST_CASE("FM demodulators match the phase step.") {
+    /* 5kHz of deviation at 48kHz keeps the phase steps within the 45
+     * degrees the 16 bit output's arctangent approximation covers. */
+    constexpr float fs = 48000.0f;
+    constexpr float deviation = 5000.0f;
+    const double kf = 1.0 / (2.0 * M_PI * deviation / fs);
+
+    auto x = quantize<int16_t>(make_fm(block_size * 4, 8000.0, deviation / fs));
+    const auto expected = fm_demodulate(to_complex(x));
+
+    SUBCASE("Float output") {
+        dsp::demodulate::FM fm{};
+        fm.configure(fs, deviation);
+        const auto y = run_blocks<float>(fm, x, 1);
+        CHECK(max_error(y, expected, 1.0 / kf) < 1e-5);
+        MESSAGE("FM, float output: " << time_blocks<float>(fm, x, 1) << " ns per input sample");
+    }
+
+    SUBCASE("16 bit output") {
+        /* The arctangent approximation is good to 0.27 degrees. */
+        constexpr double full_scale = 32767.0;
+        dsp::demodulate::FM fm{};
+        fm.configure(fs, deviation);
+        const auto y = run_blocks<int16_t>(fm, x, 1);
+        const double error = max_error(y, expected, 1.0 / (kf * full_scale), 1);
+        MESSAGE("FM, 16 bit output: " << error / (kf * full_scale) * 180.0 / M_PI << " degrees worst error, "
+                                      << time_blocks<int16_t>(fm, x, 1) << " ns per input sample");
+        CHECK(error <= 0.0048 * kf * full_scale + 1.0);
+    }
+}
+
+TEST_CASE("FM discriminators compared.") {
+    /* WFM's 75kHz of deviation at 384kHz steps the phase by up to 1.23
+     * radians. The narrow signal keeps the steps under 0.1 radians, where
+     * the quotient's sin() is close enough. The weak one checks that small
+     * conjugate products keep their precision. */
+    using Discriminator = dsp::demodulate::FM::Discriminator;
+    constexpr float fs = 384000.0f;
+    constexpr float deviation = 75000.0f;
+
+    struct Signal {
+        std::string name;
+        double amplitude;
+        double deviation_max;
+    };
+    const Signal signals[] = {
+        {"WFM", 30000.0, deviation / fs},
+        {"weak WFM", 300.0, deviation / fs},
+        {"narrow", 30000.0, 0.015},
+    };
+
+    struct Case {
+        std::string name;
+        Discriminator discriminator;
+        double tolerance; /* Radians. */
+        double tolerance_narrow;
+    };
+    const Case cases[] = {
+        {"atan2f", Discriminator::Atan2f, 1e-6, 1e-6},
+        {"polynomial", Discriminator::Polynomial, 5e-5, 5e-5},
+        {"CORDIC", Discriminator::CORDIC, 5e-5, 5e-5},
+        {"quotient", Discriminator::Quotient, 0.3, 2e-4},
+    };
+
+    for (const auto& signal : signals) {
+        auto x = quantize<int16_t>(make_fm(block_size * 4, signal.amplitude, signal.deviation_max));
+        const auto expected = fm_demodulate(to_complex(x));
+        for (const auto& c : cases) {
+            dsp::demodulate::FM fm{};
+            fm.configure(fs, deviation, c.discriminator);
+            const auto y = run_blocks<float>(fm, x, 1);
+            const double kf = 1.0 / (2.0 * M_PI * deviation / fs);
+            const double error = max_error(y, expected, 1.0 / kf, 1) / kf;
+            MESSAGE("FM " << c.name << ", " << signal.name << ": " << error << " radians worst error, "
+                          << time_blocks<float>(fm, x, 1) << " ns per input sample");
+            CHECK(error < ((signal.name == "narrow") ? c.tolerance_narrow : c.tolerance));
+        }
+    }
+}
+
+TEST_CASE("Matched filter matches the correlation.") {
+    /* AIS style: a 16 tap low-pass moved to +fs/8, decimating by 2. */
+    constexpr size_t taps_count = 16;
+    std::array<std::complex<float>, taps_count> taps{};
+    std::vector<complex_t> h(taps_count);
+    for (size_t k = 0; k < taps_count; k++) {
+        const double window = 0.5 - 0.5 * std::cos(2.0 * M_PI * (k + 0.5) / taps_count);
+        h[k] = std::polar(window / 8.0, 2.0 * M_PI * k / 8.0);
+        taps[k] = {static_cast<float>(h[k].real()), static_cast<float>(h[k].imag())};
+    }
+
+    const auto x = make_signal(block_size * 4, 1.0);
+    const auto forward = fir_decimate(x, h, 2);
+    std::vector<complex_t> conjugate_h(taps_count);
+    for (size_t k = 0; k < taps_count; k++) {
+        conjugate_h[k] = std::conj(h[k]);
+    }
+    const auto backward = fir_decimate(x, conjugate_h, 2);
+
+    dsp::matched_filter::MatchedFilter filter{taps, 2};
+    double worst = 0.0;
+    size_t outputs = 0;
+    for (size_t n = 0; n < x.size(); n++) {
+        if (filter.execute_once({static_cast<float>(x[n].real()), static_cast<float>(x[n].imag())})) {
+            const double expected = std::abs(forward[outputs]) - std::abs(backward[outputs]);
+            worst = std::max(worst, std::abs(filter.get_output() - expected));
+            outputs++;
+        }
+    }
+    CHECK(outputs == x.size() / 2);
+    CHECK(worst < 1e-5);
+
+    const double ns = ns_per_sample(x.size(), iterations / 50, [&]() {
+        for (const auto& s : x) {
+            filter.execute_once({static_cast<float>(s.real()), static_cast<float>(s.imag())});
+        }
+    });
+    MESSAGE("MatchedFilter, 16 taps: " << ns << " ns per input sample");
+}
+
+TEST_CASE("Narrowband FM chain over a capture.") {
+    /* Each stage is checked against the reference fed the kernel's own
+     * input, so rounding does not build up along the chain. Replays the
+     * 3.072Msps capture named by DSP_C8_FILE when set. */
+    std::vector<complex8_t> capture;
+    const char* const path = std::getenv("DSP_C8_FILE");
+    if (path) {
+        capture = read_c8(path);
+        REQUIRE(capture.size() >= block_size);
+    } else {
+        /* 1kHz tone at 2.5kHz deviation on a carrier fs/4 above centre,
+         * where the first decimator's shift takes it to 0Hz. */
+        constexpr double fs = 3072000.0;
+        LCG rng{};
+        capture.resize(block_size * 64);
+        double phase = 0.0;
+        for (size_t n = 0; n < capture.size(); n++) {
+            phase += 2.0 * M_PI * (768000.0 + 2500.0 * std::sin(2.0 * M_PI * 1000.0 * n / fs)) / fs;
+            capture[n] = {static_cast<int8_t>(std::lround(90.0 * std::cos(phase) + 8.0 * rng.noise())),
+                          static_cast<int8_t>(std::lround(90.0 * std::sin(phase) + 8.0 * rng.noise()))};
+        }
+    }
+    capture.resize(capture.size() / block_size * block_size);
+
+    FIRC8xR16x24FS4Decim8 decim_0{};
+    FIRC16xR16x32Decim8 decim_1{};
+    FIRAndDecimateComplex channel_filter{};
+    dsp::demodulate::FM demod{};
+    decim_0.configure(taps_16k0_decim_0.taps, 33554432);
+    decim_1.configure(taps_16k0_decim_1.taps, 131072);
+    channel_filter.configure(taps_16k0_channel.taps, 2);
+    demod.configure(24000, 5000);
+
+    std::vector<complex16_t> stage_0(block_size / 8);
+    std::vector<complex16_t> stage_1(block_size / 64);
+    std::vector<complex16_t> stage_2(block_size / 128);
+    std::vector<float> audio(block_size / 128);
+    std::vector<complex16_t> all_0, all_1, all_2;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < capture.size(); offset += block_size) {
+        const auto r0 = decim_0.execute({&capture[offset], block_size, 3072000}, {stage_0.data(), stage_0.size(), 0});
+        const auto r1 = decim_1.execute(r0, {stage_1.data(), stage_1.size(), 0});
+        const auto r2 = channel_filter.execute(r1, {stage_2.data(), stage_2.size(), 0});
+        demod.execute(r2, buffer_f32_t{audio.data(), audio.size()});
+        all_0.insert(all_0.end(), stage_0.cbegin(), stage_0.cend());
+        all_1.insert(all_1.end(), stage_1.cbegin(), stage_1.cend());
+        all_2.insert(all_2.end(), stage_2.cbegin(), stage_2.cend());
+    }
+    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const auto& taps_0 = taps_16k0_decim_0.taps;
+    CHECK(max_error(all_0, fir_decimate(to_complex(capture), fs4_shifted_taps(taps_0, true), 8), smmulr_scale(33554432)) <= 0.5);
+    CHECK(max_error(all_1, fir_decimate(to_complex(all_0), oldest_first_taps(taps_16k0_decim_1.taps), 8), smmulr_scale(131072)) <= 0.5);
+    CHECK(max_error(all_2, fir_decimate(to_complex(all_1), taps_of(taps_16k0_channel.taps), 2), 65536.0) < 1.0);
+
+    const std::string label = path ? std::string{"NFM chain over "} + path : std::string{"NFM chain"};
+    MESSAGE(label << ": " << capture.size() / seconds / 1e6
+                  << " Msps on the host, " << seconds * 1e9 / capture.size() << " ns per input sample");
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_channelizer.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <vector>
+
+namespace {
+
+constexpr size_t block_size = 2048;
+constexpr uint32_t sampling_rate = 3072000;
+
+template <typename T>
+std::vector<T> make_tone(const double frequency, const size_t length, const double amplitude) {
+    std::vector<T> x(length);
+    for (size_t n = 0; n < length; n++) {
+        const double phi = 2.0 * M_PI * frequency * n / sampling_rate;
+        x[n] = {static_cast<typename T::value_type>(amplitude * std::cos(phi)), static_cast<typename T::value_type>(amplitude * std::sin(phi))};
+    }
+    return x;
+}
+
+/* Mean power per channel over the last block, after the filter has settled. */
+template <size_t M, typename T>
+std::array<double, M> channel_powers(const std::vector<T>& input) {
+    dsp::channelizer::PolyphaseChannelizer<M, 8> channelizer{};
+    std::vector<complex16_t> output(block_size);
+    std::array<double, M> power{};
+
+    for (size_t i = 0; i < input.size() / block_size; i++) {
+        const buffer_t<T> src{const_cast<T*>(&input[i * block_size]), block_size, sampling_rate};
+        const buffer_c16_t dst{output.data(), output.size()};
+        channelizer.execute(src, dst, [&power](const size_t k, const buffer_c16_t& channel) {
+            double sum = 0.0;
+            for (size_t n = 0; n < channel.count; n++) sum += std::norm(std::complex<double>(channel.p[n].real(), channel.p[n].imag()));
+            power[k] = sum / channel.count;
+        });
+    }
+    return power;
+}
+
+template <size_t M>
+double nanoseconds_per_input_sample() {
+    dsp::channelizer::PolyphaseChannelizer<M, 8> channelizer{};
+    auto input = make_tone<complex8_t>(12345.0, block_size, 100.0);
+    std::vector<complex16_t> output(block_size);
+    constexpr size_t iterations = 200;
+
+    volatile int32_t sink = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        const buffer_c8_t src{input.data(), block_size, sampling_rate};
+        const buffer_c16_t dst{output.data(), output.size()};
+        channelizer.execute(src, dst, [&sink](const size_t, const buffer_c16_t& channel) { sink = sink + channel.p[0].real(); });
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (iterations * block_size);
+}
+
+}  // namespace
+
+TEST_CASE("channelizer splits input into channels at fs / M") {
+    dsp::channelizer::PolyphaseChannelizer<8, 8> channelizer{};
+    auto input = make_tone<complex8_t>(0.0, block_size, 100.0);
+    std::vector<complex16_t> output(block_size);
+    const buffer_c8_t src{input.data(), block_size, sampling_rate};
+    const buffer_c16_t dst{output.data(), output.size()};
+
+    size_t calls = 0;
+    channelizer.execute(src, dst, [&calls](const size_t k, const buffer_c16_t& channel) {
+        CHECK(k == calls);
+        CHECK(channel.count == block_size / 8);
+        CHECK(channel.sampling_rate == sampling_rate / 8);
+        calls++;
+    });
+    CHECK(calls == 8);
+}
+
+TEST_CASE("channelizer puts a tone in its channel and rejects it elsewhere") {
+    constexpr size_t M = 8;
+    constexpr double spacing = static_cast<double>(sampling_rate) / M;
+
+    for (const int channel : {0, 1, 3, -1, -3}) {
+        const size_t k = (channel + M) % M;
+
+        // complex16 input: rejection is limited by the prototype filter.
+        const auto power = channel_powers<M>(make_tone<complex16_t>(channel * spacing + 10000.0, block_size * 4, 20000.0));
+        CHECK(std::sqrt(power[k]) == doctest::Approx(20000.0).epsilon(0.05));
+        for (size_t other = 0; other < M; other++) {
+            if (other != k) CHECK(power[other] < power[k] * 1e-8);
+        }
+
+        // complex8 input: a 100/128 tone lands at 100 * 256, and rejection is
+        // limited by the 8-bit quantization noise spread across all channels.
+        const auto power_c8 = channel_powers<M>(make_tone<complex8_t>(channel * spacing + 10000.0, block_size * 4, 100.0));
+        CHECK(std::sqrt(power_c8[k]) == doctest::Approx(100.0 * 256.0).epsilon(0.05));
+        for (size_t other = 0; other < M; other++) {
+            if (other != k) CHECK(power_c8[other] < power_c8[k] * 1e-4);
+        }
+    }
+}
+
+TEST_CASE("benchmark channelizer for 4, 8 and 16 channels") {
+    MESSAGE("4 channels: " << nanoseconds_per_input_sample<4>() << " ns/input sample");
+    MESSAGE("8 channels: " << nanoseconds_per_input_sample<8>() << " ns/input sample");
+    MESSAGE("16 channels: " << nanoseconds_per_input_sample<16>() << " ns/input sample");
+}
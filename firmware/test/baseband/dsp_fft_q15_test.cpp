@@ -0,0 +1,147 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_fft.hpp"
+#include "doctest.h"
+
+#include <chrono>
+
+namespace {
+
+template <size_t N, typename T>
+void bit_reverse_load(const std::array<T, N>& src, std::array<T, N>& dst) {
+    constexpr size_t K = log_2(N);
+    for (size_t i = 0; i < N; i++) {
+        dst[portable::rbit(i) >> (32 - K)] = src[i];
+    }
+}
+
+template <size_t N>
+std::array<complex16_t, N> random_input_c16(const int16_t amplitude) {
+    uint32_t seed = N + amplitude;
+    auto next = [&seed, amplitude]() {
+        seed = seed * 1664525 + 1013904223;
+        return static_cast<int16_t>((static_cast<int16_t>(seed >> 16) * static_cast<int32_t>(amplitude)) >> 15);
+    };
+    std::array<complex16_t, N> x{};
+    for (auto& v : x) v = {next(), next()};
+    return x;
+}
+
+/* Signal-to-error ratio in dB of the Q15 FFT vs the float radix-4 FFT. */
+template <size_t N>
+double q15_snr_db(const int16_t amplitude) {
+    const auto x = random_input_c16<N>(amplitude);
+
+    std::array<complex16_t, N> q15{};
+    bit_reverse_load(x, q15);
+    const int exponent = fft_c_preswapped_q15(q15);
+
+    std::array<std::complex<float>, N> x_float{};
+    for (size_t i = 0; i < N; i++) x_float[i] = x[i];
+    std::array<std::complex<float>, N> reference{};
+    bit_reverse_load(x_float, reference);
+    fft_c_preswapped_radix4(reference);
+
+    double signal = 0.0;
+    double noise = 0.0;
+    const float scale = std::ldexp(1.0f, exponent);
+    for (size_t k = 0; k < N; k++) {
+        const std::complex<float> q = std::complex<float>(q15[k]) * scale;
+        signal += std::norm(reference[k]);
+        noise += std::norm(reference[k] - q);
+    }
+    return 10.0 * std::log10(signal / noise);
+}
+
+}  // namespace
+
+TEST_CASE("portable SIMD fallbacks match the ARM definitions") {
+    CHECK(portable::smlad(portable::pack16(-2, 3), portable::pack16(5, 7), 100) == 100 - 10 + 21);
+    CHECK(portable::smlsd(portable::pack16(-2, 3), portable::pack16(5, 7), 0) == -10 - 21);
+    CHECK(portable::smladx(portable::pack16(-2, 3), portable::pack16(5, 7), 0) == -14 + 15);
+    CHECK(portable::smlad(portable::pack16(-32768, -32768), portable::pack16(-32768, -32768), 0) == INT32_MIN);
+    CHECK(portable::qadd16(portable::pack16(32000, -32000), portable::pack16(1000, -1000)) == portable::pack16(32767, -32768));
+    CHECK(portable::qsub16(portable::pack16(-32000, 5), portable::pack16(1000, 7)) == portable::pack16(-32768, -2));
+    CHECK(portable::shadd16(portable::pack16(32767, -3), portable::pack16(32767, 0)) == portable::pack16(32767, -2));
+    CHECK(portable::shsub16(portable::pack16(-32768, 3), portable::pack16(32767, 0)) == portable::pack16(-32768, 1));
+    CHECK(portable::sxtb16(0x80ff017f) == portable::pack16(127, -1));
+    CHECK(portable::sxtb16(0x80ff017f, 8) == portable::pack16(1, -128));
+    CHECK(portable::pkhbt(0x11112222, 0x00003333, 16) == 0x33332222);
+    CHECK(portable::pkhtb(0x11112222, 0x80000000, 16) == 0x11118000);
+    CHECK(portable::rbit(1) == 0x80000000);
+}
+
+TEST_CASE("q15 fft puts a full scale tone in the right bin") {
+    constexpr size_t N = 256;
+    std::array<complex16_t, N> x{};
+    for (size_t n = 0; n < N; n++) {
+        const double phi = 2.0 * M_PI * 19 * n / N;
+        x[n] = {static_cast<int16_t>(32767.0 * std::cos(phi)), static_cast<int16_t>(32767.0 * std::sin(phi))};
+    }
+
+    std::array<complex16_t, N> data{};
+    bit_reverse_load(x, data);
+    const int exponent = fft_c_preswapped_q15(data);
+
+    const float scale = std::ldexp(1.0f, exponent);
+    CHECK(std::abs(std::complex<float>(data[19]) * scale) == doctest::Approx(32767.0f * N).epsilon(0.01));
+    for (size_t k = 0; k < N; k++) {
+        if (k != 19) CHECK(std::abs(std::complex<float>(data[k]) * scale) < 32767.0f * N * 1e-3f);
+    }
+}
+
+TEST_CASE("q15 fft never overflows and keeps precision across input levels") {
+    for (const int16_t amplitude : {32767, 8192, 1024, 64}) {
+        CHECK(q15_snr_db<256>(amplitude) > 55.0);
+        CHECK(q15_snr_db<2048>(amplitude) > 50.0);
+    }
+}
+
+TEST_CASE("benchmark q15 vs float fft") {
+    constexpr size_t N = 256;
+    constexpr size_t iterations = 2000;
+    const auto x = random_input_c16<N>(32767);
+
+    std::array<complex16_t, N> q15{};
+    const auto q15_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        bit_reverse_load(x, q15);
+        fft_c_preswapped_q15(q15);
+    }
+    const auto q15_stop = std::chrono::steady_clock::now();
+
+    std::array<std::complex<float>, N> x_float{};
+    for (size_t i = 0; i < N; i++) x_float[i] = x[i];
+    std::array<std::complex<float>, N> f{};
+    const auto float_start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        bit_reverse_load(x_float, f);
+        fft_c_preswapped_radix4(f);
+    }
+    const auto float_stop = std::chrono::steady_clock::now();
+
+    const double q15_ns = std::chrono::duration<double, std::nano>(q15_stop - q15_start).count() / iterations;
+    const double float_ns = std::chrono::duration<double, std::nano>(float_stop - float_start).count() / iterations;
+    MESSAGE("256-point q15: " << q15_ns << " ns (" << sizeof(q15) << " bytes), float radix-4: " << float_ns << " ns (" << sizeof(f) << " bytes)");
+    MESSAGE("q15 SNR at full scale: " << q15_snr_db<N>(32767) << " dB, at -30 dBFS: " << q15_snr_db<N>(1024) << " dB");
+    CHECK(sizeof(q15) * 2 == sizeof(f));
+}
@@ -0,0 +1,163 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_fft.hpp"
+#include "doctest.h"
+
+#include <chrono>
+
+namespace {
+
+using cf = std::complex<float>;
+
+/* Host stand-in for fft_swap(), which needs __RBIT. */
+template <size_t N>
+void bit_reverse_load(const std::array<cf, N>& src, std::array<cf, N>& dst) {
+    constexpr size_t K = log_2(N);
+    for (size_t i = 0; i < N; i++) {
+        size_t r = 0;
+        for (size_t b = 0; b < K; b++) {
+            if (i & (1 << b)) r |= 1 << (K - 1 - b);
+        }
+        dst[r] = src[i];
+    }
+}
+
+template <size_t N>
+std::array<cf, N> random_input() {
+    uint32_t seed = N;
+    auto next = [&seed]() {
+        seed = seed * 1664525 + 1013904223;
+        return static_cast<float>(static_cast<int16_t>(seed >> 16));
+    };
+    std::array<cf, N> x{};
+    for (auto& v : x) v = {next(), next()};
+    return x;
+}
+
+/* Peak error relative to the peak of a double-precision DFT. */
+template <size_t N, typename F>
+double error_vs_dft(F fft) {
+    const auto x = random_input<N>();
+    std::array<cf, N> data{};
+    bit_reverse_load(x, data);
+    fft(data);
+
+    double max_err = 0.0;
+    double max_mag = 0.0;
+    for (size_t k = 0; k < N; k++) {
+        std::complex<double> sum{0.0, 0.0};
+        for (size_t n = 0; n < N; n++) {
+            const double phi = -2.0 * M_PI * static_cast<double>((k * n) % N) / N;
+            sum += std::complex<double>{x[n].real(), x[n].imag()} * std::polar(1.0, phi);
+        }
+        max_mag = std::max(max_mag, std::abs(sum));
+        max_err = std::max(max_err, std::abs(sum - std::complex<double>{data[k].real(), data[k].imag()}));
+    }
+    return max_err / max_mag;
+}
+
+template <size_t N, typename F>
+double nanoseconds_per_fft(F fft) {
+    const auto x = random_input<N>();
+    std::array<cf, N> data{};
+    constexpr size_t iterations = 2000;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        bit_reverse_load(x, data);
+        fft(data);
+    }
+    const auto stop = std::chrono::steady_clock::now();
+
+    // Keep the optimizer from discarding the work.
+    volatile float sink = data[1].real();
+    (void)sink;
+    return std::chrono::duration<double, std::nano>(stop - start).count() / iterations;
+}
+
+template <size_t N>
+double radix4_error_vs_dft() {
+    return error_vs_dft<N>([](std::array<cf, N>& d) { fft_c_preswapped_radix4(d); });
+}
+
+}  // namespace
+
+TEST_CASE("fft twiddle factors match exp(-2*pi*i*t/N)") {
+    for (size_t t = 0; t < fft_max_size; t++) {
+        const auto w = fft_twiddle<fft_max_size>(t);
+        const double phi = -2.0 * M_PI * t / fft_max_size;
+        CHECK(w.real() == doctest::Approx(std::cos(phi)).epsilon(1e-6));
+        CHECK(w.imag() == doctest::Approx(std::sin(phi)).epsilon(1e-6));
+    }
+}
+
+TEST_CASE("radix-4 fft puts a complex tone in the right bin") {
+    constexpr size_t N = 512;
+    std::array<cf, N> x{};
+    for (size_t n = 0; n < N; n++) x[n] = std::polar(1000.0f, static_cast<float>(2.0 * M_PI * 37 * n / N));
+
+    std::array<cf, N> data{};
+    bit_reverse_load(x, data);
+    fft_c_preswapped_radix4(data);
+
+    CHECK(std::abs(data[37]) == doctest::Approx(1000.0f * N).epsilon(1e-4));
+    for (size_t k = 0; k < N; k++) {
+        if (k != 37) CHECK(std::abs(data[k]) < 1.0f);
+    }
+}
+
+TEST_CASE("radix-4 fft matches reference DFT from 64 to 2048 points") {
+    CHECK(radix4_error_vs_dft<64>() < 1e-6);
+    CHECK(radix4_error_vs_dft<128>() < 1e-6);
+    CHECK(radix4_error_vs_dft<256>() < 1e-6);
+    CHECK(radix4_error_vs_dft<512>() < 1e-6);
+    CHECK(radix4_error_vs_dft<1024>() < 1e-6);
+    CHECK(radix4_error_vs_dft<2048>() < 1e-6);
+}
+
+TEST_CASE("radix-4 fft agrees with radix-2 fft") {
+    constexpr size_t N = 256;
+    const auto x = random_input<N>();
+    std::array<cf, N> radix2{};
+    std::array<cf, N> radix4{};
+    bit_reverse_load(x, radix2);
+    bit_reverse_load(x, radix4);
+
+    fft_c_preswapped(radix2, 0, log_2(N));
+    fft_c_preswapped_radix4(radix4);
+
+    for (size_t k = 0; k < N; k++) {
+        CHECK(std::abs(radix2[k] - radix4[k]) < 1e-4f * 32768.0f * N);
+    }
+}
+
+TEST_CASE("benchmark radix-2 vs radix-4 fft") {
+    const double radix2 = nanoseconds_per_fft<256>([](std::array<cf, 256>& d) { fft_c_preswapped(d, 0, 8); });
+    const double radix4_256 = nanoseconds_per_fft<256>([](std::array<cf, 256>& d) { fft_c_preswapped_radix4(d); });
+    const double radix4_2048 = nanoseconds_per_fft<2048>([](std::array<cf, 2048>& d) { fft_c_preswapped_radix4(d); });
+
+    MESSAGE("256-point radix-2: " << radix2 << " ns, radix-4: " << radix4_256 << " ns");
+    MESSAGE("2048-point radix-4: " << radix4_2048 << " ns");
+    MESSAGE("256-point error vs DFT, radix-2: " << error_vs_dft<256>([](std::array<cf, 256>& d) { fft_c_preswapped(d, 0, 8); })
+                                                << ", radix-4: " << radix4_error_vs_dft<256>());
+    CHECK(radix4_256 > 0.0);
+}
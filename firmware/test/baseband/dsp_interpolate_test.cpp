@@ -0,0 +1,207 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_interpolate.hpp"
+#include "doctest.h"
+
+#include <chrono>
+#include <complex>
+#include <vector>
+
+using dsp::interpolate::PolyphaseInterpolator;
+
+namespace {
+
+constexpr size_t block_size = 2048;
+constexpr size_t period = 1024;  // Input samples per analysis period
+
+/* Complex tone completing a whole number of cycles every period input
+ * samples, so the output is periodic and lands on exact DFT bins. */
+std::vector<complex16_t> make_tone(const size_t cycles, const size_t length, const double amplitude) {
+    std::vector<complex16_t> x(length);
+    for (size_t n = 0; n < length; n++) {
+        const double phi = 2.0 * M_PI * cycles * n / period;
+        x[n] = {static_cast<int16_t>(std::lround(amplitude * std::cos(phi))), static_cast<int16_t>(std::lround(amplitude * std::sin(phi)))};
+    }
+    return x;
+}
+
+/* Runs blocks of output through the interpolator, feeding input as it is
+ * asked for, and checks input_count() against what execute() took. */
+std::vector<complex8_t> interpolate(PolyphaseInterpolator& interpolator, const std::vector<complex16_t>& input, const size_t output_count) {
+    std::vector<complex8_t> output(output_count);
+    size_t consumed = 0;
+    for (size_t offset = 0; offset < output_count; offset += block_size) {
+        const size_t count = std::min(block_size, output_count - offset);
+        const size_t needed = interpolator.input_count(count);
+        REQUIRE(needed <= count);
+        REQUIRE(consumed + needed <= input.size());
+        interpolator.execute(&input[consumed], {&output[offset], count});
+        consumed += needed;
+    }
+    return output;
+}
+
+/* Zero-order hold by L, as replay used to do it. */
+std::vector<complex8_t> hold(const std::vector<complex16_t>& input, const size_t L, const size_t output_count) {
+    std::vector<complex8_t> output(output_count);
+    for (size_t n = 0; n < output_count; n++) {
+        const auto s = input[n / L];
+        output[n] = {static_cast<int8_t>(s.real() >> 8), static_cast<int8_t>(s.imag() >> 8)};
+    }
+    return output;
+}
+
+double bin_power(const std::vector<complex8_t>& x, const size_t first, const size_t length, const size_t bin) {
+    std::complex<double> sum{};
+    for (size_t n = 0; n < length; n++) {
+        const double phi = -2.0 * M_PI * static_cast<double>(bin) * n / length;
+        sum += std::complex<double>(x[first + n].real(), x[first + n].imag()) * std::polar(1.0, phi);
+    }
+    return std::norm(sum);
+}
+
+struct SpurMeasurement {
+    double tone_db{0.0};
+    double worst_spur_dbc{0.0};
+};
+
+/* Level of the tone at cycles * L / M and of its worst image, the tone
+ * mirrored about each multiple of the input rate. */
+SpurMeasurement measure(const std::vector<complex8_t>& output, const size_t first, const size_t cycles, const size_t L, const size_t M) {
+    const size_t length = period * L / M;
+    SpurMeasurement result{};
+    const double tone = bin_power(output, first, length, cycles);
+    result.tone_db = 10.0 * std::log10(tone);
+    double worst = 0.0;
+    for (size_t k = 1; k < L; k++) {
+        worst = std::max(worst, bin_power(output, first, length, (k * period + cycles) % length));
+    }
+    result.worst_spur_dbc = 10.0 * std::log10(worst / tone);
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("Interpolator consumes one input per L outputs.") {
+    PolyphaseInterpolator interpolator{};
+    interpolator.configure(8, 1);
+    const auto input = make_tone(50, 4096, 20000.0);
+
+    size_t consumed = 0;
+    std::vector<complex8_t> output(block_size);
+    for (size_t i = 0; i < 8; i++) {
+        const size_t needed = interpolator.input_count(block_size);
+        interpolator.execute(&input[consumed], {output.data(), block_size});
+        consumed += needed;
+    }
+    // The first output needs no input at all, everything after is 1:8
+    CHECK(consumed == (8 * block_size - 1) / 8);
+}
+
+TEST_CASE("Interpolator passes a constant through without ripple.") {
+    for (const size_t L : {2, 5, 8, 16}) {
+        PolyphaseInterpolator interpolator{};
+        interpolator.configure(L, 1);
+        const std::vector<complex16_t> input(block_size, complex16_t{12800, -6400});
+        const auto output = interpolate(interpolator, input, block_size);
+        for (size_t n = L * (PolyphaseInterpolator::taps_per_phase + 1); n < output.size(); n++) {
+            CHECK(output[n].real() == 50);
+            CHECK(output[n].imag() == -25);
+        }
+    }
+}
+
+TEST_CASE("Interpolator passes samples through unchanged at L = M = 1.") {
+    PolyphaseInterpolator interpolator{};
+    interpolator.configure(1, 1);
+    const auto input = make_tone(123, block_size + 16, 30000.0);
+    const auto output = interpolate(interpolator, input, block_size);
+    const size_t delay = PolyphaseInterpolator::taps_per_phase / 2;
+    for (size_t n = delay + 1; n < output.size(); n++) {
+        const auto s = input[n - 1 - delay];
+        CHECK(std::abs(output[n].real() - (s.real() + 128) / 256) <= 1);
+        CHECK(std::abs(output[n].imag() - (s.imag() + 128) / 256) <= 1);
+    }
+}
+
+TEST_CASE("Interpolator rejects images far better than sample and hold.") {
+    constexpr size_t L = 8;
+    constexpr size_t cycles = 205;  // 0.2 of the input rate
+    const auto input = make_tone(cycles, period * 4, 24000.0);
+
+    PolyphaseInterpolator interpolator{};
+    interpolator.configure(L, 1);
+    const auto output = interpolate(interpolator, input, period * 3 * L);
+    const auto filtered = measure(output, period * L, cycles, L, 1);
+
+    const auto held = measure(hold(input, L, period * 3 * L), period * L, cycles, L, 1);
+
+    MESSAGE("Replay 1:" << L << " tone at 0.2 fs, worst image: polyphase " << filtered.worst_spur_dbc
+                        << " dBc, sample and hold " << held.worst_spur_dbc << " dBc");
+    CHECK(filtered.worst_spur_dbc < -45.0);
+    CHECK(held.worst_spur_dbc > -20.0);
+    CHECK(std::abs(filtered.tone_db - held.tone_db) < 1.0);
+}
+
+TEST_CASE("Interpolator resamples by a rational factor.") {
+    constexpr size_t L = 5;
+    constexpr size_t M = 4;
+    constexpr size_t cycles = 100;
+    const auto input = make_tone(cycles, period * 4, 24000.0);
+
+    PolyphaseInterpolator interpolator{};
+    interpolator.configure(L, M);
+    CHECK(interpolator.interpolation() == L);
+    CHECK(interpolator.decimation() == M);
+
+    const auto output = interpolate(interpolator, input, period * 3 * L / M);
+    const auto result = measure(output, period * L / M, cycles, L, M);
+    MESSAGE("Replay " << L << "/" << M << " worst image " << result.worst_spur_dbc << " dBc");
+    CHECK(result.worst_spur_dbc < -45.0);
+}
+
+TEST_CASE("Interpolator cost per output sample.") {
+    PolyphaseInterpolator interpolator{};
+    interpolator.configure(8, 1);
+    const auto input = make_tone(205, block_size, 24000.0);
+    std::vector<complex8_t> output(block_size);
+    constexpr size_t iterations = 2000;
+
+    volatile int32_t sink = 0;
+    size_t consumed = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        const size_t needed = interpolator.input_count(block_size);
+        if (consumed + needed > input.size()) consumed = 0;
+        interpolator.execute(&input[consumed], {output.data(), block_size});
+        consumed += needed;
+        sink = sink + output[0].real();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(stop - start).count() / (iterations * block_size);
+
+    // Two SMLADs per pair of taps, for I and for Q
+    constexpr size_t smlad_per_output = PolyphaseInterpolator::taps_per_phase;
+    MESSAGE("Polyphase 1:8 interpolator: " << ns << " ns per output sample on the host, "
+                                           << smlad_per_output << " SMLAD per output sample");
+    CHECK(ns > 0.0);
+}
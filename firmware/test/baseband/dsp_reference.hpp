@@ -0,0 +1,177 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __DSP_REFERENCE_H__
+#define __DSP_REFERENCE_H__
+
+/* Floating point models of the baseband kernels, written the textbook way,
+ * for checking the fixed point versions against and for timing them. */
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+#include "dsp_types.hpp"
+
+namespace dsp {
+namespace reference {
+
+using complex_t = std::complex<double>;
+
+template <typename T>
+std::vector<complex_t> to_complex(const std::vector<std::complex<T>>& x) {
+    std::vector<complex_t> result(x.size());
+    for (size_t n = 0; n < x.size(); n++) {
+        result[n] = {static_cast<double>(x[n].real()), static_cast<double>(x[n].imag())};
+    }
+    return result;
+}
+
+/* y[m] = sum h[k] * x[D * m + D - 1 - k], samples before the start being
+ * zero, so output m is due once input D * m + D - 1 has arrived. */
+template <typename Tap>
+std::vector<complex_t> fir_decimate(const std::vector<complex_t>& x, const std::vector<Tap>& h, const size_t decimation) {
+    std::vector<complex_t> y(x.size() / decimation);
+    for (size_t m = 0; m < y.size(); m++) {
+        const size_t newest = decimation * m + decimation - 1;
+        complex_t sum{};
+        for (size_t k = 0; (k < h.size()) && (k <= newest); k++) {
+            sum += x[newest - k] * complex_t(h[k]);
+        }
+        y[m] = sum;
+    }
+    return y;
+}
+
+/* Taps of a real filter moved to -fs/4 (down) or +fs/4, with the oldest
+ * sample in the delay line seeing tap 0 and no rotation, as the
+ * FIRC8xR16x24FS4 decimators apply them. */
+template <size_t N>
+std::vector<complex_t> fs4_shifted_taps(const std::array<int16_t, N>& taps, const bool down) {
+    const complex_t rotation[4]{{1.0, 0.0}, {0.0, down ? -1.0 : 1.0}, {-1.0, 0.0}, {0.0, down ? 1.0 : -1.0}};
+    std::vector<complex_t> h(N);
+    for (size_t k = 0; k < N; k++) {
+        h[N - 1 - k] = static_cast<double>(taps[k]) * rotation[k & 3];
+    }
+    return h;
+}
+
+template <size_t N>
+std::vector<double> taps_of(const std::array<int16_t, N>& taps) {
+    return {taps.cbegin(), taps.cend()};
+}
+
+template <size_t N>
+std::vector<complex_t> taps_of(const std::array<complex16_t, N>& taps) {
+    std::vector<complex_t> h(N);
+    for (size_t k = 0; k < N; k++) {
+        h[k] = {static_cast<double>(taps[k].real()), static_cast<double>(taps[k].imag())};
+    }
+    return h;
+}
+
+/* The same for the unshifted decimators, tap 0 on the oldest sample. */
+template <size_t N>
+std::vector<double> oldest_first_taps(const std::array<int16_t, N>& taps) {
+    return {taps.crbegin(), taps.crend()};
+}
+
+/* Non-recursive CIC decimating by two, taps 1, 3, 3, 1. */
+inline std::vector<complex_t> cic3_decimate_by_2(const std::vector<complex_t>& x) {
+    return fir_decimate(x, std::vector<double>{1.0, 3.0, 3.0, 1.0}, 2);
+}
+
+inline std::vector<double> real_fir_decimate(const std::vector<double>& x, const std::vector<double>& h, const size_t decimation) {
+    std::vector<double> y(x.size() / decimation);
+    for (size_t m = 0; m < y.size(); m++) {
+        const size_t newest = decimation * m + decimation - 1;
+        double sum = 0.0;
+        for (size_t k = 0; (k < h.size()) && (k <= newest); k++) {
+            sum += x[newest - k] * h[k];
+        }
+        y[m] = sum;
+    }
+    return y;
+}
+
+inline std::vector<double> am_demodulate(const std::vector<complex_t>& x) {
+    std::vector<double> y(x.size());
+    for (size_t n = 0; n < x.size(); n++) {
+        y[n] = std::abs(x[n]);
+    }
+    return y;
+}
+
+/* Phase step from the previous sample, which is zero before the start. */
+inline std::vector<double> fm_demodulate(const std::vector<complex_t>& x) {
+    std::vector<double> y(x.size());
+    complex_t previous{};
+    for (size_t n = 0; n < x.size(); n++) {
+        const auto t = x[n] * std::conj(previous);
+        y[n] = (t == complex_t{}) ? 0.0 : std::arg(t);
+        previous = x[n];
+    }
+    return y;
+}
+
+/* Greatest distance between matching kernel and reference outputs, from
+ * index first on, in units of the kernel's LSB after dividing the reference
+ * by scale. */
+template <typename T>
+double max_error(const std::vector<std::complex<T>>& actual, const std::vector<complex_t>& expected, const double scale, const size_t first = 0) {
+    double worst = 0.0;
+    for (size_t n = first; (n < actual.size()) && (n < expected.size()); n++) {
+        const auto e = expected[n] / scale;
+        worst = std::max(worst, std::abs(actual[n].real() - e.real()));
+        worst = std::max(worst, std::abs(actual[n].imag() - e.imag()));
+    }
+    return worst;
+}
+
+template <typename T>
+double max_error(const std::vector<T>& actual, const std::vector<double>& expected, const double scale, const size_t first = 0) {
+    double worst = 0.0;
+    for (size_t n = first; (n < actual.size()) && (n < expected.size()); n++) {
+        worst = std::max(worst, std::abs(actual[n] - expected[n] / scale));
+    }
+    return worst;
+}
+
+/* Host time per input sample of run(), which processes samples of them. */
+template <typename F>
+double ns_per_sample(const size_t samples, const size_t iterations, F run) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; i++) {
+        run();
+    }
+    const auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / (static_cast<double>(samples) * iterations);
+}
+
+} /* namespace reference */
+} /* namespace dsp */
+
+#endif /*__DSP_REFERENCE_H__*/
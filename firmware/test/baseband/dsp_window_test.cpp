@@ -0,0 +1,84 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "dsp_window.hpp"
+#include "doctest.h"
+
+namespace {
+
+template <size_t N>
+double window_sum(const window_half_t<N>& w) {
+    double sum = 0.0;
+    for (size_t i = 0; i < N; i++) sum += w[(i <= N / 2) ? i : (N - i)];
+    return sum / 32767.0;
+}
+
+/* Highest sidelobe, in dB relative to the main lobe, of the window's
+ * spectrum outside +/- mainlobe_bins. */
+template <size_t N>
+double peak_sidelobe_db(const window_half_t<N>& w, const size_t mainlobe_bins) {
+    std::array<std::complex<float>, N> data{};
+    constexpr size_t K = log_2(N);
+    for (size_t i = 0; i < N; i++) {
+        size_t r = 0;
+        for (size_t b = 0; b < K; b++) {
+            if (i & (1 << b)) r |= 1 << (K - 1 - b);
+        }
+        data[r] = {static_cast<float>(w[(i <= N / 2) ? i : (N - i)]), 0.0f};
+    }
+    fft_c_preswapped_radix4(data);
+
+    const double peak = std::abs(data[0]);
+    double sidelobe = 0.0;
+    for (size_t k = mainlobe_bins + 1; k < N - mainlobe_bins; k++) {
+        sidelobe = std::max(sidelobe, static_cast<double>(std::abs(data[k])));
+    }
+    return 20.0 * std::log10(sidelobe / peak);
+}
+
+}  // namespace
+
+TEST_CASE("cosine sum windows have the expected shape") {
+    constexpr auto hann = window_make_cosine_sum<256>(window_hann);
+    CHECK(hann[0] == 0);
+    CHECK(std::abs(hann[64] - 16384) <= 1);
+    CHECK(hann[128] == 32767);
+
+    constexpr auto hamming = window_make_cosine_sum<256>(window_hamming);
+    CHECK(hamming[0] == doctest::Approx(0.08 * 32767).epsilon(0.001));
+
+    constexpr auto flat_top = window_make_cosine_sum<256>(window_flat_top);
+    CHECK(flat_top[0] <= 0);
+    CHECK(flat_top[128] == doctest::Approx(32767).epsilon(0.001));
+}
+
+TEST_CASE("window coherent gain equals the a0 coefficient") {
+    CHECK(window_sum<256>(window_make_cosine_sum<256>(window_hann)) / 256 == doctest::Approx(window_hann.a0).epsilon(0.001));
+    CHECK(window_sum<1024>(window_make_cosine_sum<1024>(window_blackman_harris)) / 1024 == doctest::Approx(window_blackman_harris.a0).epsilon(0.001));
+    CHECK(window_sum<256>(window_make_cosine_sum<256>(window_flat_top)) / 256 == doctest::Approx(window_flat_top.a0).epsilon(0.001));
+}
+
+TEST_CASE("window sidelobes match the textbook figures") {
+    CHECK(peak_sidelobe_db<256>(window_make_cosine_sum<256>(window_hann), 1) < -31.0);
+    CHECK(peak_sidelobe_db<256>(window_make_cosine_sum<256>(window_hamming), 1) < -41.0);
+    CHECK(peak_sidelobe_db<256>(window_make_cosine_sum<256>(window_blackman_harris), 3) < -88.0);
+    CHECK(peak_sidelobe_db<256>(window_make_cosine_sum<256>(window_flat_top), 4) < -85.0);
+}
@@ -0,0 +1,271 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+#include "doctest.h"
+#include "iq_codec.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace iq_codec;
+
+namespace {
+
+struct LCG {
+    uint32_t state{4711};
+    uint32_t next() {
+        state = state * 1664525 + 1013904223;
+        return state;
+    }
+    float noise() {
+        // Roughly gaussian, unit variance
+        float sum = 0;
+        for (size_t n = 0; n < 12; n++) sum += (next() >> 8) * (1.0f / 16777216.0f);
+        return sum - 6.0f;
+    }
+};
+
+int16_t clamp16(const float v) {
+    const float r = std::round(v);
+    return static_cast<int16_t>((r > 32767.0f) ? 32767.0f : ((r < -32768.0f) ? -32768.0f : r));
+}
+
+/* Stands in for decimated capture output: a few carriers over noise,
+ * band limited by a short moving average. */
+std::vector<complex16_t> synthetic_capture(const size_t count, const float noise_level) {
+    LCG rng{};
+    std::vector<complex16_t> samples(count);
+    float hist_i[4]{}, hist_q[4]{};
+    for (size_t n = 0; n < count; n++) {
+        hist_i[n & 3] = rng.noise() * noise_level;
+        hist_q[n & 3] = rng.noise() * noise_level;
+        float i = (hist_i[0] + hist_i[1] + hist_i[2] + hist_i[3]) * 0.5f;
+        float q = (hist_q[0] + hist_q[1] + hist_q[2] + hist_q[3]) * 0.5f;
+        for (const float f : {0.013f, -0.051f, 0.12f}) {
+            i += 900.0f * std::cos(6.2831853f * f * n);
+            q += 900.0f * std::sin(6.2831853f * f * n);
+        }
+        samples[n] = {clamp16(i), clamp16(q)};
+    }
+    return samples;
+}
+
+struct Stream {
+    std::vector<uint8_t> bytes{};
+    double encode_seconds{0};
+    double decode_seconds{0};
+};
+
+Stream encode_stream(const std::vector<complex16_t>& samples, const size_t block) {
+    Stream stream{};
+    std::vector<uint8_t> scratch(max_encoded_size(block));
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t offset = 0; offset < samples.size(); offset += block) {
+        const size_t count = std::min(block, samples.size() - offset);
+        const size_t size = encode_block(&samples[offset], count, scratch.data());
+        REQUIRE(size <= max_encoded_size(count));
+        stream.bytes.insert(stream.bytes.end(), scratch.begin(), scratch.begin() + size);
+    }
+    stream.encode_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return stream;
+}
+
+std::vector<complex16_t> decode_stream(Stream& stream) {
+    std::vector<complex16_t> samples;
+    std::vector<complex16_t> block(block_samples_max);
+    const auto start = std::chrono::steady_clock::now();
+    size_t offset = 0;
+    while (offset + sizeof(BlockHeader) <= stream.bytes.size()) {
+        BlockHeader header;
+        memcpy(&header, &stream.bytes[offset], sizeof(header));
+        offset += sizeof(header);
+        REQUIRE(check_block_header(header));
+        REQUIRE(offset + header.payload_size <= stream.bytes.size());
+        REQUIRE(decode_block(header, &stream.bytes[offset], block.data()));
+        offset += header.payload_size;
+        samples.insert(samples.end(), block.begin(), block.begin() + header.sample_count);
+    }
+    stream.decode_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    CHECK(offset == stream.bytes.size());
+    return samples;
+}
+
+bool same(const std::vector<complex16_t>& a, const std::vector<complex16_t>& b) {
+    return (a.size() == b.size()) && (memcmp(a.data(), b.data(), a.size() * sizeof(complex16_t)) == 0);
+}
+
+}  // namespace
+
+TEST_SUITE_BEGIN("IQ codec");
+
+TEST_CASE("File header round trips and rejects other files.") {
+    auto header = make_file_header();
+    CHECK(check_file_header(header));
+    CHECK(header.sample_count == 0);
+    header.magic[3] = '8';
+    CHECK_FALSE(check_file_header(header));
+}
+
+TEST_CASE("Band limited signal round trips and shrinks.") {
+    const auto samples = synthetic_capture(256 * 64, 200.0f);
+    auto stream = encode_stream(samples, 256);
+    CHECK(same(decode_stream(stream), samples));
+    CHECK(stream.bytes.size() < samples.size() * sizeof(complex16_t) * 3 / 4);
+}
+
+TEST_CASE("Incompressible blocks are stored raw and still round trip.") {
+    LCG rng{};
+    std::vector<complex16_t> samples(512 * 8);
+    for (auto& s : samples) {
+        const uint32_t r = rng.next();
+        s = {static_cast<int16_t>(r), static_cast<int16_t>(r >> 16)};
+    }
+    // Full scale alternation needs the escape code for every difference
+    for (size_t n = 0; n < 512; n++) {
+        samples[n] = (n & 1) ? complex16_t{32767, -32768} : complex16_t{-32768, 32767};
+    }
+
+    auto stream = encode_stream(samples, 512);
+    CHECK(same(decode_stream(stream), samples));
+    CHECK(stream.bytes.size() == samples.size() * sizeof(complex16_t) + 8 * sizeof(BlockHeader));
+}
+
+TEST_CASE("Odd block sizes and constant input round trip.") {
+    for (const size_t count : {0, 1, 2, 3, 17, 255, 512}) {
+        std::vector<complex16_t> samples(count, complex16_t{-1234, 42});
+        if (count > 2) samples[count / 2] = {1000, -1000};
+        auto stream = encode_stream(samples, 512);
+        CHECK(same(decode_stream(stream), samples));
+    }
+}
+
+TEST_CASE("Corrupt blocks are detected.") {
+    const auto samples = synthetic_capture(256, 50.0f);
+    std::vector<uint8_t> encoded(max_encoded_size(256));
+    const size_t size = encode_block(samples.data(), samples.size(), encoded.data());
+
+    BlockHeader header;
+    memcpy(&header, encoded.data(), sizeof(header));
+    REQUIRE(header.k_i != k_raw);
+    std::vector<complex16_t> decoded(256);
+    CHECK(decode_block(header, &encoded[sizeof(header)], decoded.data()));
+
+    BlockHeader bad = header;
+    bad.sync ^= 1;
+    CHECK_FALSE(check_block_header(bad));
+
+    bad = header;
+    bad.sample_count = block_samples_max + 1;
+    CHECK_FALSE(check_block_header(bad));
+
+    // Payload cut short runs out of bits
+    bad = header;
+    bad.payload_size = 8;
+    CHECK_FALSE(decode_block(bad, &encoded[sizeof(header)], decoded.data()));
+    CHECK(size > 8 + sizeof(header));
+}
+
+TEST_CASE("Parser skips blocks cut short in the middle of a stream.") {
+    /* As left by dropped stream writes: block 3 loses its tail, block 7
+     * keeps only part of its header and the last block is cut off by the
+     * end of the capture. Everything else must come back. */
+    constexpr size_t block = 256;
+    constexpr size_t blocks = 12;
+    const auto samples = synthetic_capture(block * blocks, 200.0f);
+    std::vector<uint8_t> encoded(max_encoded_size(block));
+    std::vector<uint8_t> bytes;
+    std::vector<complex16_t> expected;
+    for (size_t b = 0; b < blocks; b++) {
+        const size_t size = encode_block(&samples[b * block], block, encoded.data());
+        size_t kept = size;
+        if (b == 3) kept = size / 2;
+        if (b == 7) kept = 5;
+        if (b == blocks - 1) kept = size - 1;
+        bytes.insert(bytes.end(), encoded.begin(), encoded.begin() + kept);
+        if (kept == size) {
+            expected.insert(expected.end(), &samples[b * block], &samples[(b + 1) * block]);
+        }
+    }
+
+    BlockParser parser{};
+    std::vector<complex16_t> decoded;
+    std::vector<complex16_t> one(block_samples_max);
+    size_t offset = 0;
+    bool end = false;
+    while (!end) {
+        // Odd sized pushes, so blocks span them
+        const size_t length = std::min<size_t>(333, bytes.size() - offset);
+        for (size_t taken = 0; taken < length;) {
+            taken += parser.push(&bytes[offset + taken], length - taken);
+        }
+        offset += length;
+        end = (offset == bytes.size());
+
+        BlockHeader header;
+        while (const auto payload = parser.next(header, end)) {
+            if (!decode_block(header, payload, one.data())) {
+                parser.reject();
+                continue;
+            }
+            decoded.insert(decoded.end(), one.begin(), one.begin() + header.sample_count);
+        }
+    }
+    CHECK(decoded.size() == block * (blocks - 3));
+    CHECK(same(decoded, expected));
+}
+
+TEST_CASE("Throughput and ratio on recorded IQ.") {
+    /* Uses the C16 capture named by IQ_C16_FILE when set, otherwise
+     * synthetic ones at a few noise levels. */
+    std::vector<std::pair<std::string, std::vector<complex16_t>>> captures;
+    const char* const env_path = std::getenv("IQ_C16_FILE");
+    if (env_path) {
+        std::ifstream in{env_path, std::ios::binary};
+        REQUIRE(in.good());
+        std::vector<char> bytes{std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>()};
+        std::vector<complex16_t> samples(bytes.size() / sizeof(complex16_t));
+        memcpy(samples.data(), bytes.data(), samples.size() * sizeof(complex16_t));
+        captures.emplace_back(env_path, std::move(samples));
+    } else {
+        for (const float noise : {20.0f, 200.0f, 2000.0f}) {
+            captures.emplace_back("synthetic, noise " + std::to_string(static_cast<int>(noise)), synthetic_capture(1 << 20, noise));
+        }
+    }
+
+    for (auto& capture : captures) {
+        auto stream = encode_stream(capture.second, 256);
+        CHECK(same(decode_stream(stream), capture.second));
+        const double raw_bytes = capture.second.size() * sizeof(complex16_t);
+        const double ratio = raw_bytes / stream.bytes.size();
+        MESSAGE(capture.first << ": " << ratio << "x smaller, so " << ratio
+                              << "x the bandwidth for the same SD card rate; encode "
+                              << raw_bytes / stream.encode_seconds / 1e6 << " MB/s, decode "
+                              << raw_bytes / stream.decode_seconds / 1e6 << " MB/s");
+    }
+}
+
+TEST_SUITE_END();
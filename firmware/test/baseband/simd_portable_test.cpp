@@ -0,0 +1,88 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#include "doctest.h"
+#include "simd.hpp"
+
+#include <climits>
+
+/* Expected values worked through by hand from the ARMv7-M Architecture
+ * Reference Manual, corners included, for the host stand-ins of the M4 DSP
+ * instructions the kernels are checked with. */
+
+TEST_CASE("Saturating arithmetic clamps like the M4.") {
+    CHECK(__SSAT(40000, 16) == 32767);
+    CHECK(__SSAT(-40000, 16) == -32768);
+    CHECK(__SSAT(-129, 8) == -128);
+    CHECK(__USAT(-5, 8) == 0);
+    CHECK(__USAT(300, 8) == 255);
+    CHECK(__QADD(INT32_MAX, 1) == INT32_MAX);
+    CHECK(__QSUB(INT32_MIN, 1) == INT32_MIN);
+    CHECK(__QADD16(0x7fff0001, 0x00010001) == 0x7fff0002);
+    CHECK(__QSUB16(0x80000000, 0x00010001) == 0x8000ffff);
+    CHECK(__SHADD16(0x7fff7fff, 0x00010001) == 0x40004000);
+    CHECK(__SHSUB16(0x80000000, 0x00010001) == 0xbfffffff);
+}
+
+TEST_CASE("Dual 16 bit multiplies pair halves like the M4.") {
+    CHECK(__SMUAD(0x00030002, 0x00050004) == 23);
+    CHECK(__SMUADX(0x00030002, 0x00050004) == 22);
+    CHECK(__SMUSD(0x00030002, 0x00050004) == -7);
+    CHECK(__SMUSDX(0x00030002, 0x00050004) == -2);
+    CHECK(__SMLAD(0x00030002, 0x00050004, 100) == 123);
+    CHECK(__SMLSDX(0x00030002, 0x00050004, 100) == 98);
+
+    // Only the 64 bit accumulators hold two full scale products
+    CHECK(__SMLAD(0x80008000, 0x80008000, 0) == INT32_MIN);
+    CHECK(__SMLALD(0x80008000, 0x80008000, 0) == 0x80000000LL);
+    CHECK(__SMLSLD(0x00030002, 0x00050004, -100LL) == -107);
+    CHECK(__SMLALDX(0xffff0001, 0x00020003, 1LL << 40) == (1LL << 40) - 1);
+    CHECK(__SMLALD(0x7fff7fff, 0x7fff7fff, INT64_MAX) == INT64_MIN + 0x7ffe0001LL);
+}
+
+TEST_CASE("Halfword and word multiplies select and round like the M4.") {
+    CHECK(__SMULBB(0x7fff0002, 0x8000fffd) == -6);
+    CHECK(__SMULBT(0x0000fffe, 0x00030000) == -6);
+    CHECK(__SMULTB(0x80000000, 0x00000002) == -65536);
+    CHECK(__SMULTT(0x80000000, 0x80000000) == 0x40000000);
+    CHECK(__SMLABB(0x00000003, 0x00000003, 0x7ffffffc) == INT32_MIN + 5);
+    CHECK(__SMLATB(0x00030000, 0x00000003, 1) == 10);
+    CHECK(__SMULL(INT32_MIN, INT32_MIN) == (1LL << 62));
+    CHECK(__SMMULR(0x40000000, 0x40000000) == 0x10000000);
+    CHECK(__SMMULR(0x7fffffff, 0x7fffffff) == 0x3fffffff);
+    CHECK(__SMMULR(-1, 0x40000000) == 0);
+    CHECK(__SMMULR(-3, 0x40000000) == -1);
+}
+
+TEST_CASE("Packing, extension and bit operations move bits like the M4.") {
+    CHECK(__SXTB16(0x80ff7f01, 0) == 0xffff0001);
+    CHECK(__SXTB16(0x80ff7f01, 8) == 0xff80007f);
+    CHECK(__SXTH(0x8000ffff, 0) == -1);
+    CHECK(__SXTH(0x8000ffff, 16) == -32768);
+    CHECK(__SXTAH(10, 0x0000fffe, 0) == 8);
+    CHECK(__PKHBT(0x00001234, 0x00005678, 16) == 0x56781234);
+    CHECK(__PKHTB(0x12340000, 0x80000000, 16) == 0x12348000);
+    CHECK(__BFI(0xffffffff, 0, 8, 8) == 0xffff00ff);
+    CHECK(__BFI(0x00000001, 0xffff, 16, 16) == 0xffff0001);
+    CHECK(__REV16(0x11223344) == 0x22114433);
+    CHECK(__RBIT(1) == 0x80000000);
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SIMULATOR_CH_H__
+#define __SIMULATOR_CH_H__
+
+/* Just enough of the ChibiOS kernel API for baseband processors to build
+ * on the host. Everything runs on the one simulator thread, so locks are
+ * no-ops and time is the simulated sample clock, see simulator.cpp. */
+
+#include <cstdint>
+#include <cstddef>
+
+typedef int32_t msg_t;
+typedef uint32_t tprio_t;
+typedef uint32_t systime_t;
+typedef uint32_t eventmask_t;
+
+struct Thread;
+
+#define CH_FREQUENCY 1000
+#define NORMALPRIO 64
+#define HIGHPRIO 127
+
+#define S2ST(sec) ((systime_t)((sec) * CH_FREQUENCY))
+#define MS2ST(msec) ((systime_t)((((msec) * CH_FREQUENCY) - 1L) / 1000L + 1L))
+#define US2ST(usec) ((systime_t)((((usec) * CH_FREQUENCY) - 1L) / 1000000L + 1L))
+
+#define EVENT_MASK(eid) ((eventmask_t)(1 << (eid)))
+
+#define chSysLock()
+#define chSysUnlock()
+#define chSysLockFromIsr()
+#define chSysUnlockFromIsr()
+
+systime_t chTimeNow();
+
+void chEvtSignal(Thread* thread, eventmask_t mask);
+void chEvtSignalI(Thread* thread, eventmask_t mask);
+
+#endif /*__SIMULATOR_CH_H__*/
@@ -0,0 +1,42 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SIMULATOR_HAL_H__
+#define __SIMULATOR_HAL_H__
+
+/* Host stand-ins for the HAL and CMSIS pieces baseband code touches. The
+ * DSP intrinsics come from simd.hpp, mapped to their portable versions. */
+
+#include "ch.h"
+
+#define __DMB() __sync_synchronize()
+#define __SIMD32(addr) (*(int32_t**)&(addr))
+
+typedef uint32_t halrtcnt_t;
+
+halrtcnt_t halGetCounterValue();
+halrtcnt_t halGetCounterFrequency();
+uint32_t halLPCGetSystemClock();
+
+#include "simd.hpp"
+
+#endif /*__SIMULATOR_HAL_H__*/
@@ -0,0 +1,161 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Definitions the baseband images get from ChibiOS, the HAL and the
+ * hardware facing parts of the firmware, replaced for the simulator. */
+
+#include "simulator.hpp"
+
+#include "baseband_thread.hpp"
+#include "rssi_thread.hpp"
+#include "event_m4.hpp"
+#include "portapack_shared_memory.hpp"
+#include "stream_input.hpp"
+
+#include <ch.h>
+#include <hal.h>
+
+#include <array>
+#include <chrono>
+
+static SharedMemory simulator_shared_memory{};
+SharedMemory& shared_memory = simulator_shared_memory;
+
+/* Simulated time follows the capture, as the radio's follows the samples
+ * arriving. Counters for profiling follow the host clock in nanoseconds. */
+
+systime_t chTimeNow() {
+    const uint32_t rate = simulator::sampling_rate();
+    return rate ? (simulator::sample_count() * CH_FREQUENCY / rate) : 0;
+}
+
+void chEvtSignal(Thread*, const eventmask_t mask) {
+    simulator::signal_events(mask);
+}
+
+void chEvtSignalI(Thread*, const eventmask_t mask) {
+    simulator::signal_events(mask);
+}
+
+halrtcnt_t halGetCounterValue() {
+    const auto now = std::chrono::steady_clock::now().time_since_epoch();
+    return static_cast<halrtcnt_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+}
+
+halrtcnt_t halGetCounterFrequency() {
+    return 1000000000;
+}
+
+uint32_t halLPCGetSystemClock() {
+    return halGetCounterFrequency();
+}
+
+uint32_t MessageQueue::timestamp() {
+    return halGetCounterValue();
+}
+
+uint32_t MessageQueue::timestamp_frequency() {
+    return halGetCounterFrequency();
+}
+
+void MessageQueue::signal() {
+}
+
+/* Capture time of day as the RTC counts it, from midnight. */
+Timestamp Timestamp::now() {
+    const uint32_t rate = simulator::sampling_rate();
+    const uint32_t seconds = rate ? (simulator::sample_count() / rate) : 0;
+    Timestamp timestamp;
+    timestamp.tv_time = (seconds % 60) | (((seconds / 60) % 60) << 8) | (((seconds / 3600) % 24) << 16);
+    return timestamp;
+}
+
+namespace audio {
+namespace dma {
+
+audio::buffer_t tx_empty_buffer() {
+    return simulator::audio_buffer();
+}
+
+audio::buffer_t rx_empty_buffer() {
+    return {};
+}
+
+} /* namespace dma */
+} /* namespace audio */
+
+/* Nothing reads a recording stream on the host, its samples are dropped. */
+size_t StreamInput::write(const void* const, const size_t length) {
+    config->baseband_bytes_received += length;
+    config->baseband_bytes_dropped += length;
+    return 0;
+}
+
+Thread* BasebandThread::thread = nullptr;
+
+BasebandThread::BasebandThread(
+    uint32_t sampling_rate,
+    BasebandProcessor* const baseband_processor,
+    const tprio_t,
+    baseband::Direction direction)
+    : baseband_processor{baseband_processor},
+      _direction{direction},
+      sampling_rate{sampling_rate} {
+    simulator::set_sampling_rate(sampling_rate);
+}
+
+BasebandThread::~BasebandThread() {
+}
+
+void BasebandThread::set_sampling_rate(uint32_t new_sampling_rate) {
+    sampling_rate = new_sampling_rate;
+    simulator::set_sampling_rate(new_sampling_rate);
+}
+
+void BasebandThread::run() {
+}
+
+Thread* RSSIThread::thread = nullptr;
+
+RSSIThread::RSSIThread(const tprio_t) {
+}
+
+RSSIThread::~RSSIThread() {
+}
+
+void RSSIThread::run() {
+}
+
+Thread* EventDispatcher::thread_event_loop = nullptr;
+
+EventDispatcher::EventDispatcher(
+    std::unique_ptr<BasebandProcessor> baseband_processor)
+    : baseband_processor{std::move(baseband_processor)} {
+}
+
+void EventDispatcher::run() {
+    simulator::run(*baseband_processor);
+}
+
+void EventDispatcher::request_stop() {
+    is_running = false;
+}
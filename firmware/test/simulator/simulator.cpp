@@ -0,0 +1,430 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+/* Replays a capture through a baseband processor on the host.
+ *
+ *   baseband_sim <processor> <capture> [options]
+ *
+ * The capture is C8, or C16 reduced to C8 the way capture does it, by
+ * its extension unless --format says otherwise. It is fed to the processor
+ * 2048 samples at a time, as the baseband DMA would, after the processor
+ * has been sent the configuration its application sends when it opens.
+ * Whatever the processor sends the application is written out, a line per
+ * message, and a throughput summary goes to stderr at the end.
+ */
+
+#include "simulator.hpp"
+
+#include "event_m4.hpp"
+#include "baseband_profiler.hpp"
+#include "portapack_shared_memory.hpp"
+#include "capture_format.hpp"
+#include "message.hpp"
+
+#include <array>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+int simulator_main_adsb();
+int simulator_main_ais();
+int simulator_main_pocsag();
+
+namespace {
+
+constexpr size_t block_size = 2048;
+constexpr size_t audio_block_size = 32;
+
+struct Image {
+    const char* name;
+    int (*main)();
+    void (*configure)(BasebandProcessor& processor);
+};
+
+const Image images[]{
+    {"adsb", simulator_main_adsb, [](BasebandProcessor& processor) {
+         const ADSBConfigureMessage message{0};
+         processor.on_message(&message);
+     }},
+    {"ais", simulator_main_ais, [](BasebandProcessor&) {}},
+    {"pocsag", simulator_main_pocsag, [](BasebandProcessor& processor) {
+         const POCSAGConfigureMessage message{};
+         processor.on_message(&message);
+     }},
+};
+
+struct Options {
+    const Image* image{nullptr};
+    std::string capture_path{};
+    CaptureFormat format{CaptureFormat::C8};
+    uint32_t rate{0};
+    double seconds{0.0};
+    bool profile{false};
+    std::string messages_path{};
+    std::string audio_path{};
+    std::string spectrum_path{};
+};
+
+Options options{};
+
+uint32_t processor_rate{0};
+uint64_t samples_fed{0};
+uint32_t pending_events{0};
+
+FILE* messages_file{stdout};
+FILE* audio_file{nullptr};
+FILE* spectrum_file{nullptr};
+
+std::array<audio::sample_t, audio_block_size> audio_block{};
+bool audio_block_filled{false};
+
+ChannelSpectrumFIFO* spectrum_fifo{nullptr};
+
+std::array<uint32_t, toUType(Message::ID::MAX)> message_counts{};
+double execute_seconds{0.0};
+
+void usage() {
+    fprintf(stderr,
+            "usage: baseband_sim <processor> <capture> [options]\n"
+            "  processor        ");
+    for (const auto& image : images) {
+        fprintf(stderr, "%s ", image.name);
+    }
+    fprintf(stderr,
+            "\n"
+            "  --format c8|c16  sample format, by default from the extension\n"
+            "  --rate <sps>     replay at this rate rather than as fast as possible\n"
+            "  --seconds <s>    stop after this much of the capture\n"
+            "  --messages <f>   write messages to f rather than stdout\n"
+            "  --audio <f>      write audio output to f, 16 bit stereo\n"
+            "  --spectrum <f>   write channel spectra to f, 256 bytes each\n"
+            "  --profile        report execute() time per stage every second\n");
+}
+
+bool ends_with(const std::string& s, const char* const suffix) {
+    const size_t n = strlen(suffix);
+    return (s.size() >= n) && (strcasecmp(s.c_str() + s.size() - n, suffix) == 0);
+}
+
+bool parse_options(const int argc, char** const argv) {
+    if (argc < 3) return false;
+
+    for (const auto& image : images) {
+        if (strcmp(argv[1], image.name) == 0) options.image = &image;
+    }
+    if (!options.image) return false;
+
+    options.capture_path = argv[2];
+    if (ends_with(options.capture_path, ".C16")) options.format = CaptureFormat::C16;
+
+    for (int i = 3; i < argc; i++) {
+        const std::string option{argv[i]};
+        if (option == "--profile") {
+            options.profile = true;
+            continue;
+        }
+        if (i + 1 >= argc) return false;
+        const char* const value = argv[++i];
+        if (option == "--format") {
+            if (strcasecmp(value, "c8") == 0)
+                options.format = CaptureFormat::C8;
+            else if (strcasecmp(value, "c16") == 0)
+                options.format = CaptureFormat::C16;
+            else
+                return false;
+        } else if (option == "--rate") {
+            options.rate = strtoul(value, nullptr, 10);
+        } else if (option == "--seconds") {
+            options.seconds = strtod(value, nullptr);
+        } else if (option == "--messages") {
+            options.messages_path = value;
+        } else if (option == "--audio") {
+            options.audio_path = value;
+        } else if (option == "--spectrum") {
+            options.spectrum_path = value;
+        } else {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* sample_rate from the metadata file recorded next to a capture, if any. */
+uint32_t capture_rate(const std::string& capture_path) {
+    const auto dot = capture_path.find_last_of('.');
+    std::ifstream metadata{capture_path.substr(0, dot) + ".TXT"};
+    std::string line;
+    while (std::getline(metadata, line)) {
+        if (line.rfind("sample_rate=", 0) == 0) {
+            return strtoul(line.c_str() + 12, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+/* Reads up to block_size samples as C8, returning how many. */
+size_t read_block(FILE* const capture, complex8_t* const block) {
+    if (options.format == CaptureFormat::C16) {
+        std::array<complex16_t, block_size> wide;
+        const size_t count = fread(wide.data(), sizeof(complex16_t), wide.size(), capture);
+        capture_format::pack_c8(wide.data(), count, reinterpret_cast<uint8_t*>(block));
+        return count;
+    }
+    return fread(block, sizeof(complex8_t), block_size, capture);
+}
+
+void print_bits(const baseband::Packet& packet) {
+    for (size_t n = 0; n < packet.size(); n += 4) {
+        uint32_t nibble = 0;
+        for (size_t b = 0; b < 4; b++) {
+            nibble = (nibble << 1) | packet[n + b];
+        }
+        fprintf(messages_file, "%" PRIx32, nibble);
+    }
+}
+
+void print_message(const Message* const message) {
+    const double t = static_cast<double>(samples_fed) / processor_rate;
+    fprintf(messages_file, "%.6f %u ", t, static_cast<unsigned>(toUType(message->id)));
+
+    switch (message->id) {
+        case Message::ID::ADSBFrame: {
+            const auto m = reinterpret_cast<const ADSBFrameMessage*>(message);
+            auto frame = m->frame;
+            fprintf(messages_file, "ADSBFrame ");
+            for (size_t n = 0; n < frame.length_bits() / 8; n++) {
+                fprintf(messages_file, "%02X", frame.get_raw_data()[n]);
+            }
+            fprintf(messages_file, " amp=%" PRIu32, m->amp);
+            break;
+        }
+
+        case Message::ID::AISPacket: {
+            const auto m = reinterpret_cast<const AISPacketMessage*>(message);
+            fprintf(messages_file, "AISPacket %c %u ", (m->channel == ais::Channel::A) ? 'A' : 'B', static_cast<unsigned>(m->packet.size()));
+            print_bits(m->packet);
+            break;
+        }
+
+        case Message::ID::POCSAGPacket: {
+            const auto m = reinterpret_cast<const POCSAGPacketMessage*>(message);
+            fprintf(messages_file, "POCSAGPacket %u %d", m->packet.bitrate(), static_cast<int>(m->packet.flag()));
+            for (size_t n = 0; n < 16; n++) {
+                fprintf(messages_file, " %08" PRIX32, m->packet[n]);
+            }
+            break;
+        }
+
+        case Message::ID::ChannelStatistics: {
+            const auto m = reinterpret_cast<const ChannelStatisticsMessage*>(message);
+            fprintf(messages_file, "ChannelStatistics max_db=%" PRId32 " count=%zu", m->statistics.max_db, m->statistics.count);
+            break;
+        }
+
+        case Message::ID::AudioStatistics: {
+            const auto m = reinterpret_cast<const AudioStatisticsMessage*>(message);
+            fprintf(messages_file, "AudioStatistics rms_db=%" PRId32 " max_db=%" PRId32, m->statistics.rms_db, m->statistics.max_db);
+            break;
+        }
+
+        case Message::ID::ChannelSpectrumConfig: {
+            spectrum_fifo = reinterpret_cast<const ChannelSpectrumConfigMessage*>(message)->fifo;
+            fprintf(messages_file, "ChannelSpectrumConfig");
+            break;
+        }
+
+        case Message::ID::BasebandProfile: {
+            const auto& p = reinterpret_cast<const BasebandProfileMessage*>(message)->profile;
+            fprintf(messages_file, "BasebandProfile budget=%" PRIu32 "ns executes=%" PRIu32 " missed=%" PRIu32 " min=%" PRIu32 " avg=%" PRIu32 " p99=%" PRIu32 " max=%" PRIu32,
+                    p.budget_cycles, p.executes, p.deadline_misses, p.min_cycles, p.avg_cycles, p.p99_cycles, p.max_cycles);
+            fprintf(messages_file, " other=%" PRIu32 " decimate=%" PRIu32 " demodulate=%" PRIu32 " audio=%" PRIu32 " spectrum=%" PRIu32,
+                    p.stage_cycles[BasebandProfile::Other], p.stage_cycles[BasebandProfile::Decimate],
+                    p.stage_cycles[BasebandProfile::Demodulate], p.stage_cycles[BasebandProfile::Audio],
+                    p.stage_cycles[BasebandProfile::Spectrum]);
+            break;
+        }
+
+        default:
+            break;
+    }
+    fprintf(messages_file, "\n");
+}
+
+void drain_application_queue() {
+    shared_memory.application_queue.handle([](Message* const message) {
+        const size_t id = toUType(message->id);
+        if (id < message_counts.size()) message_counts[id]++;
+        print_message(message);
+    });
+}
+
+void drain_spectrum_fifo() {
+    if (!spectrum_fifo) return;
+    ChannelSpectrum spectrum;
+    while (spectrum_fifo->out(spectrum)) {
+        if (spectrum_file) fwrite(spectrum.db.data(), 1, spectrum.db.size(), spectrum_file);
+    }
+}
+
+void flush_audio_block() {
+    if (audio_block_filled && audio_file) {
+        fwrite(audio_block.data(), sizeof(audio::sample_t), audio_block.size(), audio_file);
+    }
+    audio_block_filled = false;
+}
+
+void print_summary(const double wall_seconds) {
+    const double capture_seconds = processor_rate ? (static_cast<double>(samples_fed) / processor_rate) : 0.0;
+    fprintf(stderr, "%s: %" PRIu64 " samples, %.3f s of capture at %" PRIu32 " sps\n",
+            options.image->name, samples_fed, capture_seconds, processor_rate);
+    if (execute_seconds > 0.0) {
+        fprintf(stderr, "execute: %.3f s, %.3f Msps, %.1fx real time\n",
+                execute_seconds, samples_fed / execute_seconds / 1e6, capture_seconds / execute_seconds);
+    }
+    fprintf(stderr, "wall: %.3f s\n", wall_seconds);
+
+    for (size_t id = 0; id < message_counts.size(); id++) {
+        if (message_counts[id]) fprintf(stderr, "message %zu: %" PRIu32 "\n", id, message_counts[id]);
+    }
+    const auto stats = shared_memory.application_queue.statistics();
+    if (stats.drops) fprintf(stderr, "application queue drops: %" PRIu32 "\n", stats.drops);
+}
+
+}  // namespace
+
+namespace simulator {
+
+void set_sampling_rate(const uint32_t sampling_rate) {
+    processor_rate = sampling_rate;
+}
+
+uint64_t sample_count() {
+    return samples_fed;
+}
+
+uint32_t sampling_rate() {
+    return processor_rate;
+}
+
+void signal_events(const uint32_t events) {
+    pending_events |= events;
+}
+
+audio::buffer_t audio_buffer() {
+    flush_audio_block();
+    audio_block_filled = true;
+    return {audio_block.data(), audio_block.size(), processor_rate};
+}
+
+void run(BasebandProcessor& processor) {
+    FILE* const capture = fopen(options.capture_path.c_str(), "rb");
+    if (!capture) {
+        fprintf(stderr, "cannot open %s\n", options.capture_path.c_str());
+        return;
+    }
+
+    const uint32_t recorded_rate = capture_rate(options.capture_path);
+    if (recorded_rate && (recorded_rate != processor_rate)) {
+        fprintf(stderr, "warning: capture recorded at %" PRIu32 " sps, %s runs at %" PRIu32 " sps\n",
+                recorded_rate, options.image->name, processor_rate);
+    }
+
+    if (options.profile) {
+        shared_memory.request_m4_performance_counter = SharedMemory::m4_performance_counter_profile;
+    }
+
+    options.image->configure(processor);
+    drain_application_queue();
+
+    const uint64_t sample_limit = (options.seconds > 0.0) ? static_cast<uint64_t>(options.seconds * processor_rate) : UINT64_MAX;
+    std::vector<complex8_t> block(block_size);
+    BasebandProfiler profiler{};
+
+    const auto start = std::chrono::steady_clock::now();
+    while (samples_fed < sample_limit) {
+        const size_t count = read_block(capture, block.data());
+        if (count < block_size) break;
+
+        if (options.rate) {
+            std::this_thread::sleep_until(start + std::chrono::nanoseconds(samples_fed * 1000000000 / options.rate));
+        }
+
+        const buffer_c8_t buffer{block.data(), count, processor_rate};
+        const auto execute_start = std::chrono::steady_clock::now();
+        profiler.begin();
+        processor.execute(buffer);
+        profiler.end(buffer);
+        execute_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - execute_start).count();
+        samples_fed += count;
+
+        if (pending_events & EVT_MASK_SPECTRUM) {
+            const UpdateSpectrumMessage message{};
+            processor.on_message(&message);
+        }
+        pending_events = 0;
+
+        drain_application_queue();
+        drain_spectrum_fifo();
+    }
+    flush_audio_block();
+
+    fclose(capture);
+}
+
+} /* namespace simulator */
+
+int main(int argc, char** argv) {
+    if (!parse_options(argc, argv)) {
+        usage();
+        return 1;
+    }
+
+    if (!options.messages_path.empty()) {
+        messages_file = fopen(options.messages_path.c_str(), "w");
+    }
+    if (!options.audio_path.empty()) {
+        audio_file = fopen(options.audio_path.c_str(), "wb");
+    }
+    if (!options.spectrum_path.empty()) {
+        spectrum_file = fopen(options.spectrum_path.c_str(), "wb");
+    }
+    if (!messages_file || (!options.audio_path.empty() && !audio_file) || (!options.spectrum_path.empty() && !spectrum_file)) {
+        fprintf(stderr, "cannot open an output file\n");
+        return 2;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    options.image->main();
+    print_summary(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+    if (messages_file != stdout) fclose(messages_file);
+    if (audio_file) fclose(audio_file);
+    if (spectrum_file) fclose(spectrum_file);
+
+    return samples_fed ? 0 : 2;
+}
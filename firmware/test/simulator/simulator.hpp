@@ -0,0 +1,53 @@
+/*
+ * Copyright (C) 2024
+ *
+ * This file is part of PortaPack.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2, or (at your option)
+ * any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; see the file COPYING.  If not, write to
+ * the Free Software Foundation, Inc., 51 Franklin Street,
+ * Boston, MA 02110-1301, USA.
+ */
+
+
+#ifndef __SIMULATOR_H__
+#define __SIMULATOR_H__
+
+#include <cstdint>
+
+#include "baseband_processor.hpp"
+#include "audio_dma.hpp"
+
+/* Links a baseband image's processor, built for the host against the
+ * stand-ins in host_runtime.cpp, to the capture replay in simulator.cpp.
+ *
+ * The processor's main() starts as on the radio. Its BasebandThread
+ * reports the rate asked for, and EventDispatcher::run() hands the
+ * processor over to run(), which feeds it the capture.
+ */
+namespace simulator {
+
+void set_sampling_rate(const uint32_t sampling_rate);
+void run(BasebandProcessor& processor);
+
+/* Samples of the capture fed to the processor so far, and their rate. */
+uint64_t sample_count();
+uint32_t sampling_rate();
+
+void signal_events(const uint32_t events);
+
+audio::buffer_t audio_buffer();
+
+} /* namespace simulator */
+
+#endif /*__SIMULATOR_H__*/